@@ -0,0 +1,159 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+
+#ifndef __INTERNER_H_JAG_1402__
+#define __INTERNER_H_JAG_1402__
+
+#include <core/generic/noncopyable.h>
+#include <core/generic/assert.h>
+#include <boost/functional/hash.hpp>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace jag
+{
+
+/**
+ * @brief Assigns consecutive indices to distinct values.
+ *
+ * Equal values are given the same index. The values are stored in the order
+ * of insertion and looked up through an open addressing hash table with linear
+ * probing. The table keeps the hash of each value, so values are compared only
+ * if their hashes match.
+ *
+ * @param T value type
+ * @param Hash function object computing a hash of T, must be consistent with Equal
+ * @param Equal function object comparing two values
+ */
+template<class T, class Hash=boost::hash<T>, class Equal=std::equal_to<T> >
+class Interner
+    : public noncopyable
+{
+public:
+    explicit Interner(Hash const& hash=Hash(), Equal const& equal=Equal());
+
+    /// returns index of the value and whether it has been inserted
+    std::pair<size_t,bool> intern(T const& value);
+    /// value with the given index
+    T const& value(size_t index) const;
+    size_t size() const { return m_values.size(); }
+
+private:
+    void rehash(size_t num_slots);
+    size_t find_slot(size_t hash, T const& value) const;
+
+    struct Slot
+    {
+        size_t hash;
+        size_t index;   // index of the value plus one, 0 if the slot is empty
+    };
+
+    std::vector<T>       m_values;
+    std::vector<Slot>    m_slots;    // size is a power of two
+    Hash                 m_hash;
+    Equal                m_equal;
+};
+
+
+
+//
+//
+//
+template<class T, class Hash, class Equal>
+Interner<T,Hash,Equal>::Interner(Hash const& hash, Equal const& equal)
+    : m_hash(hash)
+    , m_equal(equal)
+{
+    rehash(16);
+}
+
+
+//
+//
+//
+template<class T, class Hash, class Equal>
+std::pair<size_t,bool> Interner<T,Hash,Equal>::intern(T const& value)
+{
+    const size_t hash = m_hash(value);
+    size_t slot = find_slot(hash, value);
+    if (m_slots[slot].index)
+        return std::make_pair(m_slots[slot].index - 1, false);
+
+    // keep the load factor below 1/2
+    if (2 * (m_values.size() + 1) > m_slots.size())
+    {
+        rehash(2 * m_slots.size());
+        slot = find_slot(hash, value);
+    }
+
+    m_values.push_back(value);
+    m_slots[slot].hash = hash;
+    m_slots[slot].index = m_values.size();
+    return std::make_pair(m_values.size() - 1, true);
+}
+
+
+//
+//
+//
+template<class T, class Hash, class Equal>
+T const& Interner<T,Hash,Equal>::value(size_t index) const
+{
+    JAG_PRECONDITION(index < m_values.size());
+    return m_values[index];
+}
+
+
+//
+// Returns the slot holding the value or the empty slot where it belongs.
+//
+template<class T, class Hash, class Equal>
+size_t Interner<T,Hash,Equal>::find_slot(size_t hash, T const& value) const
+{
+    const size_t mask = m_slots.size() - 1;
+    for(size_t slot = hash & mask;; slot = (slot + 1) & mask)
+    {
+        Slot const& s = m_slots[slot];
+        if (!s.index)
+            return slot;
+
+        if (s.hash == hash && m_equal(m_values[s.index - 1], value))
+            return slot;
+    }
+}
+
+
+//
+//
+//
+template<class T, class Hash, class Equal>
+void Interner<T,Hash,Equal>::rehash(size_t num_slots)
+{
+    JAG_PRECONDITION(num_slots && !(num_slots & (num_slots - 1)));
+    const Slot empty = { 0, 0 };
+    std::vector<Slot> slots(num_slots, empty);
+    const size_t mask = num_slots - 1;
+    for(size_t i=0; i<m_slots.size(); ++i)
+    {
+        if (!m_slots[i].index)
+            continue;
+
+        size_t slot = m_slots[i].hash & mask;
+        while (slots[slot].index)
+            slot = (slot + 1) & mask;
+
+        slots[slot] = m_slots[i];
+    }
+    m_slots.swap(slots);
+}
+
+
+} // namespace jag
+
+#endif //__INTERNER_H_JAG_1402__
+/** EOF @file */
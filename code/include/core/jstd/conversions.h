@@ -31,6 +31,59 @@ private:
 };
 
 
+
+/// Size of a buffer sufficient for format_int().
+const int FORMAT_INT_MAX_SIZE = 12;
+
+///
+/// Writes a signed integer in decimal notation. No terminating zero is
+/// appended.
+///
+/// @return number of characters written
+///
+int format_int(Char* buffer, Int value);
+
+///
+/// Writes a double rounded to 5 fractional digits with trailing zeroes
+/// removed. The output is the same as the one of snprintf_pdf_double(), but
+/// it does not use the C runtime formatting for common values. No
+/// terminating zero is appended; the buffer must be at least
+/// PDF_DOUBLE_MAX_SIZE long.
+///
+/// @return number of characters written
+///
+int format_pdf_double(Char* buffer, double value);
+
+///
+/// Writes each byte as two lowercase hexadecimal digits. The buffer must be
+/// at least 2*length long.
+///
+/// @return pointer past the last character written
+///
+Char* format_hex(Char* buffer, Byte const* data, size_t length);
+
+///
+/// Writes each value as four lowercase hexadecimal digits, most significant
+/// first. The buffer must be at least 4*length long.
+///
+/// @return pointer past the last character written
+///
+Char* format_hex(Char* buffer, UInt16 const* data, size_t length);
+
+///
+/// Returns the number of leading bytes which can be written to a literal
+/// string as they are, i.e. the position of the first byte which needs an
+/// escape sequence (see literal_string_escape()) or length if there is none.
+///
+size_t literal_string_run(Byte const* data, size_t length);
+
+///
+/// Returns the character following the backslash in the escape sequence of
+/// the byte, or 0 if the byte is written to a literal string as it is.
+///
+Char literal_string_escape(Byte byte);
+
+
 }} //namespace jag::jstd
 
 
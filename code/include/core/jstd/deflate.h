@@ -0,0 +1,75 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+
+#ifndef __DEFLATE_H_JAG_2305__
+#define __DEFLATE_H_JAG_2305__
+
+#include <interfaces/streams.h>
+#include <memory>
+
+namespace jag {
+class IProfileInternal;
+
+namespace jstd {
+
+/// deflate strategies, see deflateInit2() in zlib
+enum DeflateStrategy
+{
+      DEFLATE_DEFAULT
+    , DEFLATE_FILTERED
+    , DEFLATE_HUFFMAN_ONLY
+    , DEFLATE_RLE
+};
+
+
+/// deflate encoder settings
+struct DeflateParams
+{
+    DeflateParams(int level_=-1, DeflateStrategy strategy_=DEFLATE_DEFAULT)
+        : level(level_)
+        , strategy(strategy_)
+    {}
+
+    int              level;     // 0-9, -1 means the backend default
+    DeflateStrategy  strategy;
+};
+
+
+//
+// Creates a filter which compresses the written data to a zlib (RFC 1950)
+// stream and writes it to 'stream'. tell() of the filter returns the number
+// of uncompressed bytes written so far.
+//
+typedef std::auto_ptr<ISeqStreamOutputControl>
+(*DeflateStreamFactory)(ISeqStreamOutput& stream, DeflateParams const& params);
+
+//
+// Replaces the deflate implementation used by create_deflate_stream() and
+// returns the previous one. Not thread-safe, it is meant to be called once
+// before any document is created.
+//
+DeflateStreamFactory set_deflate_stream_factory(DeflateStreamFactory factory);
+
+/// retrieves the implementation used by create_deflate_stream()
+DeflateStreamFactory deflate_stream_factory();
+
+/// creates a deflate filter using the current implementation
+std::auto_ptr<ISeqStreamOutputControl>
+create_deflate_stream(ISeqStreamOutput& stream, DeflateParams const& params);
+
+/// the default implementation, creates ZLibStreamOutput
+std::auto_ptr<ISeqStreamOutputControl>
+create_zlib_deflate_stream(ISeqStreamOutput& stream, DeflateParams const& params);
+
+/// reads compression settings of a stream class from the configuration
+DeflateParams deflate_params_from_config(IProfileInternal const& cfg,
+                                         char const* level_key,
+                                         char const* strategy_key);
+
+}} // namespace jag::jstd
+
+#endif // __DEFLATE_H_JAG_2305__
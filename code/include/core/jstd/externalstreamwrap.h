@@ -66,6 +66,67 @@ public:
     void flush() { /*no op*/ }
 };
 
+
+//
+// Pulls data from an external source. Reads are repeated until the requested
+// size is read or the source is exhausted, so only the last read is short.
+// The source is closed exactly once, on destruction.
+//
+class ExternalStreamIn
+    : public ISeqStreamInput
+{
+    jag_streamin const m_stream;
+    ULong              m_pos;
+    bool               m_eof;
+
+public:
+    explicit ExternalStreamIn(jag_streamin const& stream)
+        : m_stream(stream)
+        , m_pos(0)
+        , m_eof(false)
+    {}
+
+    ~ExternalStreamIn() {
+        if (m_stream.close)
+            m_stream.close(m_stream.custom_data);
+    }
+
+public:
+    bool read(void* data, ULong size, ULong* nr_read) {
+        ULong total = 0;
+        while (!m_eof && total < size)
+        {
+            jag_ULong chunk = 0;
+            Int err=m_stream.read(m_stream.custom_data,
+                                  static_cast<Byte*>(data) + total,
+                                  size - total,
+                                  &chunk);
+            if (err)
+            {
+                throw exception_io_error(msg_cannot_read_stream())
+                    << user_errno_info(err)
+                    << io_object_info("external stream")
+                    << JAGLOC;
+            }
+
+            if (!chunk)
+                m_eof = true;
+
+            total += (std::min)(static_cast<ULong>(chunk), size - total);
+        }
+
+        if (nr_read)
+            *nr_read = total;
+
+        m_pos += total;
+        return !m_eof;
+    }
+
+    ULong tell() const {
+        return m_pos;
+    }
+};
+
 //
 //
 //
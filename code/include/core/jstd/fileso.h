@@ -30,6 +30,7 @@ namespace jstd {
 bool file_exists(Char const*);
 bool is_directory(Char const*);
 boost::uintmax_t file_size(Char const*);
+boost::uintmax_t file_mtime(Char const*);
 
 inline bool is_file(Char const* path) {
     return file_exists(path) && !is_directory(path);
@@ -0,0 +1,94 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+
+#ifndef GLYPHTABLES_JG1812_H__
+#define GLYPHTABLES_JG1812_H__
+
+#include <interfaces/stdtypes.h>
+#include <iterator>
+#include <vector>
+#include <map>
+
+namespace jag {
+namespace jstd {
+
+//
+// Set of glyph indices kept as a bitset over the whole 16-bit range. The
+// iteration is in the ascending order.
+//
+class GlyphSet
+{
+public:
+    class const_iterator
+        : public std::iterator<std::forward_iterator_tag, UInt16,
+                               std::ptrdiff_t, UInt16 const*, UInt16>
+    {
+    public:
+        const_iterator() : m_set(0), m_glyph(0) {}
+        UInt16 operator*() const { return static_cast<UInt16>(m_glyph); }
+        const_iterator& operator++();
+        const_iterator operator++(int);
+        bool operator==(const_iterator const& other) const { return m_glyph == other.m_glyph; }
+        bool operator!=(const_iterator const& other) const { return m_glyph != other.m_glyph; }
+
+    private:
+        friend class GlyphSet;
+        const_iterator(GlyphSet const* set, UInt glyph) : m_set(set), m_glyph(glyph) {}
+        GlyphSet const* m_set;
+        UInt m_glyph;   // NUM_GLYPHS at the end
+    };
+    typedef const_iterator iterator;
+
+public:
+    GlyphSet() : m_size(0) {}
+    bool insert(UInt16 glyph);
+    void merge(GlyphSet const& other);
+    size_t count(UInt16 glyph) const;
+    size_t size() const { return m_size; }
+    bool empty() const { return !m_size; }
+    const_iterator begin() const;
+    const_iterator end() const;
+
+private:
+    UInt next(UInt glyph) const;
+    enum { NUM_GLYPHS = 0x10000, WORD_BITS = 32 };
+    std::vector<UInt> m_words;  // allocated by the first insert
+    size_t m_size;
+};
+
+
+//
+// Maps Unicode codepoints to glyph indices. Codepoints are looked up in pages
+// of 256 entries which are allocated on demand.
+//
+class CodepointTable
+{
+public:
+    /// finds the glyph of the codepoint, returns false if not present
+    bool find(Int codepoint, UInt16& glyph) const;
+    /// assigns the glyph unless the codepoint is already present
+    void insert(Int codepoint, UInt16 glyph);
+    void merge(CodepointTable const& other);
+    bool empty() const { return m_pages.empty() && m_invalid.empty(); }
+    /// the smallest present Unicode codepoint greater than the given one, -1
+    /// if none; invalid codepoints are not iterated
+    Int next(Int codepoint) const;
+
+private:
+    enum { PAGE_BITS = 8, PAGE_SIZE = 1 << PAGE_BITS, MAX_CODEPOINT = 0x10ffff };
+    // glyph index + 1, 0 if the codepoint is not present
+    typedef std::vector<UInt> Page;
+    std::vector<Page> m_pages;
+    // codepoints outside of the Unicode range, rare
+    std::map<Int,UInt16> m_invalid;
+};
+
+
+}} // namespace jag::jstd
+
+#endif // GLYPHTABLES_JG1812_H__
+/** EOF @file */
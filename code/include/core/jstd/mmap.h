@@ -16,5 +16,50 @@ const int JAG_MMAP_VIEW_DEFAULT_SIZE = 512*1024;
 # include "other/mmap_other.h"
 #endif
 
+#include <core/jstd/memory_stream.h>
+
+namespace jag {
+namespace jstd {
+
+//
+// Input stream reading a memory mapped file. The whole file is
+// accessible as a contiguous memory block via data().
+//
+class MMapFileStreamInput
+    : public IStreamInput
+{
+public:
+    explicit MMapFileStreamInput(char const* fname)
+        : m_view(fname)
+        , m_in(m_view.data(), m_view.size())
+    {}
+
+    Byte const* data() const { return m_view.data(); }
+    ULong size() const { return m_view.size(); }
+
+public: // ISeqStreamInput
+    bool read(void* data, ULong size, ULong* read) {
+        return m_in.read(data, size, read);
+    }
+
+    ULong tell() const {
+        return m_in.tell();
+    }
+
+    void close() {
+        m_in.close();
+    }
+
+    void seek(Int offset, StreamOffsetOrigin origin) {
+        m_in.seek(offset, origin);
+    }
+
+private:
+    MMapFileView       m_view;
+    MemoryStreamInput  m_in;
+};
+
+}} // namespace jag::jstd
+
 #endif // MMAP_JG1428_H__
 /** EOF @file */
@@ -43,6 +43,28 @@ private:
     int m_alloc_offset;      // offset of the current mapping
 };
 
+
+//
+// Read-only view of a whole file.
+//
+class MMapFileView
+{
+public:
+    explicit MMapFileView(char const* fname);
+    ~MMapFileView();
+
+    Byte const* data() const { return m_base_ptr; }
+    ULong size() const { return m_size; }
+
+private:
+    MMapFileView(MMapFileView const&);
+    MMapFileView& operator=(MMapFileView const&);
+
+private:
+    Byte*  m_base_ptr;          // null for an empty file
+    ULong  m_size;
+};
+
 }} // namespace jag::jstd
 
 #endif // MMAP_JG147_H__
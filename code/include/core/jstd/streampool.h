@@ -0,0 +1,121 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+
+#ifndef STREAMPOOL_JG2231_H__
+#define STREAMPOOL_JG2231_H__
+
+#include <interfaces/streams.h>
+#include <core/jstd/thread.h>
+#include <core/jstd/deflate.h>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <memory>
+#include <vector>
+
+namespace jag {
+namespace jstd {
+
+class ZLibStreamOutput;
+
+/// reuse counters of a StreamPool
+struct StreamPoolStats
+{
+    StreamPoolStats()
+        : segments_allocated(0)
+        , segments_reused(0)
+        , deflaters_created(0)
+        , deflaters_reused(0)
+    {}
+
+    int segments_allocated;
+    int segments_reused;
+    int deflaters_created;
+    int deflaters_reused;
+};
+
+
+//
+// Keeps memory segments and deflate filters released by streams so that
+// they can be reused by streams created later. Segments can be acquired and
+// released from any thread, the deflate filters are expected to be managed
+// by a single thread.
+//
+class StreamPool
+    : public boost::noncopyable
+{
+public:
+    enum {
+        MIN_SEGMENT_SIZE = 1024,
+        NUM_SEGMENT_CLASSES = 7,   // 1KB - 64KB
+        MAX_IDLE_SEGMENT_BYTES = 8 << 20,
+        MAX_IDLE_DEFLATERS = 4
+    };
+
+    StreamPool();
+    ~StreamPool();
+
+    static size_t segment_size(int size_class);
+    Byte* acquire_segment(int size_class);
+    void release_segment(Byte* segment, int size_class);
+
+    std::auto_ptr<ISeqStreamOutputControl>
+    create_deflate(ISeqStreamOutput& stream, DeflateParams const& params);
+    void recycle_deflate(std::auto_ptr<ISeqStreamOutputControl> deflater);
+
+    StreamPoolStats stats() const;
+
+private:
+    mutable Mutex                   m_mutex;
+    std::vector<Byte*>              m_segments[NUM_SEGMENT_CLASSES];
+    size_t                          m_idle_bytes;
+    // set only if create_deflate_stream() creates ZLibStreamOutput
+    bool                            m_reuse_deflaters;
+    std::vector<ZLibStreamOutput*>  m_deflaters;
+    StreamPoolStats                 m_stats;
+};
+
+
+//
+// Memory based stream storing the data in a list of segments acquired from
+// a StreamPool. The stream grows without copying the data already written.
+// Segments are returned to the pool on close().
+//
+class SegmentedStreamOutput
+    : public ISeqStreamOutputControl
+    , public boost::noncopyable
+{
+public:
+    explicit SegmentedStreamOutput(boost::shared_ptr<StreamPool> const& pool);
+    ~SegmentedStreamOutput();
+
+    int num_segments() const;
+    Byte const* segment(int index) const;
+    ULong segment_length(int index) const;
+
+public:  //ISeqStreamOutput
+    void write(void const* data, ULong size);
+    ULong tell() const;
+    void flush() {}
+
+public: //ISeqStreamOutputControl
+    void close();
+
+private:
+    void add_segment();
+
+private:
+    boost::shared_ptr<StreamPool>  m_pool;
+    std::vector<Byte*>             m_segments;
+    ULong                          m_bytes_written;
+    // free space in the last segment
+    size_t                         m_available;
+};
+
+}} // namespace jag::jstd
+
+#endif // STREAMPOOL_JG2231_H__
+/** EOF @file */
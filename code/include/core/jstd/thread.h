@@ -16,6 +16,12 @@
 #ifdef BOOST_HAS_WINTHREADS
 # include <windows.h>
 # include "win32/thread.h"
+// native condition variables are available since Windows Vista
+# if _WIN32_WINNT >= 0x0600
+#  define JAG_WIN32_CONDITION_VARIABLE
+# else
+#  include <deque>
+# endif
 #elif defined(BOOST_HAS_PTHREADS)
 # include <pthread.h>
 # include "other/thread.h"
@@ -49,6 +55,79 @@ private:
 };
 
 
+//
+// A non-recursive mutex.
+//
+class Mutex
+    : public boost::noncopyable
+{
+public:
+    Mutex();
+    ~Mutex();
+    void lock();
+    void unlock();
+
+private:
+    friend class Condition;
+
+#   ifdef BOOST_HAS_WINTHREADS
+    CRITICAL_SECTION  m_mutex;
+#   else
+    pthread_mutex_t   m_mutex;
+#   endif
+};
+
+
+//
+// Locks a mutex for the lifetime of the object.
+//
+class ScopedLock
+    : public boost::noncopyable
+{
+public:
+    explicit ScopedLock(Mutex& mutex)
+        : m_mutex(mutex)
+    {
+        m_mutex.lock();
+    }
+
+    ~ScopedLock() {
+        m_mutex.unlock();
+    }
+
+private:
+    Mutex& m_mutex;
+};
+
+
+//
+// A condition variable; wait() must be called with the mutex locked.
+//
+// On Windows versions older than Vista, each waiting thread waits on its own
+// event. The events are queued and signaled in the order of the wait() calls.
+//
+class Condition
+    : public boost::noncopyable
+{
+public:
+    Condition();
+    ~Condition();
+    void wait(Mutex& mutex);
+    void notify_one();
+    void notify_all();
+
+private:
+#   if defined(JAG_WIN32_CONDITION_VARIABLE)
+    CONDITION_VARIABLE  m_cond;
+#   elif defined(BOOST_HAS_WINTHREADS)
+    CRITICAL_SECTION    m_waiters_lock;
+    std::deque<HANDLE>  m_waiters;
+#   else
+    pthread_cond_t      m_cond;
+#   endif
+};
+
+
 /// Yields the processor from the currently executing thread to
 /// another ready to run, active thread of equal priority.
 void scheduled_yield();
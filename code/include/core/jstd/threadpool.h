@@ -0,0 +1,49 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+
+#ifndef THREADPOOL_JG2147_H__
+#define THREADPOOL_JG2147_H__
+
+#include <core/jstd/thread.h>
+#include <boost/noncopyable.hpp>
+#include <boost/function.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
+#include <deque>
+
+namespace jag {
+namespace jstd {
+
+//
+// A fixed set of worker threads executing submitted tasks in the
+// submission order. Tasks must not throw.
+//
+class ThreadPool
+    : public boost::noncopyable
+{
+public:
+    typedef boost::function0<void> task_t;
+
+    explicit ThreadPool(int num_threads);
+    ~ThreadPool();
+    void submit(task_t const& task);
+    int num_threads() const;
+
+private:
+    void worker();
+
+private:
+    Mutex                       m_mutex;
+    Condition                   m_task_available;
+    std::deque<task_t>          m_tasks;
+    bool                        m_stopping;
+    boost::ptr_vector<Thread>   m_threads;
+};
+
+}} // namespace jag::jstd
+
+#endif // THREADPOOL_JG2147_H__
+/** EOF @file */
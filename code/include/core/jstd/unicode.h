@@ -26,6 +26,23 @@ namespace jstd {
 /// Retrives canonical name for given encoding.
 char const* get_canonical_converter_name(Char const* enc);
 
+///
+/// Decodes a single well-formed UTF-8 sequence and advances the source past
+/// it. Returns -1 and leaves the source intact if the sequence is ill-formed
+/// (overlong, surrogate, out of range or truncated).
+///
+Int utf8_next_code_point(Char const** source, Char const* end);
+
+///
+/// Appends code points of the UTF-8 text to the vector. Runs of ASCII
+/// characters are detected a machine word at a time.
+///
+/// @return end, or the start of the first ill-formed sequence
+///
+Char const* utf8_to_code_points(Char const* begin, Char const* end,
+                                std::vector<Int>& code_points);
+
+
 
 //
 // Encapsulates from/to unicode conversion
@@ -41,6 +58,7 @@ public:
 
 public: // conversions
     Int next_code_point(Char const** source, Char const* end);
+    void code_points(Char const* begin, Char const* end, std::vector<Int>& result);
     Int from_codepoint(Int codepoint, Char* buffer, unsigned buffer_size);
 
 public: // internal object
@@ -48,7 +66,10 @@ public: // internal object
 
 private:
     UnicodeConverter(UConverter const* other);
+    Int icu_next_code_point(Char const** source, Char const* end);
+
     UConverter* m_converter;
+    bool        m_utf8;  // UTF-8 is decoded without ICU
 };
 
 
@@ -10,9 +10,13 @@
 
 #include <interfaces/streams.h>
 #include <core/generic/noncopyable.h>
+#include <core/jstd/thread.h>
+#include <core/jstd/deflate.h>
 #include <boost/shared_ptr.hpp>
 #include <zlib.h>
 #include <memory>
+#include <vector>
+#include <deque>
 
 namespace jag { namespace jstd
 {
@@ -22,7 +26,7 @@ class ZLibStreamOutput
     : public ISeqStreamOutputControl
 {
 public:
-    ZLibStreamOutput(ISeqStreamOutput& stream, int compression_level = Z_DEFAULT_COMPRESSION);
+    ZLibStreamOutput(ISeqStreamOutput& stream, DeflateParams const& params = DeflateParams());
     ~ZLibStreamOutput();
 
 public:  //ISeqStreamOutput
@@ -33,18 +37,81 @@ public:  //ISeqStreamOutput
 public: //ISeqStreamOutputControl
     void close();
 
+public:
+    void reset(ISeqStreamOutput& stream);
+    bool is_closed() const { return m_closed; }
+    DeflateParams const& params() const { return m_params; }
+
 private:
     int DeflateBuffer(int flush_type);
 
 private:
     enum                { CHUNK_SIZE = 16384 };
-    ISeqStreamOutput&   m_stream;
+    ISeqStreamOutput*   m_stream;
+    DeflateParams       m_params;
     ULong               m_position;
     z_stream            m_strm;
     bool                m_closed;
 };
 
 
+class ThreadPool;
+
+//
+// Deflates the data on a thread pool. Written data are collected into chunks
+// which are deflated in order by a single deflate filter, so the produced
+// stream is the same as if the filter was used directly. The underlying
+// stream must not be accessed until close() or flush() returns.
+//
+class PooledZLibStreamOutput
+    : public ISeqStreamOutputControl
+{
+public:
+    PooledZLibStreamOutput(ISeqStreamOutput& stream, ThreadPool& pool,
+                           DeflateParams const& params = DeflateParams());
+    PooledZLibStreamOutput(std::auto_ptr<ISeqStreamOutputControl> deflater,
+                           ThreadPool& pool);
+    ~PooledZLibStreamOutput();
+    std::auto_ptr<ISeqStreamOutputControl> release_deflater();
+
+public:  //ISeqStreamOutput
+    void write(void const* data, ULong size);
+    ULong tell() const;
+    void flush();
+
+public: //ISeqStreamOutputControl
+    void close();
+
+private:
+    enum Operation { OP_WRITE, OP_FLUSH, OP_CLOSE };
+    void submit(Operation op);
+    void wait_idle();
+    void check_failure();
+    void deflate_queued();
+
+private:
+    enum { CHUNK_SIZE = 65536, MAX_QUEUED_CHUNKS = 16 };
+    struct Chunk
+    {
+        Operation          op;
+        std::vector<char>  data;
+    };
+
+    ThreadPool&         m_pool;
+    std::auto_ptr<ISeqStreamOutputControl> m_deflater;
+    std::vector<char>   m_pending;
+    ULong               m_position;
+    bool                m_closed;
+
+    // guarded by m_mutex
+    Mutex               m_mutex;
+    Condition           m_idle;
+    std::deque<Chunk>   m_queue;
+    bool                m_scheduled;
+    bool                m_failed;
+};
+
+
 class ZLibStreamInput
     : public ISeqStreamInput
 {
@@ -59,6 +59,21 @@ typedef struct jag_streamout_tag
 } jag_streamout;
 
 
+typedef struct jag_streamin_tag
+{
+    jag_Int (JAG_CALLSPEC *read)(void* custom_data, void* data, jag_ULong size, jag_ULong* read);
+    void (JAG_CALLSPEC *close)(void* custom_data);
+    void *custom_data;
+} jag_streamin;
+
+
+typedef struct jag_datarelease_tag
+{
+    void (JAG_CALLSPEC *release)(void* custom_data, void const* data);
+    void *custom_data;
+} jag_datarelease;
+
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -150,6 +150,60 @@ private:
 };
 
 
+//
+//
+//
+class StreamIn
+    : public jag_streamin
+{
+public:
+    StreamIn() {
+        jag_streamin::read = StreamIn::s_read;
+        jag_streamin::close = StreamIn::s_close;
+        jag_streamin::custom_data = this;
+    }
+
+    virtual ~StreamIn() {}
+
+protected:
+    virtual Int read(void* data, ULong size, ULong* read) = 0;
+    virtual void close() = 0;
+
+private:
+    static jag_Int JAG_CALLSPEC s_read(void* this_, void* data, jag_ULong size, jag_ULong* read) {
+        return static_cast<StreamIn*>(this_)->read(data, size, read);
+    }
+
+    static void JAG_CALLSPEC s_close(void* this_) {
+        static_cast<StreamIn*>(this_)->close();
+    }
+};
+
+
+//
+//
+//
+class DataRelease
+    : public jag_datarelease
+{
+public:
+    DataRelease() {
+        jag_datarelease::release = DataRelease::s_release;
+        jag_datarelease::custom_data = this;
+    }
+
+    virtual ~DataRelease() {}
+
+protected:
+    virtual void release(void const* data) = 0;
+
+private:
+    static void JAG_CALLSPEC s_release(void* this_, void const* data) {
+        static_cast<DataRelease*>(this_)->release(data);
+    }
+};
+
+
 }} // namespace jag::pdf
 
 #endif
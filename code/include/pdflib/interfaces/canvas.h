@@ -319,6 +319,62 @@ public:
                         Double angle, Int large_arc_flag, Int sweep_flag) = 0;
 
 
+    /// Appends a sequence of connected straight line segments to the current
+    /// path.
+    ///
+    /// Begins a new subpath at the first point and connects the remaining
+    /// points with straight line segments. This is the same as calling
+    /// move_to() for the first point and line_to() for the rest of them.
+    ///
+    /// @param array_in x and y coordinates of the points, i.e. [x0, y0, x1,
+    ///        y1, ...]
+    /// @param length length of the array, a nonzero even number
+    ///
+    /// @version 1.5
+    ///
+    virtual void polyline(Double const* array_in, UInt length) = 0;
+
+
+    /// Appends a closed polygon to the current path.
+    ///
+    /// This is the same as polyline() followed by path_close().
+    ///
+    /// @param array_in x and y coordinates of the vertices, i.e. [x0, y0,
+    ///        x1, y1, ...]
+    /// @param length length of the array, a nonzero even number
+    ///
+    /// @version 1.5
+    ///
+    virtual void polygon(Double const* array_in, UInt length) = 0;
+
+
+    /// Appends a sequence of cubic Bezier curves to the current path.
+    ///
+    /// Each curve is specified by six numbers [x1, y1, x2, y2, x3, y3] as in
+    /// bezier_to() and starts in the endpoint of the previous one.
+    ///
+    /// @param array_in control points and endpoints of the curves
+    /// @param length length of the array, a nonzero multiple of 6
+    ///
+    /// @pre Path construction has already started.
+    /// @version 1.5
+    ///
+    virtual void beziers(Double const* array_in, UInt length) = 0;
+
+
+    /// Appends rectangles to the current path, each as a complete subpath.
+    ///
+    /// Each rectangle is specified by four numbers [x, y, width, height] as
+    /// in rectangle().
+    ///
+    /// @param array_in rectangles
+    /// @param length length of the array, a nonzero multiple of 4
+    ///
+    /// @version 1.5
+    ///
+    virtual void rectangles(Double const* array_in, UInt length) = 0;
+
+
     /// Closes the current subpath by appending a straight line segment.
     ///
     /// The segment starts in the current point and ends in the starting point
@@ -39,6 +39,7 @@ public: //IImageMan
     ImageMaskHandle register_image_mask(boost::intrusive_ptr<IImageMask> image_mask);
     ImageMaskHandle register_image_mask(boost::intrusive_ptr<IImageMaskData> image_mask);
     IImageMaskData const& image_mask_data(ImageMaskHandle imagemask) const;
+    void release_borrowed_data();
 
 public:
     ImageManImpl(boost::weak_ptr<IResourceCtx> resource_ctx);
@@ -23,7 +23,9 @@
 namespace jag {
 // fwd
 class IStreamInput;
+class ISeqStreamInput;
 class IExecContext;
+class IColorSpaceMan;
 namespace jstd { class MemoryStreamOutput; }
 
 namespace resources
@@ -49,6 +51,8 @@ public: //IImageDef
     void image_mask(ImageMaskID image_mask);
     void file_name(Char const* file_name);
     void data(Byte const* data, UInt length);
+    void data_borrowed(Byte const* data, UInt length, jag_datarelease const* release);
+    void data_source(jag_streamin const* source);
     void alternate_for_printing(IImage* image);
     void gamma(Double val);
 
@@ -63,6 +67,8 @@ public: //IImageData
     ColorKeyMaskArray const& color_key_mask() const { return m_color_key_mask; }
     ImageMaskHandle image_mask() const { return m_mask; }
     bool output_image(ISeqStreamOutput& fout, unsigned max_bits) const;
+    UInt flate_predictor_colors() const { return 0; }
+    void output_flate_predicted(ISeqStreamOutput& fout) const;
     ImageFormat format() const { return m_type; }
     Double gamma() const;
     Int has_gamma() const;
@@ -73,13 +79,18 @@ public: //IImageData
     InterpolateType interpolate() const { return m_interpolate; }
     ImageHandle handle() const { JAG_ASSERT(is_valid(m_handle)); return m_handle; }
     void handle(ImageHandle handle) { m_handle=handle; }
+    Char const* file_name() const { return m_file_name.c_str(); }
+    bool data_pulled() const { return !!m_data_source; }
+    bool borrows_data() const { return !!m_borrowed_data; }
+    void release_borrowed_data() { m_borrowed_data.reset(); }
 
 public:
     ImageSpecImpl();
-    void check_consistency(IExecContext const& exec_ctx);
+    void check_consistency(IExecContext const& exec_ctx, IColorSpaceMan const& cs_man);
 
 private:
     boost::shared_ptr<IStreamInput> data_stream() const;
+    boost::shared_ptr<ISeqStreamInput> input_stream() const;
 
 private: // Impl
     ImageFormat     m_type;
@@ -104,7 +115,14 @@ private: // Impl
 
     // data source variant
     mutable boost::shared_ptr<jstd::MemoryStreamOutput>    m_image_data;
-    std::string                                                m_file_name;
+    // caller's memory, the deleter invokes the release callback
+    mutable boost::shared_ptr<Byte const>                  m_borrowed_data;
+    UInt                                                   m_borrowed_length;
+    // pulled when the image is written
+    mutable boost::shared_ptr<ISeqStreamInput>             m_data_source;
+    // size of the samples pulled from the source
+    ULong                                                  m_source_size;
+    std::string                                            m_file_name;
 };
 
 
@@ -47,6 +47,8 @@ public:
     virtual cs_handle_pair_t color_space_load(Char const* spec) = 0;
 
     virtual ColorSpaceHandle register_palette(ColorSpaceHandle cs, Byte const* palette, UInt byte_size) = 0;
+    /// registers the built-in sRGB profile, it is registered once per document
+    virtual ColorSpaceHandle register_srgb() = 0;
     virtual boost::intrusive_ptr<ICIELab> define_cielab() const = 0;
     virtual boost::intrusive_ptr<ICIECalGray> define_calgray() const = 0;
     virtual boost::intrusive_ptr<ICIECalRGB> define_calrgb() const = 0;
@@ -44,7 +44,42 @@ public:
     /// @version 1.4
     virtual Double glyph_width(UInt16 glyph_index) const = 0;
 
-    
+    /// Retrieves widths of several substrings of the passed string in user
+    /// space units.
+    ///
+    /// The substrings are specified by pairs of byte offsets into the
+    /// string. The width of the i-th substring is stored to array_out[i].
+    /// This is the same as calling advance() for each of the substrings.
+    ///
+    /// @param txt_u string
+    /// @param array_in start and end offsets of the substrings, i.e. [start0,
+    ///        end0, start1, end1, ...]
+    /// @param length length of array_in, an even number
+    /// @param array_out receives the widths
+    /// @param out_length length of array_out, at least length/2
+    ///
+    /// @version 1.5
+    virtual void advances(Char const* txt_u,
+                          UInt const* array_in, UInt length,
+                          Double* array_out, UInt out_length) const = 0;
+
+    /// Retrieves positions of the characters of the passed string in user
+    /// space units.
+    ///
+    /// The i-th position is the width of the string consisting of the first
+    /// i+1 characters, so the last position is equal to advance(). If kerning
+    /// is turned on then the kerning offsets are counted in.
+    ///
+    /// @param txt_u string
+    /// @param array_out receives the positions, at most out_length of them
+    /// @param out_length length of array_out
+    /// @return number of characters of the string
+    ///
+    /// @version 1.5
+    virtual UInt char_positions(Char const* txt_u,
+                                Double* array_out, UInt out_length) const = 0;
+
+
     /// Retrieves baseline distance in user space units.
     virtual Double height() const = 0;
     /// Retrieves ascender in user space units.
@@ -53,9 +53,36 @@ public:
      */
     virtual bool output_image(ISeqStreamOutput& fout, unsigned max_bits) const = 0;
 
+    /**
+     * @brief number of color components of flate predicted image data
+     *
+     * If non-zero then the image data can be provided by
+     * output_flate_predicted() compressed by FlateDecode and encoded
+     * by PNG predictors. Like output_image(), it might be possible to
+     * call it only once.
+     */
+    virtual UInt flate_predictor_colors() const = 0;
+    virtual void output_flate_predicted(ISeqStreamOutput& fout) const = 0;
+
     // provides raw image data stream, might be gone if the image has been already outputted
     virtual boost::shared_ptr<IStreamInput> data_stream() const = 0;
 
+    // name of the file the raw image data are read from, empty string if the
+    // data do not come directly from a file
+    virtual Char const* file_name() const = 0;
+
+    // true if the raw image data are pulled from a client's source by
+    // output_image(), i.e. they are not available before being outputted
+    virtual bool data_pulled() const = 0;
+
+    // true if the raw image data are in the client's memory released by a
+    // callback
+    virtual bool borrows_data() const = 0;
+
+    // releases the client's memory if the data have not been outputted yet,
+    // the image cannot be outputted afterwards
+    virtual void release_borrowed_data() = 0;
+
 public:
     virtual ImageHandle handle() const = 0;
     virtual void handle(ImageHandle handle) = 0;
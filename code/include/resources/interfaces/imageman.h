@@ -37,6 +37,10 @@ public:
     virtual ImageMaskHandle register_image_mask(boost::intrusive_ptr<IImageMaskData> image_mask) = 0;
     virtual IImageMaskData const& image_mask_data(ImageMaskHandle imagemask) const = 0;
 
+    // releases the client's memory held by definitions and by images which
+    // have not been outputted, invoked when the document is finalized
+    virtual void release_borrowed_data() = 0;
+
 protected:
     ~IImageMan() {}
 };
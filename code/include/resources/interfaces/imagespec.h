@@ -11,6 +11,7 @@
 #include <interfaces/stdtypes.h>
 #include <interfaces/refcounted.h>
 #include <interfaces/constants.h>
+#include <jagpdf/detail/c_prologue.h>
 
 namespace jag
 {
@@ -50,6 +51,45 @@ public:
     /// @param length image data byte size
     ///
     virtual void data(Byte const* array_in, UInt length) = 0;
+
+
+    /// Specifies image data in memory owned by the caller.
+    ///
+    /// Unlike data(), the image data are not copied. [lib] reads them directly
+    /// from the caller's memory, so the memory must remain valid and unchanged
+    /// until the release callback is invoked. That happens once the image has
+    /// been written or the image definition is discarded, at the latest when
+    /// the document is finalized. The callback is invoked exactly once, even if
+    /// this method fails. It is always invoked from within a call the client
+    /// makes to [lib], never from a worker thread, so such image is not
+    /// prepared in advance by images.prepare_threads.
+    ///
+    /// Replaces data specified previously by data() or file_name().
+    ///
+    /// @param array_in image data
+    /// @param length image data byte size
+    /// @param release invoked when the data are no longer needed, can be null
+    ///
+    virtual void data_borrowed(Byte const* array_in, UInt length, jag_datarelease const* release) = 0;
+
+
+    /// Specifies a source from which image data are pulled.
+    ///
+    /// The data are read sequentially when the image is written, so the image
+    /// does not have to be kept in memory as a whole. Only the native format
+    /// is supported; if no format is specified then IMAGE_FORMAT_NATIVE is
+    /// assumed.
+    ///
+    /// The source is closed exactly once, when the image has been written or
+    /// the image definition is discarded, even if this method fails. The data are never buffered, so such
+    /// image is not deduplicated even if doc.dedup_streams is set.
+    ///
+    /// Replaces data specified previously by data(), data_borrowed() or
+    /// file_name().
+    ///
+    /// @param source image data source
+    ///
+    virtual void data_source(jag_streamin const* source) = 0;
     //@}
 
 
@@ -7,10 +7,12 @@
 #define __TYPEFACE_H_JAG_1227__
 
 #include <interfaces/refcounted.h>
+#include <core/jstd/glyphtables.h>
 #include <boost/shared_ptr.hpp>
 #include <boost/noncopyable.hpp>
 #include <string>
-#include <set>
+#include <vector>
+#include <iterator>
 #include <map>
 
 #if !defined(__GCCXML__) && !defined(__DOXYGEN__)
@@ -28,6 +30,11 @@ namespace jag {
 
 class IStreamInput;
 class ITypeface;
+namespace jstd { class Mutex; }
+
+using jstd::GlyphSet;
+using jstd::CodepointTable;
+
 
 //
 //
@@ -36,7 +43,7 @@ class UsedGlyphs
     : public boost::noncopyable
 {
 public:
-    typedef std::set<UInt16> Glyphs;
+    typedef GlyphSet Glyphs;
     typedef Glyphs::const_iterator GlyphsIter;
     
     typedef std::map<Int, UInt16> CodepointToGlyph;
@@ -63,10 +70,13 @@ public:
 private:
     void copy_if_not_unique();
     ITypeface const& m_face;
+    void update_codepoint_to_glyph();
     struct Impl{
         // all glyphs, including those without a codepoint assigned
         Glyphs glyphs;
         // Unicode to glyph index dictionary
+        CodepointTable codepoints;
+        // sorted copy of codepoints, made by update()
         CodepointToGlyph codepoint_to_glyph;
         bool update_glyphs;
         bool update_map;
@@ -87,7 +97,8 @@ public:
         UInt glyph;
     };
     
-    FaceCharIterator(FT_FaceRec_* face);
+    /// lock, if given, guards the face while the iterator advances
+    FaceCharIterator(FT_FaceRec_* face, jstd::Mutex* lock=0);
     bool done() const;
     Item const& current() const;
     void next();
@@ -95,6 +106,7 @@ public:
 private:
     Item m_item;
     FT_FaceRec_* m_face;
+    jstd::Mutex* m_lock;
 };
 
 
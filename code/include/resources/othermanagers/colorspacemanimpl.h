@@ -11,6 +11,8 @@
 #include <resources/interfaces/colorspaceman.h>
 #include <resources/interfaces/colorspaces.h>
 #include <resources/utils/resourcetable.h>
+#include <core/jstd/md5.h>
+#include <map>
 
 namespace jag {
 namespace resources {
@@ -20,7 +22,10 @@ namespace resources {
  *
  * As of now, it is not a genuine resource manager as it
  * - does not map the same color spaces to the same handle
- *   (but that could be done using hashing in the future)
+ *   (but that could be done using hashing in the future);
+ *   the exception are ICC based color spaces which are
+ *   looked up by a digest of their profile, so e.g. images
+ *   tagged as sRGB share a single color space
  *
  * When a color space is being register then its clone is
  * stored within the manager, so the space can be reused for
@@ -39,6 +44,7 @@ public:
 
 public: //IColorSpaceMan
     ColorSpaceHandle register_palette(ColorSpaceHandle cs, Byte const* palette, UInt byte_size);
+    ColorSpaceHandle register_srgb();
 
     cs_handle_pair_t color_space_load(Char const* spec);
     boost::intrusive_ptr<ICIELab> define_cielab() const;
@@ -53,10 +59,25 @@ public: //IColorSpaceMan
     int num_components(ColorSpaceHandle csh) const;
 
 private:
-    ColorSpaceHandle register_icc_from_memory(Byte const* mem, size_t size, int nr_components);
+    ColorSpaceHandle register_icc_static(Byte const* mem, size_t size, int nr_components);
+    ColorSpaceHandle iccbased_load(boost::intrusive_ptr<IColorSpace> cs);
+    ColorSpaceHandle add_color_space(boost::intrusive_ptr<IColorSpace> const& cs);
 
 private:
     ResourceTable<ColorSpaceHandle,boost::intrusive_ptr<IColorSpace> > m_cs_table;
+
+    // md5 of the profile, number of components and alternate color space
+    struct ICCKey
+    {
+        ICCKey(jstd::MD5Hash::Sum const& digest, int num_components, ColorSpaceHandle alternate);
+        bool operator<(ICCKey const& other) const;
+
+        Byte             digest[16];
+        int              num_components;
+        ColorSpaceHandle alternate;
+    };
+    typedef std::map<ICCKey,ColorSpaceHandle> ICCMap;
+    ICCMap m_icc_map;
 };
 
 
@@ -13,6 +13,7 @@
 #include <resources/interfaces/resourcehandle.h>
 #include <core/generic/assert.h>
 #include <boost/array.hpp>
+#include <boost/shared_array.hpp>
 #include <memory>
 #include <vector>
 
@@ -201,7 +202,11 @@ public: // ICCBased
 
 public:
     ICCBasedImpl();
-    boost::shared_ptr<ISeqStreamInput> icc_profile() const;
+    void icc_profile_static(Byte const* data, size_t size);
+    void fetch_profile();
+    Byte const* profile_data() const;
+    size_t profile_size() const { return m_profile_size; }
+    bool is_profile_static() const { return m_profile && !m_profile_buffer; }
     ColorSpaceHandle alternate() const { return m_alternate; }
 
 private:
@@ -209,9 +214,10 @@ private:
     ColorSpaceHandle                         m_alternate;
     std::string                              m_file_path;
     mutable std::auto_ptr<ISeqStreamInput>   m_stream;
-#ifdef _DEBUG
-    mutable bool                             m_stream_retrieved;
-#endif
+    // the profile data, available once fetched; not owned if static
+    Byte const*                              m_profile;
+    size_t                                   m_profile_size;
+    boost::shared_array<Byte>                m_profile_buffer;
 };
 
 
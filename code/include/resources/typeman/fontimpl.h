@@ -48,6 +48,11 @@ public:
     Double advance(Char const* text) const;
     Double advance_r(jag::Char const* start, jag::Char const* end) const;
     Double glyph_width(UInt16 glyph_index) const;
+    void advances(Char const* text,
+                  UInt const* ranges, UInt length,
+                  Double* widths, UInt widths_length) const;
+    UInt char_positions(Char const* text,
+                        Double* positions, UInt positions_length) const;
     Double height() const;
     Double ascender() const { return m_coef*m_typeface.metrics().ascent; }
     Double descender() const { return m_coef*m_typeface.metrics().descent; }
@@ -71,6 +76,10 @@ public: // IFontEx
         JAG_INTERNAL_ERROR;
     }
 
+private:
+    Double advance_conv(jstd::UnicodeConverter* conv,
+                        Char const* text, Char const* end) const;
+
 private:
     ITypeface const& m_typeface;
 
@@ -124,6 +133,11 @@ public: // IFont
     Double advance(jag::Char const* text) const;
     Double advance_r(jag::Char const* start, jag::Char const* end) const;
     Double glyph_width(UInt16 glyph_index) const;
+    void advances(Char const* text,
+                  UInt const* ranges, UInt length,
+                  Double* widths, UInt widths_length) const;
+    UInt char_positions(Char const* text,
+                        Double* positions, UInt positions_length) const;
 
     Double height() const {
         return m_coef * m_typeface->metrics().baseline_distance; }
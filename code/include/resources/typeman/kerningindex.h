@@ -0,0 +1,49 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+
+#ifndef __KERNINGINDEX_H_JAG_2340__
+#define __KERNINGINDEX_H_JAG_2340__
+
+#include <core/generic/noncopyable.h>
+#include <interfaces/stdtypes.h>
+#include <boost/cstdint.hpp>
+#include <vector>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+namespace jag {
+namespace resources {
+
+///
+/// Kerning pairs of a face in an open addressing hash table keyed by
+/// (left gid, right gid).
+///
+/// The pairs are collected from the horizontal format 0 subtables of the
+/// 'kern' table and their values are taken from FreeType, so the lookup gives
+/// the same results as FT_Get_Kerning() in the unscaled mode.
+///
+class KerningIndex
+    : public noncopyable
+{
+public:
+    KerningIndex();
+    void build(FT_Face face);
+    Int kerning(UInt left, UInt right) const;
+
+private:
+    void insert(boost::uint32_t key, Int value);
+    size_t slot(boost::uint32_t key) const;
+
+private:
+    std::vector<boost::uint32_t> m_keys;
+    std::vector<Int>             m_values;
+};
+
+}} // namespace jag::resources
+
+#endif // __KERNINGINDEX_H_JAG_2340__
@@ -10,9 +10,12 @@
 
 #include <core/generic/noncopyable.h>
 #include <core/jstd/md5.h>
+#include <core/jstd/thread.h>
 #include <resources/interfaces/typeface.h>
 #include <boost/shared_ptr.hpp>
 #include <boost/scoped_ptr.hpp>
+#include <vector>
+#include <map>
 
 
 #include <ft2build.h>
@@ -31,6 +34,7 @@ namespace resources
 {
 // fwd
 class FTOpenArgs;
+class KerningIndex;
 
 
 /// TypefaceImpl representation.
@@ -83,6 +87,8 @@ public:
 
 private:
     void calculate_hash();
+    Int gid_horizontal_advance_unlocked(UInt gid) const;
+    void build_lookup_tables();
     int data_size(int index) const;
     void detect_type();
     void preflight();
@@ -102,6 +108,17 @@ private:
     Double                          m_italic_angle;
     Int                           m_fixed_width;
     Int                           m_width_class;
+    // FreeType face objects are not thread safe; a typeface can be
+    // shared by documents produced on different threads
+    mutable jstd::Mutex             m_face_mutex;
+
+    // lookup tables built by the constructor and read only afterwards, so
+    // they can be used without locking m_face_mutex
+    typedef std::map<Int,UInt16> AstralToGid;
+    std::vector<Int>                m_gid_advances;
+    std::vector<UInt16>             m_bmp_to_gid;
+    AstralToGid                     m_astral_to_gid;
+    boost::scoped_ptr<KerningIndex> m_kerning;
 };
 
 // size_t hash_value(TypefaceImpl const& font);
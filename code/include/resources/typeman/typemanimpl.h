@@ -17,12 +17,13 @@
 #include <boost/intrusive_ptr.hpp>
 #include <boost/ref.hpp>
 #include <boost/ptr_container/ptr_vector.hpp>
-#include <boost/ptr_container/ptr_set.hpp>
+#include <boost/shared_ptr.hpp>
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
 #include <set>
+#include <vector>
 
 namespace jag {
 class IExecContext;
@@ -79,7 +80,7 @@ private:
         ITypeface& typeface,
         IExecContext const& exec_ctx) const;
 
-    std::auto_ptr<ITypeface> create_typeface_from_file(
+    boost::shared_ptr<ITypeface> create_typeface_from_file(
         FontSpecImpl const& spec,
         IExecContext const& ctx,
         CharEncodingRecord const& enc_rec) const;
@@ -110,9 +111,14 @@ private:
 
 
 private:
-    typedef boost::ptr_set<ITypeface> Typefaces;
+    // typefaces can be shared with other documents (see TypefaceCache)
+    typedef boost::reference_wrapper<ITypeface> TypefaceRef;
+    typedef std::set<TypefaceRef> Typefaces;
     Typefaces m_typefaces;
 
+    typedef std::vector<boost::shared_ptr<ITypeface> > TypefacesStorage;
+    TypefacesStorage m_typefaces_storage;
+
     typedef boost::reference_wrapper<FontImpl> FontImplRef;
     typedef std::set<FontImplRef> FontsMap;
     FontsMap m_fonts_map;
@@ -14,6 +14,7 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/intrusive/list.hpp>
 #include <vector>
+#include <algorithm>
 
 namespace jag {
 namespace resources {
@@ -30,6 +31,9 @@ public:
     RES& lookup(ID res_id);
     ID add(typename CONT::value_type const& resource);
     size_t size() const { return m_resources.size(); }
+    template<class Fn> void for_each(Fn fn) {
+        std::for_each(m_resources.begin(), m_resources.end(), fn);
+    }
 
 private:
     typedef CONT ResourceVec;
@@ -140,6 +144,11 @@ public:
         return retval;
     }
 
+    // applies fn to all definitions that have not been looked up
+    template<class Fn> void for_each(Fn fn) {
+        std::for_each(m_list.begin(), m_list.end(), fn);
+    }
+
     // adds a new resource definition to the list - the ownership is transfered
     Def* add(std::auto_ptr<Def> new_one) {
         m_list.push_back(*new_one.release());
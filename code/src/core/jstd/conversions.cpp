@@ -8,9 +8,12 @@
 #include "precompiled.h"
 #include <core/jstd/conversions.h>
 #include <core/jstd/icumain.h>
+#include <core/jstd/crt.h>
 #include <unicode/ucnv.h>
 #include <core/generic/scopeguard.h>
+#include <core/generic/minmax.h>
 #include <string.h>
+#include <math.h>
 
 namespace jag {
 namespace jstd {
@@ -36,6 +39,239 @@ FromUTF8::FromUTF8(Char const* src, UInt length)
     }
 }
 
+
+namespace
+{
+  // writes digits of a nonzero value in the reversed order
+  inline Char* write_reversed_digits(Char* p, UInt64 value)
+  {
+      do
+      {
+          *p++ = static_cast<Char>('0' + value % 10);
+          value /= 10;
+      }
+      while(value);
+
+      return p;
+  }
+
+  // writes the reversed buffer [begin, end) to the destination
+  inline int copy_reversed(Char* dest, Char const* begin, Char const* end)
+  {
+      Char* p = dest;
+      while(end != begin)
+          *p++ = *--end;
+
+      return static_cast<int>(p - dest);
+  }
+
+  // above this magnitude the scaled value is not guaranteed to be an exact
+  // representation of the %.5f output, so snprintf_pdf_double() is used
+  const double FAST_DOUBLE_LIMIT = 1e9;
+
+  // two hexadecimal digits of each byte value
+  Char const hex_digits[] =
+      "000102030405060708090a0b0c0d0e0f"
+      "101112131415161718191a1b1c1d1e1f"
+      "202122232425262728292a2b2c2d2e2f"
+      "303132333435363738393a3b3c3d3e3f"
+      "404142434445464748494a4b4c4d4e4f"
+      "505152535455565758595a5b5c5d5e5f"
+      "606162636465666768696a6b6c6d6e6f"
+      "707172737475767778797a7b7c7d7e7f"
+      "808182838485868788898a8b8c8d8e8f"
+      "909192939495969798999a9b9c9d9e9f"
+      "a0a1a2a3a4a5a6a7a8a9aaabacadaeaf"
+      "b0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+      "c0c1c2c3c4c5c6c7c8c9cacbcccdcecf"
+      "d0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+      "e0e1e2e3e4e5e6e7e8e9eaebecedeeef"
+      "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+  // escape characters of bytes which must not appear in a literal string
+  // as they are, see '3.2.3 Literal Strings'
+  Char const literal_string_escapes[256] = {
+         0,    0,    0,    0,    0,    0,    0,    0,  'b',  't',  'n',    0,  'f',  'r',    0,    0,  // 00
+         0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,  // 10
+         0,    0,    0,    0,    0,    0,    0,    0,  '(',  ')',    0,    0,    0,    0,    0,    0,  // 20
+         0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,  // 30
+         0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,  // 40
+         0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0, '\\',    0,    0,    0,  // 50
+         0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,  // 60
+         0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,  // 70
+         0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,  // 80
+         0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,  // 90
+         0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,  // a0
+         0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,  // b0
+         0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,  // c0
+         0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,  // d0
+         0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,  // e0
+         0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0   // f0
+  };
+
+  // bytes are examined a machine word at a time
+  typedef size_t Word;
+  const Word WORD_ONES = ~Word(0) / 255;
+  const Word WORD_HIGH_BITS = WORD_ONES * 0x80;
+
+  inline bool has_zero_byte(Word w)
+  {
+      return ((w - WORD_ONES) & ~w & WORD_HIGH_BITS) != 0;
+  }
+
+  // true if the word might contain a byte which needs an escape sequence;
+  // false positives are possible, false negatives are not
+  inline bool may_need_escape(Word w)
+  {
+      return has_zero_byte((w | WORD_ONES) ^ (WORD_ONES * ')'))  // ( )
+          || has_zero_byte(w ^ (WORD_ONES * '\\'))
+          || ((w - WORD_ONES * 0x0e) & ~w & WORD_HIGH_BITS) != 0;  // < 0x0e
+  }
+} // anonymous namespace
+
+
+//
+//
+//
+int format_int(Char* buffer, Int value)
+{
+    Char tmp[FORMAT_INT_MAX_SIZE];
+    Char* p = tmp;
+    if (value < 0)
+    {
+        *buffer++ = '-';
+        p = write_reversed_digits(p, -static_cast<Int64>(value));
+        return 1 + copy_reversed(buffer, tmp, p);
+    }
+
+    p = write_reversed_digits(p, value);
+    return copy_reversed(buffer, tmp, p);
+}
+
+
+//
+// Mirrors snprintf_pdf_double(): the value is rounded to .00001 in the same
+// way (see jag::round()), then the integral number of 1/100000 units is
+// written directly.
+//
+int format_pdf_double(Char* buffer, double value)
+{
+    if (!(value > -FAST_DOUBLE_LIMIT && value < FAST_DOUBLE_LIMIT))
+        return snprintf_pdf_double(buffer, PDF_DOUBLE_MAX_SIZE, value);
+
+    volatile double d2 = value / .00001;
+    const double units = value > 0 ? floor(d2 + .5) : ceil(d2 - .5);
+    if (units == 0.0)
+    {
+        buffer[0] = '0';
+        return 1;
+    }
+
+    Char* dest = buffer;
+    UInt64 abs_units;
+    if (units < 0)
+    {
+        *dest++ = '-';
+        abs_units = static_cast<UInt64>(-units);
+    }
+    else
+    {
+        abs_units = static_cast<UInt64>(units);
+    }
+
+    UInt frac = static_cast<UInt>(abs_units % 100000);
+    Char tmp[PDF_DOUBLE_MAX_SIZE];
+    Char* p = tmp;
+    if (frac)
+    {
+        // fractional digits without the trailing zeroes
+        int num_digits = 5;
+        while (!(frac % 10))
+        {
+            frac /= 10;
+            --num_digits;
+        }
+
+        while(num_digits--)
+        {
+            *p++ = static_cast<Char>('0' + frac % 10);
+            frac /= 10;
+        }
+        *p++ = '.';
+    }
+    p = write_reversed_digits(p, abs_units / 100000);
+    return static_cast<int>(dest - buffer) + copy_reversed(dest, tmp, p);
+}
+
+
+//
+//
+//
+Char* format_hex(Char* buffer, Byte const* data, size_t length)
+{
+    for(Byte const*const end=data+length; data!=end; ++data, buffer+=2)
+        memcpy(buffer, hex_digits + 2 * *data, 2);
+
+    return buffer;
+}
+
+
+//
+//
+//
+Char* format_hex(Char* buffer, UInt16 const* data, size_t length)
+{
+    for(UInt16 const*const end=data+length; data!=end; ++data, buffer+=4)
+    {
+        memcpy(buffer, hex_digits + 2 * (*data >> 8), 2);
+        memcpy(buffer + 2, hex_digits + 2 * (*data & 0xff), 2);
+    }
+    return buffer;
+}
+
+
+//
+// Words without a byte which could need escaping are skipped, a word which
+// might contain one is examined byte by byte.
+//
+size_t literal_string_run(Byte const* data, size_t length)
+{
+    Byte const* curr = data;
+    Byte const*const end = data + length;
+    for(;;)
+    {
+        Word w;
+        while(static_cast<size_t>(end - curr) >= sizeof(Word))
+        {
+            memcpy(&w, curr, sizeof(Word));
+            if (may_need_escape(w))
+                break;
+
+            curr += sizeof(Word);
+        }
+
+        Byte const*const stop = curr + (min)(sizeof(Word), static_cast<size_t>(end - curr));
+        for(; curr!=stop; ++curr)
+        {
+            if (literal_string_escapes[*curr])
+                return static_cast<size_t>(curr - data);
+        }
+
+        if (curr == end)
+            return length;
+    }
+}
+
+
+//
+//
+//
+Char literal_string_escape(Byte byte)
+{
+    return literal_string_escapes[byte];
+}
+
+
 }} // namespace jag::jstd
 
 /** EOF @file */
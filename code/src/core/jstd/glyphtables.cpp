@@ -0,0 +1,184 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+
+#include "precompiled.h"
+#include <core/jstd/glyphtables.h>
+
+namespace jag {
+namespace jstd {
+
+// ---------------------------------------------------------------------------
+//                    class jag::jstd::GlyphSet
+
+bool GlyphSet::insert(UInt16 glyph)
+{
+    if (m_words.empty())
+        m_words.resize(NUM_GLYPHS / WORD_BITS);
+
+    UInt& word = m_words[glyph / WORD_BITS];
+    const UInt bit = 1u << (glyph % WORD_BITS);
+    if (word & bit)
+        return false;
+
+    word |= bit;
+    ++m_size;
+    return true;
+}
+
+void GlyphSet::merge(GlyphSet const& other)
+{
+    if (other.m_words.empty())
+        return;
+
+    if (m_words.empty())
+    {
+        *this = other;
+        return;
+    }
+
+    m_size = 0;
+    for(size_t i=0; i<m_words.size(); ++i)
+    {
+        UInt word = m_words[i] |= other.m_words[i];
+        for(; word; word &= word - 1)
+            ++m_size;
+    }
+}
+
+size_t GlyphSet::count(UInt16 glyph) const
+{
+    if (m_words.empty())
+        return 0;
+
+    return (m_words[glyph / WORD_BITS] >> (glyph % WORD_BITS)) & 1;
+}
+
+GlyphSet::const_iterator GlyphSet::begin() const
+{
+    return const_iterator(this, m_size ? next(0) : NUM_GLYPHS);
+}
+
+GlyphSet::const_iterator GlyphSet::end() const
+{
+    return const_iterator(this, NUM_GLYPHS);
+}
+
+// the smallest glyph in the set not less than the given one, NUM_GLYPHS if none
+UInt GlyphSet::next(UInt glyph) const
+{
+    while(glyph < NUM_GLYPHS)
+    {
+        const UInt word = m_words[glyph / WORD_BITS] >> (glyph % WORD_BITS);
+        if (!word)
+        {
+            glyph = (glyph / WORD_BITS + 1) * WORD_BITS;
+            continue;
+        }
+
+        if (word & 1)
+            return glyph;
+
+        ++glyph;
+    }
+    return NUM_GLYPHS;
+}
+
+GlyphSet::const_iterator& GlyphSet::const_iterator::operator++()
+{
+    m_glyph = m_set->next(m_glyph + 1);
+    return *this;
+}
+
+GlyphSet::const_iterator GlyphSet::const_iterator::operator++(int)
+{
+    const_iterator result(*this);
+    ++*this;
+    return result;
+}
+
+
+// ---------------------------------------------------------------------------
+//                    class jag::jstd::CodepointTable
+
+bool CodepointTable::find(Int codepoint, UInt16& glyph) const
+{
+    if (codepoint < 0 || codepoint > MAX_CODEPOINT)
+    {
+        std::map<Int,UInt16>::const_iterator it = m_invalid.find(codepoint);
+        if (it == m_invalid.end())
+            return false;
+
+        glyph = it->second;
+        return true;
+    }
+
+    const size_t page = static_cast<UInt>(codepoint) >> PAGE_BITS;
+    if (page >= m_pages.size() || m_pages[page].empty())
+        return false;
+
+    const UInt entry = m_pages[page][codepoint & (PAGE_SIZE - 1)];
+    if (!entry)
+        return false;
+
+    glyph = static_cast<UInt16>(entry - 1);
+    return true;
+}
+
+void CodepointTable::insert(Int codepoint, UInt16 glyph)
+{
+    // not a Unicode codepoint, kept aside so that it is not looked up again
+    if (codepoint < 0 || codepoint > MAX_CODEPOINT)
+    {
+        m_invalid.insert(std::make_pair(codepoint, glyph));
+        return;
+    }
+
+    const size_t page = static_cast<UInt>(codepoint) >> PAGE_BITS;
+    if (page >= m_pages.size())
+        m_pages.resize(page + 1);
+
+    if (m_pages[page].empty())
+        m_pages[page].resize(PAGE_SIZE);
+
+    UInt& entry = m_pages[page][codepoint & (PAGE_SIZE - 1)];
+    if (!entry)
+        entry = glyph + 1u;
+}
+
+void CodepointTable::merge(CodepointTable const& other)
+{
+    for(Int cp = other.next(-1); cp >= 0; cp = other.next(cp))
+    {
+        UInt16 glyph = 0;
+        other.find(cp, glyph);
+        insert(cp, glyph);
+    }
+    m_invalid.insert(other.m_invalid.begin(), other.m_invalid.end());
+}
+
+Int CodepointTable::next(Int codepoint) const
+{
+    UInt cp = static_cast<UInt>(codepoint + 1);
+    for(size_t page = cp >> PAGE_BITS; page < m_pages.size(); ++page)
+    {
+        if (!m_pages[page].empty())
+        {
+            for(UInt i = cp & (PAGE_SIZE - 1); i < PAGE_SIZE; ++i)
+            {
+                if (m_pages[page][i])
+                    return static_cast<Int>((page << PAGE_BITS) + i);
+            }
+        }
+        cp = 0;
+    }
+    return -1;
+}
+
+
+}} // namespace jag::jstd
+
+/** EOF @file */
@@ -248,6 +248,22 @@ uintmax_t file_size(Char const* path)
 }
 
 
+//
+//
+//
+uintmax_t file_mtime(Char const* path)
+{
+    struct stat path_stat;
+    if (::stat(path, &path_stat))
+        throw exception_io_error(msg_cannot_get_filetime())
+            << JAGLOC
+            << io_object_info(path)
+            << errno_info(errno);
+
+    return static_cast<uintmax_t>(path_stat.st_mtime);
+}
+
+
   
 
 }} // namespace jag::jstd
@@ -15,6 +15,7 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 
 
 namespace jag {
@@ -191,6 +192,66 @@ MMapFileStreamOutput::~MMapFileStreamOutput()
 }
 
 
+//////////////////////////////////////////////////////////////////////////
+// MMapFileView
+//////////////////////////////////////////////////////////////////////////
+MMapFileView::MMapFileView(char const* fname)
+    : m_base_ptr(0)
+    , m_size(0)
+{
+    int hfile = ::open(fname, O_RDONLY);
+    if (hfile == -1)
+    {
+        throw exception_io_error(msg_cannot_open_file())
+            << errno_info(errno)
+            << io_object_info(fname)
+            << JAGLOC;
+    }
+
+    struct stat info;
+    if (-1 == ::fstat(hfile, &info))
+    {
+        const int err = errno;
+        ::close(hfile);
+        throw exception_io_error(msg_cannot_get_filesize())
+            << errno_info(err)
+            << io_object_info(fname)
+            << JAGLOC;
+    }
+
+    m_size = static_cast<ULong>(info.st_size);
+    if (m_size)
+    {
+        void* base_ptr = mmap(0, m_size, PROT_READ, MAP_PRIVATE, hfile, 0);
+        if (base_ptr == MAP_FAILED)
+        {
+            const int err = errno;
+            ::close(hfile);
+            throw exception_io_error(msg_cannot_mmap_file())
+                << errno_info(err)
+                << io_object_info(fname)
+                << JAGLOC;
+        }
+        m_base_ptr = static_cast<Byte*>(base_ptr);
+        // the file is typically read once from the beginning to the end
+        ::madvise(base_ptr, m_size, MADV_SEQUENTIAL);
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    ::close(hfile);
+}
+
+
+//
+//
+//
+MMapFileView::~MMapFileView()
+{
+    if (m_base_ptr && -1 == ::munmap(m_base_ptr, m_size))
+        JAG_ASSERT(!"munmap() failed");
+}
+
+
 }} // namespace jag::jstd
 
 /** EOF @file */
@@ -71,6 +71,61 @@ void Thread::join()
 }
 
 
+//
+//
+//
+Mutex::Mutex()
+{
+    if (pthread_mutex_init(&m_mutex, 0))
+        throw std::runtime_error("mutex creation failed");
+}
+
+Mutex::~Mutex()
+{
+    pthread_mutex_destroy(&m_mutex);
+}
+
+void Mutex::lock()
+{
+    pthread_mutex_lock(&m_mutex);
+}
+
+void Mutex::unlock()
+{
+    pthread_mutex_unlock(&m_mutex);
+}
+
+
+//
+//
+//
+Condition::Condition()
+{
+    if (pthread_cond_init(&m_cond, 0))
+        throw std::runtime_error("condition creation failed");
+}
+
+Condition::~Condition()
+{
+    pthread_cond_destroy(&m_cond);
+}
+
+void Condition::wait(Mutex& mutex)
+{
+    pthread_cond_wait(&m_cond, &mutex.m_mutex);
+}
+
+void Condition::notify_one()
+{
+    pthread_cond_signal(&m_cond);
+}
+
+void Condition::notify_all()
+{
+    pthread_cond_broadcast(&m_cond);
+}
+
+
 //
 // Free functions.
 //
@@ -0,0 +1,293 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+
+#include "precompiled.h"
+#include <core/jstd/streampool.h>
+#include <core/jstd/zlib_stream.h>
+#include <core/generic/checked_cast.h>
+#include <core/generic/minmax.h>
+#include <core/generic/assert.h>
+#include <string.h>
+
+namespace jag {
+namespace jstd {
+
+namespace
+{
+  // segments of a stream double in size up to the largest segment class
+  int segment_class(size_t index)
+  {
+      return static_cast<int>(
+          min<size_t>(index, StreamPool::NUM_SEGMENT_CLASSES - 1));
+  }
+
+} // anonymous namespace
+
+
+//
+//
+//
+StreamPool::StreamPool()
+    : m_idle_bytes(0)
+    , m_reuse_deflaters(deflate_stream_factory() == create_zlib_deflate_stream)
+{
+}
+
+
+//
+//
+//
+StreamPool::~StreamPool()
+{
+    for(int i=0; i<NUM_SEGMENT_CLASSES; ++i)
+    {
+        for(size_t j=0; j<m_segments[i].size(); ++j)
+            delete [] m_segments[i][j];
+    }
+
+    for(size_t i=0; i<m_deflaters.size(); ++i)
+        delete m_deflaters[i];
+}
+
+
+//
+//
+//
+size_t StreamPool::segment_size(int size_class)
+{
+    JAG_PRECONDITION(size_class >= 0 && size_class < NUM_SEGMENT_CLASSES);
+    return static_cast<size_t>(MIN_SEGMENT_SIZE) << size_class;
+}
+
+
+//
+// Retrieves an idle segment of the given class or allocates a new one.
+//
+Byte* StreamPool::acquire_segment(int size_class)
+{
+    {
+        ScopedLock lock(m_mutex);
+        std::vector<Byte*>& idle = m_segments[size_class];
+        if (!idle.empty())
+        {
+            Byte* segment = idle.back();
+            idle.pop_back();
+            m_idle_bytes -= segment_size(size_class);
+            ++m_stats.segments_reused;
+            return segment;
+        }
+        ++m_stats.segments_allocated;
+    }
+
+    return new Byte[segment_size(size_class)];
+}
+
+
+//
+// Keeps the segment for later use unless there is already too much idle
+// memory.
+//
+void StreamPool::release_segment(Byte* segment, int size_class)
+{
+    const size_t size = segment_size(size_class);
+    {
+        ScopedLock lock(m_mutex);
+        if (m_idle_bytes + size <= MAX_IDLE_SEGMENT_BYTES)
+        {
+            m_segments[size_class].push_back(segment);
+            m_idle_bytes += size;
+            return;
+        }
+    }
+
+    delete [] segment;
+}
+
+
+//
+// Creates a deflate filter writing to 'stream', an idle filter with the same
+// parameters is reset and used if available.
+//
+std::auto_ptr<ISeqStreamOutputControl>
+StreamPool::create_deflate(ISeqStreamOutput& stream, DeflateParams const& params)
+{
+    {
+        ScopedLock lock(m_mutex);
+        for(size_t i=m_deflaters.size(); i--; )
+        {
+            ZLibStreamOutput* deflater = m_deflaters[i];
+            if (deflater->params().level == params.level &&
+                deflater->params().strategy == params.strategy)
+            {
+                std::auto_ptr<ISeqStreamOutputControl> result(deflater);
+                m_deflaters.erase(m_deflaters.begin() + i);
+                deflater->reset(stream);
+                ++m_stats.deflaters_reused;
+                return result;
+            }
+        }
+        ++m_stats.deflaters_created;
+    }
+
+    return create_deflate_stream(stream, params);
+}
+
+
+//
+// Takes a filter created by create_deflate(). Only closed filters are kept,
+// the others are destroyed right away as their destructor still writes to
+// the underlying stream.
+//
+void StreamPool::recycle_deflate(std::auto_ptr<ISeqStreamOutputControl> deflater)
+{
+    if (!m_reuse_deflaters || !deflater.get())
+        return;
+
+    ZLibStreamOutput* zlib = checked_static_cast<ZLibStreamOutput*>(deflater.get());
+    if (!zlib->is_closed())
+        return;
+
+    ScopedLock lock(m_mutex);
+    if (m_deflaters.size() < MAX_IDLE_DEFLATERS)
+    {
+        m_deflaters.push_back(zlib);
+        deflater.release();
+    }
+}
+
+
+//
+//
+//
+StreamPoolStats StreamPool::stats() const
+{
+    ScopedLock lock(m_mutex);
+    return m_stats;
+}
+
+
+
+//////////////////////////////////////////////////////////////////////////
+// SegmentedStreamOutput
+//////////////////////////////////////////////////////////////////////////
+SegmentedStreamOutput::SegmentedStreamOutput(boost::shared_ptr<StreamPool> const& pool)
+    : m_pool(pool)
+    , m_bytes_written(0)
+    , m_available(0)
+{
+    JAG_PRECONDITION(m_pool);
+}
+
+
+//
+//
+//
+SegmentedStreamOutput::~SegmentedStreamOutput()
+{
+    close();
+}
+
+
+//
+//
+//
+void SegmentedStreamOutput::write(void const* data, ULong size)
+{
+    Byte const* src = static_cast<Byte const*>(data);
+    while (size)
+    {
+        if (!m_available)
+            add_segment();
+
+        const size_t seg_size = StreamPool::segment_size(segment_class(m_segments.size()-1));
+        const size_t len = static_cast<size_t>(min<ULong>(size, m_available));
+        memcpy(m_segments.back() + seg_size - m_available, src, len);
+        m_available -= len;
+        m_bytes_written += len;
+        src += len;
+        size -= len;
+    }
+}
+
+
+//
+//
+//
+void SegmentedStreamOutput::add_segment()
+{
+    const int size_class = segment_class(m_segments.size());
+    Byte* segment = m_pool->acquire_segment(size_class);
+    try
+    {
+        m_segments.push_back(segment);
+    }
+    catch(...)
+    {
+        m_pool->release_segment(segment, size_class);
+        throw;
+    }
+    m_available = StreamPool::segment_size(size_class);
+}
+
+
+//
+//
+//
+ULong SegmentedStreamOutput::tell() const
+{
+    return m_bytes_written;
+}
+
+
+//
+// Returns the segments to the pool, the stream is empty afterwards.
+//
+void SegmentedStreamOutput::close()
+{
+    for(size_t i=0; i<m_segments.size(); ++i)
+        m_pool->release_segment(m_segments[i], segment_class(i));
+
+    m_segments.clear();
+    m_bytes_written = 0;
+    m_available = 0;
+}
+
+
+//
+//
+//
+int SegmentedStreamOutput::num_segments() const
+{
+    return static_cast<int>(m_segments.size());
+}
+
+
+//
+//
+//
+Byte const* SegmentedStreamOutput::segment(int index) const
+{
+    JAG_PRECONDITION(index >= 0 && index < num_segments());
+    return m_segments[index];
+}
+
+
+//
+// Number of bytes written to the given segment.
+//
+ULong SegmentedStreamOutput::segment_length(int index) const
+{
+    JAG_PRECONDITION(index >= 0 && index < num_segments());
+    const size_t seg_size = StreamPool::segment_size(segment_class(index));
+    return index == num_segments()-1
+        ? seg_size - m_available
+        : seg_size;
+}
+
+}} // namespace jag::jstd
+
+/** EOF @file */
@@ -0,0 +1,94 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+
+#include "precompiled.h"
+#include <core/jstd/threadpool.h>
+#include <core/generic/assert.h>
+#include <boost/bind.hpp>
+
+namespace jag {
+namespace jstd {
+
+//
+//
+//
+ThreadPool::ThreadPool(int num_threads)
+    : m_stopping(false)
+{
+    JAG_PRECONDITION(num_threads > 0);
+    m_threads.reserve(num_threads);
+    for(int i=0; i<num_threads; ++i)
+        m_threads.push_back(new Thread(boost::bind(&ThreadPool::worker, this)));
+}
+
+
+//
+// Finishes the pending tasks and joins the worker threads.
+//
+ThreadPool::~ThreadPool()
+{
+    {
+        ScopedLock lock(m_mutex);
+        m_stopping = true;
+    }
+    m_task_available.notify_all();
+
+    for(size_t i=0; i<m_threads.size(); ++i)
+        m_threads[i].join();
+}
+
+
+//
+//
+//
+void ThreadPool::submit(task_t const& task)
+{
+    {
+        ScopedLock lock(m_mutex);
+        JAG_PRECONDITION(!m_stopping);
+        m_tasks.push_back(task);
+    }
+    m_task_available.notify_one();
+}
+
+
+//
+//
+//
+int ThreadPool::num_threads() const
+{
+    return static_cast<int>(m_threads.size());
+}
+
+
+//
+// Worker thread loop.
+//
+void ThreadPool::worker()
+{
+    for(;;)
+    {
+        task_t task;
+        {
+            ScopedLock lock(m_mutex);
+            while (m_tasks.empty() && !m_stopping)
+                m_task_available.wait(m_mutex);
+
+            if (m_tasks.empty())
+                return;
+
+            task.swap(m_tasks.front());
+            m_tasks.pop_front();
+        }
+
+        task();
+    }
+}
+
+}} // namespace jag::jstd
+
+/** EOF @file */
@@ -14,6 +14,7 @@
 #include <core/jstd/encodinghelpers.h>
 #include <unicode/ustring.h>
 #include <boost/static_assert.hpp>
+#include <string.h>
 
 namespace jag {
 namespace jstd {
@@ -44,6 +45,117 @@ char const* get_canonical_converter_name(Char const* enc)
 }
 
 
+namespace
+{
+  // ASCII characters are recognized a machine word at a time
+  typedef size_t Word;
+  const Word WORD_HIGH_BITS = ~Word(0) / 255 * 0x80;
+} // anonymous namespace
+
+
+//
+// See Table 3-7 'Well-Formed UTF-8 Byte Sequences' of The Unicode Standard.
+//
+Int utf8_next_code_point(Char const** source, Char const* end)
+{
+    Byte const* curr = reinterpret_cast<Byte const*>(*source);
+    JAG_PRECONDITION(*source < end);
+
+    UInt code_point = *curr;
+    if (code_point < 0x80)
+    {
+        ++*source;
+        return static_cast<Int>(code_point);
+    }
+
+    int length;
+    UInt min_code_point;
+    if (code_point < 0xc2)
+    {
+        // a continuation byte or an overlong two byte sequence
+        return -1;
+    }
+    else if (code_point < 0xe0)
+    {
+        length = 2;
+        code_point &= 0x1f;
+        min_code_point = 0x80;
+    }
+    else if (code_point < 0xf0)
+    {
+        length = 3;
+        code_point &= 0x0f;
+        min_code_point = 0x800;
+    }
+    else if (code_point < 0xf5)
+    {
+        length = 4;
+        code_point &= 0x07;
+        min_code_point = 0x10000;
+    }
+    else
+    {
+        return -1;
+    }
+
+    if (end - *source < length)
+        return -1;
+
+    for(int i=1; i<length; ++i)
+    {
+        if ((curr[i] & 0xc0) != 0x80)
+            return -1;
+
+        code_point = (code_point << 6) | (curr[i] & 0x3f);
+    }
+
+    if (code_point < min_code_point
+        || code_point > 0x10ffff
+        || (code_point >= 0xd800 && code_point <= 0xdfff))
+    {
+        return -1;
+    }
+
+    *source += length;
+    return static_cast<Int>(code_point);
+}
+
+
+//
+//
+//
+Char const* utf8_to_code_points(Char const* begin, Char const* end,
+                                std::vector<Int>& code_points)
+{
+    while(begin != end)
+    {
+        Word w;
+        while(static_cast<size_t>(end - begin) >= sizeof(Word))
+        {
+            memcpy(&w, begin, sizeof(Word));
+            if (w & WORD_HIGH_BITS)
+                break;
+
+            for(size_t i=0; i<sizeof(Word); ++i)
+                code_points.push_back(begin[i]);
+
+            begin += sizeof(Word);
+        }
+
+        if (begin == end)
+            break;
+
+        const Int code_point = utf8_next_code_point(&begin, end);
+        if (code_point < 0)
+            break;
+
+        code_points.push_back(code_point);
+    }
+
+    return begin;
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 UnicodeConverter::UnicodeConverter(Char const* encoding)
 {
@@ -52,6 +164,7 @@ UnicodeConverter::UnicodeConverter(Char const* encoding)
     m_converter = ucnv_open(encoding, &err);
     CHECK_ICU(err);
     JAG_POSTCONDITION(m_converter);
+    m_utf8 = UCNV_UTF8 == ucnv_getType(m_converter);
 }
 
 
@@ -70,6 +183,7 @@ UnicodeConverter::UnicodeConverter(UConverter const* other)
     m_converter = ucnv_safeClone(other, 0, 0, &err);
     CHECK_ICU(err);
     JAG_POSTCONDITION(m_converter);
+    m_utf8 = UCNV_UTF8 == ucnv_getType(m_converter);
 }
 
 
@@ -88,6 +202,39 @@ void UnicodeConverter::reset()
 
 //////////////////////////////////////////////////////////////////////////
 Int UnicodeConverter::next_code_point(Char const** source, Char const* end)
+{
+    if (m_utf8)
+    {
+        const Int code_point = utf8_next_code_point(source, end);
+        if (code_point >= 0)
+            return code_point;
+    }
+
+    // ill-formed UTF-8 is handled by ICU to keep its substitution behavior
+    return icu_next_code_point(source, end);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void UnicodeConverter::code_points(Char const* begin, Char const* end,
+                                   std::vector<Int>& result)
+{
+    while(begin != end)
+    {
+        if (m_utf8)
+        {
+            begin = utf8_to_code_points(begin, end, result);
+            if (begin == end)
+                break;
+        }
+
+        result.push_back(icu_next_code_point(&begin, end));
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+Int UnicodeConverter::icu_next_code_point(Char const** source, Char const* end)
 {
     UErrorCode err = U_ZERO_ERROR;
     Int result = ucnv_getNextUChar(m_converter, source, end, &err);
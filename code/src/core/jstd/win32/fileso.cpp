@@ -278,6 +278,28 @@ boost::uintmax_t file_size(Char const* path)
 }
 
 
+//
+//
+//
+boost::uintmax_t file_mtime(Char const* path)
+{
+    WIN32_FILE_ATTRIBUTE_DATA finfo;
+    if (!::GetFileAttributesExW(FromUTF8(path).to_utf16(),
+                                ::GetFileExInfoStandard,
+                                &finfo))
+    {
+        throw exception_io_error(msg_cannot_get_filetime())
+            << JAGLOC
+            << io_object_info(path)
+            << win_error_info(::GetLastError());
+    }
+
+    return (static_cast<boost::uintmax_t>(finfo.ftLastWriteTime.dwHighDateTime)
+        << (sizeof(finfo.ftLastWriteTime.dwLowDateTime)*8))
+        + finfo.ftLastWriteTime.dwLowDateTime;
+}
+
+
   
 
 }} // namespace jag::jstd
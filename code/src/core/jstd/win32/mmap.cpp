@@ -212,6 +212,79 @@ MMapFileStreamOutput::~MMapFileStreamOutput()
 }
 
 
+//////////////////////////////////////////////////////////////////////////
+// MMapFileView
+//////////////////////////////////////////////////////////////////////////
+MMapFileView::MMapFileView(char const* fname)
+    : m_base_ptr(0)
+    , m_size(0)
+{
+    HANDLE hfile = ::CreateFileW(FromUTF8(fname).to_utf16(),
+                                 GENERIC_READ,
+                                 FILE_SHARE_READ,
+                                 0,
+                                 OPEN_EXISTING,
+                                 FILE_ATTRIBUTE_NORMAL|FILE_FLAG_SEQUENTIAL_SCAN,
+                                 NULL);
+
+    if (hfile == INVALID_HANDLE_VALUE)
+    {
+        throw exception_io_error(msg_cannot_open_file())
+            << win_error_info(::GetLastError())
+            << io_object_info(fname)
+            << JAGLOC;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!::GetFileSizeEx(hfile, &file_size))
+    {
+        const DWORD err = ::GetLastError();
+        ::CloseHandle(hfile);
+        throw exception_io_error(msg_cannot_get_filesize())
+            << win_error_info(err)
+            << io_object_info(fname)
+            << JAGLOC;
+    }
+
+    m_size = static_cast<ULong>(file_size.QuadPart);
+    if (m_size)
+    {
+        // the view keeps the mapping object and the file open
+        HANDLE hmmfile = ::CreateFileMapping(hfile, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (hmmfile)
+        {
+            m_base_ptr = static_cast<Byte*>(
+                ::MapViewOfFile(hmmfile, FILE_MAP_READ, 0, 0, 0));
+        }
+
+        const DWORD err = ::GetLastError();
+        if (hmmfile)
+            ::CloseHandle(hmmfile);
+
+        if (!m_base_ptr)
+        {
+            ::CloseHandle(hfile);
+            throw exception_io_error(msg_cannot_mmap_file())
+                << win_error_info(err)
+                << io_object_info(fname)
+                << JAGLOC;
+        }
+    }
+
+    ::CloseHandle(hfile);
+}
+
+
+//
+//
+//
+MMapFileView::~MMapFileView()
+{
+    if (m_base_ptr && !::UnmapViewOfFile(m_base_ptr))
+        JAG_ASSERT(!"UnmapViewOfFile() failed");
+}
+
+
 }} // namespace jag::jstd
 
 /** EOF @file */
@@ -80,6 +80,114 @@ void Thread::join()
 //
 
 
+//
+// Mutex & Condition
+//
+Mutex::Mutex()
+{
+    ::InitializeCriticalSection(&m_mutex);
+}
+
+Mutex::~Mutex()
+{
+    ::DeleteCriticalSection(&m_mutex);
+}
+
+void Mutex::lock()
+{
+    ::EnterCriticalSection(&m_mutex);
+}
+
+void Mutex::unlock()
+{
+    ::LeaveCriticalSection(&m_mutex);
+}
+
+
+#ifdef JAG_WIN32_CONDITION_VARIABLE
+
+Condition::Condition()
+{
+    ::InitializeConditionVariable(&m_cond);
+}
+
+Condition::~Condition()
+{
+}
+
+void Condition::wait(Mutex& mutex)
+{
+    ::SleepConditionVariableCS(&m_cond, &mutex.m_mutex, INFINITE);
+}
+
+void Condition::notify_one()
+{
+    ::WakeConditionVariable(&m_cond);
+}
+
+void Condition::notify_all()
+{
+    ::WakeAllConditionVariable(&m_cond);
+}
+
+#else
+
+Condition::Condition()
+{
+    ::InitializeCriticalSection(&m_waiters_lock);
+}
+
+Condition::~Condition()
+{
+    JAG_ASSERT(m_waiters.empty());
+    ::DeleteCriticalSection(&m_waiters_lock);
+}
+
+//
+// The event is queued before the mutex is released, so a notification sent
+// once the mutex is released cannot be missed. A notified waiter is removed
+// from the queue, so a later waiter cannot take its notification.
+//
+void Condition::wait(Mutex& mutex)
+{
+    HANDLE event = ::CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (!event)
+        throw std::runtime_error("event creation failed");
+
+    ::EnterCriticalSection(&m_waiters_lock);
+    m_waiters.push_back(event);
+    ::LeaveCriticalSection(&m_waiters_lock);
+
+    mutex.unlock();
+    ::WaitForSingleObject(event, INFINITE);
+    mutex.lock();
+    ::CloseHandle(event);
+}
+
+void Condition::notify_one()
+{
+    ::EnterCriticalSection(&m_waiters_lock);
+    if (!m_waiters.empty())
+    {
+        ::SetEvent(m_waiters.front());
+        m_waiters.pop_front();
+    }
+    ::LeaveCriticalSection(&m_waiters_lock);
+}
+
+void Condition::notify_all()
+{
+    ::EnterCriticalSection(&m_waiters_lock);
+    for(size_t i=0; i<m_waiters.size(); ++i)
+        ::SetEvent(m_waiters[i]);
+    m_waiters.clear();
+    ::LeaveCriticalSection(&m_waiters_lock);
+}
+
+#endif
+
+
+
 void scheduled_yield()
 {
     ::Sleep(0);
@@ -8,32 +8,134 @@
 #include "precompiled.h"
 #include <interfaces/stdtypes.h>
 #include <core/jstd/zlib_stream.h>
+#include <core/jstd/threadpool.h>
+#include <interfaces/configinternal.h>
 #include <core/errlib/errlib.h>
 #include <core/generic/minmax.h>
 #include <core/generic/null_deleter.h>
 #include <core/generic/assert.h>
+#include <boost/bind.hpp>
 #include <algorithm>
 
 namespace jag {
 namespace jstd {
 
+namespace
+{
+  int zlib_strategy(DeflateStrategy strategy)
+  {
+      switch(strategy)
+      {
+      case DEFLATE_DEFAULT:       return Z_DEFAULT_STRATEGY;
+      case DEFLATE_FILTERED:      return Z_FILTERED;
+      case DEFLATE_HUFFMAN_ONLY:  return Z_HUFFMAN_ONLY;
+      case DEFLATE_RLE:           return Z_RLE;
+      }
+
+      JAG_INTERNAL_ERROR;
+  }
+
+  DeflateStreamFactory g_deflate_stream_factory = create_zlib_deflate_stream;
+
+} // anonymous namespace
+
+
+//
+//
+//
+DeflateStreamFactory set_deflate_stream_factory(DeflateStreamFactory factory)
+{
+    JAG_PRECONDITION(factory);
+    DeflateStreamFactory previous = g_deflate_stream_factory;
+    g_deflate_stream_factory = factory;
+    return previous;
+}
+
+
+//
+//
+//
+DeflateStreamFactory deflate_stream_factory()
+{
+    return g_deflate_stream_factory;
+}
+
+
+//
+//
+//
+std::auto_ptr<ISeqStreamOutputControl>
+create_deflate_stream(ISeqStreamOutput& stream, DeflateParams const& params)
+{
+    return g_deflate_stream_factory(stream, params);
+}
+
+
+//
+//
+//
+std::auto_ptr<ISeqStreamOutputControl>
+create_zlib_deflate_stream(ISeqStreamOutput& stream, DeflateParams const& params)
+{
+    return std::auto_ptr<ISeqStreamOutputControl>(
+        new ZLibStreamOutput(stream, params));
+}
+
+
+/**
+ * @brief reads compression settings of a stream class
+ *
+ * @param cfg        document configuration
+ * @param level_key  compression level option, 0-9
+ * @param strategy_key  deflate strategy option
+ */
+DeflateParams deflate_params_from_config(IProfileInternal const& cfg,
+                                         char const* level_key,
+                                         char const* strategy_key)
+{
+    const int level = cfg.get_int(level_key);
+    if (level < 0 || level > 9)
+        throw exception_invalid_value(msg_option_out_of_range(level_key)) << JAGLOC;
+
+    struct Strategy { char const* name; DeflateStrategy value; };
+    static const Strategy strategies[] = {
+        { "default",  DEFLATE_DEFAULT },
+        { "filtered", DEFLATE_FILTERED },
+        { "huffman",  DEFLATE_HUFFMAN_ONLY },
+        { "rle",      DEFLATE_RLE }
+    };
+
+    char const* strategy = cfg.get(strategy_key);
+    for(size_t i=0; i<sizeof(strategies)/sizeof(strategies[0]); ++i)
+    {
+        if (!strcmp(strategy, strategies[i].name))
+            return DeflateParams(level, strategies[i].value);
+    }
+
+    throw exception_invalid_value(msg_option_out_of_range(strategy_key)) << JAGLOC;
+}
+
+
+
 /**
  * @brief initializes zlib output filter
  *
  * @param stream stream to write
- * @param compression_level compression level
+ * @param params compression level and strategy
  *
  * @exception exception_zlib_deflate_init_failed if zlib initialization failed
  */
-ZLibStreamOutput::ZLibStreamOutput(ISeqStreamOutput& stream, int compression_level)
-    : m_stream(stream)
+ZLibStreamOutput::ZLibStreamOutput(ISeqStreamOutput& stream, DeflateParams const& params)
+    : m_stream(&stream)
+    , m_params(params)
     , m_position(0)
     , m_closed(false)
 {
     m_strm.zalloc = Z_NULL;
     m_strm.zfree = Z_NULL;
     m_strm.opaque = Z_NULL;
-    int ret = deflateInit(&m_strm, compression_level);
+    int ret = deflateInit2(&m_strm, params.level, Z_DEFLATED, MAX_WBITS,
+                           8, zlib_strategy(params.strategy));
     if (ret != Z_OK)
         throw exception_io_error(msg_zlib_deflate_init_failed()) << JAGLOC;
 }
@@ -42,7 +144,7 @@ ZLibStreamOutput::ZLibStreamOutput(ISeqStreamOutput& stream, int compression_lev
 /**
  * @brief dtor
  *
- * closes the stream (if still opened)
+ * closes the stream (if still opened) and releases the zlib structures
  */
 ZLibStreamOutput::~ZLibStreamOutput()
 {
@@ -54,6 +156,7 @@ ZLibStreamOutput::~ZLibStreamOutput()
     {
         // can't do much here
     }
+    deflateEnd(&m_strm);
 }
 
 
@@ -85,9 +188,12 @@ ULong ZLibStreamOutput::tell() const
 
 
 /**
- *  @brief closes the zlib encoder
+ *  @brief finishes the zlib stream
+ *
+ *  The zlib structures are kept until the filter is destroyed so that the
+ *  filter can be reset() and used for another stream.
  *
- *  @exception exception_zlib_deflate_failed, exception_zlib_deflate_end
+ *  @exception exception_zlib_deflate_failed
  */
 void ZLibStreamOutput::close()
 {
@@ -98,20 +204,27 @@ void ZLibStreamOutput::close()
     m_strm.next_in = Z_NULL;
     m_closed = true;
 
-    // first, finish the zlib stream and cleanup zlib internal structures
-    // error handling is done afterwards, as we need to ensure that deflateEnd()
-    // was invoked
-    int deflate_ret_val = Z_STREAM_END;
-    if (m_strm.total_in)
-        deflate_ret_val = DeflateBuffer(Z_FINISH);
+    if (m_strm.total_in && Z_STREAM_END != DeflateBuffer(Z_FINISH))
+        throw exception_io_error(msg_zlib_deflate_failed()) << JAGLOC;
+}
 
-    int deflate_end_ret_val = deflateEnd(&m_strm);
 
-    if (Z_STREAM_END != deflate_ret_val)
-        throw exception_io_error(msg_zlib_deflate_failed()) << JAGLOC;
+/**
+ * @brief starts a new zlib stream written to 'stream'
+ *
+ * The compression parameters are retained. The filter must be closed.
+ *
+ * @exception exception_zlib_deflate_init_failed
+ */
+void ZLibStreamOutput::reset(ISeqStreamOutput& stream)
+{
+    JAG_PRECONDITION(m_closed);
+    if (Z_OK != deflateReset(&m_strm))
+        throw exception_io_error(msg_zlib_deflate_init_failed()) << JAGLOC;
 
-    if (Z_OK != deflate_end_ret_val)
-        throw exception_io_error(msg_zlib_deflate_end()) << JAGLOC;
+    m_stream = &stream;
+    m_position = 0;
+    m_closed = false;
 }
 
 void ZLibStreamOutput::flush()
@@ -120,7 +233,7 @@ void ZLibStreamOutput::flush()
     m_strm.next_in = Z_NULL;
     DeflateBuffer(Z_SYNC_FLUSH);
 
-    m_stream.flush();
+    m_stream->flush();
 }
 
 int ZLibStreamOutput::DeflateBuffer(int flush_type)
@@ -138,7 +251,7 @@ int ZLibStreamOutput::DeflateBuffer(int flush_type)
 
         int have = CHUNK_SIZE - m_strm.avail_out;
         if (have)
-            m_stream.write(out, have);
+            m_stream->write(out, have);
     }
     while(m_strm.avail_out == 0);
 
@@ -147,6 +260,222 @@ int ZLibStreamOutput::DeflateBuffer(int flush_type)
 
 
 
+/**
+ * @brief initializes pooled zlib output filter
+ *
+ * @param stream stream to write, accessed from worker threads
+ * @param pool thread pool performing the compression
+ * @param params compression level and strategy
+ */
+PooledZLibStreamOutput::PooledZLibStreamOutput(ISeqStreamOutput& stream,
+                                               ThreadPool& pool,
+                                               DeflateParams const& params)
+    : m_pool(pool)
+    , m_deflater(create_deflate_stream(stream, params))
+    , m_position(0)
+    , m_closed(false)
+    , m_scheduled(false)
+    , m_failed(false)
+{
+}
+
+
+/**
+ * @brief initializes pooled zlib output filter
+ *
+ * @param deflater filter performing the compression, accessed from worker
+ *                 threads
+ * @param pool thread pool performing the compression
+ */
+PooledZLibStreamOutput::PooledZLibStreamOutput(std::auto_ptr<ISeqStreamOutputControl> deflater,
+                                               ThreadPool& pool)
+    : m_pool(pool)
+    , m_deflater(deflater)
+    , m_position(0)
+    , m_closed(false)
+    , m_scheduled(false)
+    , m_failed(false)
+{
+}
+
+
+/**
+ * @brief dtor
+ *
+ * closes the stream (if still opened)
+ */
+PooledZLibStreamOutput::~PooledZLibStreamOutput()
+{
+    try
+    {
+        close();
+    }
+    catch(std::exception&)
+    {
+        // can't do much here
+    }
+}
+
+
+/**
+ * @brief hands over the underlying deflate filter
+ *
+ * The filter must be closed, so no worker thread accesses the deflater.
+ */
+std::auto_ptr<ISeqStreamOutputControl> PooledZLibStreamOutput::release_deflater()
+{
+    JAG_PRECONDITION(m_closed);
+    return m_deflater;
+}
+
+
+/**
+ * @brief buffers the data, full chunks are sent to the pool
+ */
+void PooledZLibStreamOutput::write(void const* data, ULong size)
+{
+    if (size)
+    {
+        m_position += size;
+        char const* bytes = static_cast<char const*>(data);
+        m_pending.insert(m_pending.end(), bytes, bytes + size);
+        if (m_pending.size() >= CHUNK_SIZE)
+            submit(OP_WRITE);
+    }
+}
+
+
+/**
+ *  @return number of written bytes
+ */
+ULong PooledZLibStreamOutput::tell() const
+{
+    return m_position;
+}
+
+
+/**
+ * @brief flushes the encoder, waits until the data reach the stream
+ */
+void PooledZLibStreamOutput::flush()
+{
+    submit(OP_FLUSH);
+    wait_idle();
+    check_failure();
+}
+
+
+/**
+ * @brief finishes the zlib stream, waits until the data reach the stream
+ *
+ * @exception exception_zlib_deflate_failed
+ */
+void PooledZLibStreamOutput::close()
+{
+    if (m_closed)
+        return;
+
+    m_closed = true;
+    submit(OP_CLOSE);
+    wait_idle();
+    check_failure();
+}
+
+
+//
+// Moves the pending data to the queue and makes sure that the queue is being
+// processed. Blocks if too many chunks are waiting.
+//
+void PooledZLibStreamOutput::submit(Operation op)
+{
+    ScopedLock lock(m_mutex);
+    while (m_queue.size() >= MAX_QUEUED_CHUNKS)
+        m_idle.wait(m_mutex);
+
+    m_queue.push_back(Chunk());
+    m_queue.back().op = op;
+    m_queue.back().data.swap(m_pending);
+    m_pending.reserve(CHUNK_SIZE);
+
+    if (!m_scheduled)
+    {
+        m_scheduled = true;
+        m_pool.submit(boost::bind(&PooledZLibStreamOutput::deflate_queued, this));
+    }
+}
+
+
+//
+//
+//
+void PooledZLibStreamOutput::wait_idle()
+{
+    ScopedLock lock(m_mutex);
+    while (m_scheduled)
+        m_idle.wait(m_mutex);
+}
+
+
+//
+//
+//
+void PooledZLibStreamOutput::check_failure()
+{
+    ScopedLock lock(m_mutex);
+    if (m_failed)
+        throw exception_io_error(msg_zlib_deflate_failed()) << JAGLOC;
+}
+
+
+//
+// Runs on a worker thread. Only one instance per stream is scheduled at a
+// time so the chunks are deflated sequentially.
+//
+void PooledZLibStreamOutput::deflate_queued()
+{
+    for(;;)
+    {
+        Chunk chunk;
+        bool failed;
+        {
+            ScopedLock lock(m_mutex);
+            if (m_queue.empty())
+            {
+                m_scheduled = false;
+                m_idle.notify_all();
+                return;
+            }
+
+            chunk.op = m_queue.front().op;
+            chunk.data.swap(m_queue.front().data);
+            m_queue.pop_front();
+            failed = m_failed;
+            m_idle.notify_all();
+        }
+
+        if (failed)
+            continue;
+
+        try
+        {
+            if (!chunk.data.empty())
+                m_deflater->write(&chunk.data[0], chunk.data.size());
+
+            if (chunk.op == OP_FLUSH)
+                m_deflater->flush();
+            else if (chunk.op == OP_CLOSE)
+                m_deflater->close();
+        }
+        catch(std::exception&)
+        {
+            ScopedLock lock(m_mutex);
+            m_failed = true;
+        }
+    }
+}
+
+
+
 /**
  * @brief ctor, initializes zlib input filter
  *
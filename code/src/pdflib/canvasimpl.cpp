@@ -315,6 +315,69 @@ void CanvasImpl::circle(Double x, Double y, Double radius)
     bezier_to(x-length, y-radius, x-radius, y-length, x-radius, y);
 }
 
+//////////////////////////////////////////////////////////////////////////
+void CanvasImpl::polyline(Double const* coords, UInt length)
+{
+    if (!length || length % 2)
+        throw exception_invalid_value(msg_invalid_argument()) << JAGLOC;
+
+    move_to(coords[0], coords[1]);
+    for(UInt i=2; i<length; i+=2)
+        m_fmt.output(coords[i]).space().output(coords[i+1]).graphics_op(OP_l);
+
+    m_path_end_x = coords[length-2];
+    m_path_end_y = coords[length-1];
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CanvasImpl::polygon(Double const* coords, UInt length)
+{
+    polyline(coords, length);
+    path_close();
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CanvasImpl::beziers(Double const* coords, UInt length)
+{
+    if (!length || length % 6)
+        throw exception_invalid_value(msg_invalid_argument()) << JAGLOC;
+
+    for(UInt i=0; i<length; i+=6)
+    {
+        m_fmt
+            .output(coords[i]).space()
+            .output(coords[i+1]).space()
+            .output(coords[i+2]).space()
+            .output(coords[i+3]).space()
+            .output(coords[i+4]).space()
+            .output(coords[i+5]).graphics_op(OP_c)
+            ;
+    }
+
+    m_path_end_x = coords[length-2];
+    m_path_end_y = coords[length-1];
+}
+
+//////////////////////////////////////////////////////////////////////////
+void CanvasImpl::rectangles(Double const* coords, UInt length)
+{
+    if (!length || length % 4)
+        throw exception_invalid_value(msg_invalid_argument()) << JAGLOC;
+
+    start_path_construction();
+    for(UInt i=0; i<length; i+=4)
+    {
+        m_fmt
+            .output(coords[i]).space()
+            .output(coords[i+1]).space()
+            .output(coords[i+2]).space()
+            .output(coords[i+3]).graphics_op(OP_re);
+    }
+
+    m_path_start_x = m_path_end_x = coords[length-4];
+    m_path_start_y = m_path_end_y = coords[length-3];
+}
+
 //////////////////////////////////////////////////////////////////////////
 void CanvasImpl::path_close()
 {
@@ -78,6 +78,10 @@ public: //ICanvas
              Double start_angle, Double sweep_angle);
     void arc_to(Double x, Double y, Double rx, Double ry,
                 Double angle, Int large_arc_flag, Int sweep_flag);
+    void polyline(Double const* coords, UInt length);
+    void polygon(Double const* coords, UInt length);
+    void beziers(Double const* coords, UInt length);
+    void rectangles(Double const* coords, UInt length);
     void path_paint(Char const* cmd);
 
 
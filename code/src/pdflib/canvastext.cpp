@@ -18,13 +18,10 @@
 #include <core/jstd/unicode.h>
 #include <core/generic/stringutils.h>
 #include <core/jstd/icumain.h>
-#include <interfaces/configinternal.h>
-#include <interfaces/execcontext.h>
 #include <boost/bind.hpp>
 #include <boost/ref.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <core/generic/checked_cast.h>
-#include <pdflib/cfgsymbols.h>
 
 using namespace jag::jstd;
 using namespace boost;
@@ -217,29 +214,39 @@ namespace
   ///
   /// Outputs a text written in a simple font.
   ///
-  /// If the text has a different encoding (txt_enc) than the font the text is
+  /// If the text has a different encoding than the font the text is
   /// re-encoded. Also outputs glyph offsets (if any supplied).
   ///
   void output_simple_font_text(PDFFont const&font,
                                ObjFmtBasic& writer,
                                Char const* start, Char const* end,
                                offsets_info_t const* offsets,
-                               char const* txt_enc,
-                               IExecContext const& exec_ctx)
+                               DocWriterImpl const& doc)
   {
       std::vector<Char> chars;
+      TextOptions const& opts = doc.text_options();
 
-      if (!is_empty(txt_enc))
+      if (opts.encoding)
       {
           // text encoding --> font encoding if they are different
-          char const* txt_enc_canon = get_canonical_converter_name(txt_enc);
-          if (strcmp(txt_enc_canon, font.font()->encoding_canonical()))
+          if (strcmp(opts.encoding, font.font()->encoding_canonical()))
           {
               std::vector<UChar> uchars;
-              to_unicode(txt_enc, start, end, uchars);
+              {
+                  UnicodeConverter* cnv(doc.acquire_text_converter());
+                  ON_BLOCK_EXIT_OBJ(doc, &DocWriterImpl::release_text_converter);
+                  to_unicode(cnv->conv_internal(), start, end, uchars);
+              }
               JAG_ASSERT(! uchars.empty());
-              from_unicode(font.font()->encoding_canonical(),
-                           &uchars[0], &uchars[0]+uchars.size(), chars);
+              {
+                  // the font dictionary caches a converter of the font encoding
+                  FontDictionary const& dict(font.font_dict());
+                  UnicodeConverter* cnv(dict.acquire_converter());
+                  JAG_ASSERT(cnv);
+                  ON_BLOCK_EXIT_OBJ(dict, &FontDictionary::release_converter);
+                  from_unicode(cnv->conv_internal(),
+                               &uchars[0], &uchars[0]+uchars.size(), chars);
+              }
 
               start=&chars[0];
               end=start+chars.size();
@@ -249,7 +256,7 @@ namespace
       font.font_dict().use_char8(start, end);
 
       KerningOffsets kerns;
-      if (exec_ctx.config().get_int("text.kerning"))
+      if (opts.kerning)
       {
           process_kerns(start, end - start,
                         bind(&IFontEx::kerning_for_chars, font.font(), _1, _2),
@@ -285,10 +292,10 @@ namespace
                             ObjFmtBasic& writer,
                             UInt16 const* gids, int ngids,
                             offsets_info_t const* offsets,
-                            IExecContext const& exec_ctx)
+                            TextOptions const& opts)
   {
       KerningOffsets kerns;
-      if (exec_ctx.config().get_int("text.kerning"))
+      if (opts.kerning)
       {
           process_kerns(gids, ngids,
                         bind(&IFontEx::kerning_for_gids, font.font(), _1, _2),
@@ -316,38 +323,34 @@ namespace
   ///
   /// Outputs a text written in a composite font.
   ///
-  /// If the text has a different encoding (txt_enc) than the font the text is
+  /// If the text has a different encoding than the font the text is
   /// re-encoded. Also outputs glyph offsets (if any supplied).
   ///
   void output_cid_font_text(PDFFont const&font,
                             ObjFmtBasic& writer,
                             Char const* start, Char const* end,
                             offsets_info_t const* offsets,
-                            char const* txt_enc,
-                            IExecContext const& exec_ctx)
+                            DocWriterImpl const& doc)
   {
       // convert the input to unicode codepoints
       std::vector<Int> codepoints;
       codepoints.reserve(end-start);
 
-      if (is_empty(txt_enc))
+      if (!doc.text_options().encoding)
       {
           UnicodeConverter* cnv(font.acquire_converter());
           JAG_ASSERT(cnv);
-          while(start!=end)
-              codepoints.push_back(cnv->next_code_point(&start, end));
-
           ON_BLOCK_EXIT_OBJ(font, &PDFFont::release_converter);
+          cnv->code_points(start, end, codepoints);
       }
       else
       {
-          // Note: the converter is instantiated *always* even though it can be
-          // the same as the one provided by the font. However, cost of finding
-          // out whether they are the same is questionable as the encoding needs
-          // to be converted to a canonical form and string compared.
-          UnicodeConverter cnv(txt_enc);
-          while(start!=end)
-              codepoints.push_back(cnv.next_code_point(&start, end));
+          // Note: the text encoding converter is used *always* even though it
+          // can be the same as the one provided by the font.
+          UnicodeConverter* cnv(doc.acquire_text_converter());
+          JAG_ASSERT(cnv);
+          ON_BLOCK_EXIT_OBJ(doc, &DocWriterImpl::release_text_converter);
+          cnv->code_points(start, end, codepoints);
       }
 
 
@@ -359,7 +362,7 @@ namespace
                                        gids);
 
       output_cid_font_gids(font, writer, &gids[0], gids.size(),
-                           offsets, exec_ctx);
+                           offsets, doc.text_options());
   }
 
 
@@ -370,22 +373,21 @@ namespace
                             ObjFmtBasic& writer,
                             Char const* start, Char const* end,
                             offsets_info_t const* offsets,
-                            IExecContext const& exec_ctx)
+                            DocWriterImpl const& doc)
   {
       JAG_PRECONDITION(start<end);
-      char const* txt_enc = get_default_text_encoding(exec_ctx);
 
       if (PDFFontData::SIMPLE_FONT == font.font_dict().fdict_data().font_type())
       {
           output_simple_font_text(font, writer, start, end,
-                                  offsets, txt_enc, exec_ctx);
+                                  offsets, doc);
       }
       else
       {
           if (ENC_IDENTITY == font.font_dict().fdict_data().font_encoding())
           {
               output_cid_font_text(font, writer, start,
-                                   end, offsets, txt_enc, exec_ctx);
+                                   end, offsets, doc);
           }
           else
           {
@@ -490,7 +492,7 @@ void CanvasImpl::text_show_generic(Char const* start, Char const* end,
                           m_fmt,
                           start, end,
                           offsets_length ? &offsets_info : 0,
-                          m_doc_writer.exec_context());
+                          m_doc_writer);
 
     post_action();
 }
@@ -622,7 +624,7 @@ void CanvasImpl::text_glyphs_o(Double x, Double y,
     output_cid_font_gids(*font, m_fmt,
                          array_in, length,
                          offsets_length ? &offsets_info : 0,
-                         m_doc_writer.exec_context());
+                         m_doc_writer.text_options());
 
     m_fmt.graphics_op(OP_ET);
 }
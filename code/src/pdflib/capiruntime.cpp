@@ -8,6 +8,7 @@
 #include "precompiled.h"
 #include "capiruntime.h"
 #include <core/generic/assert.h>
+#include <core/errlib/errlib.h>
 #include <core/jstd/tss.h>
 #include <sstream>
 
@@ -75,6 +76,41 @@ void tls_set_error_info(exception const& exc)
     rec->m_err_code = exc.errcode();
 }
 
+
+//
+// Checks the handle of an object about to borrow client's data. The data
+// must be released even if the call fails, so they are released before
+// throwing if the handle is null.
+//
+void check_borrowing_handle(void const* handle, jag_datarelease const* release,
+                            void const* data)
+{
+    if (handle)
+        return;
+
+    if (release && release->release)
+        release->release(release->custom_data, data);
+
+    throw exception_invalid_value(msg_null_pointer()) << JAGLOC;
+}
+
+
+//
+// Checks the handle of an object about to take over client's source. The
+// source must be closed even if the call fails, so it is closed before
+// throwing if the handle is null.
+//
+void check_borrowing_handle(void const* handle, jag_streamin const* source)
+{
+    if (handle)
+        return;
+
+    if (source && source->close)
+        source->close(source->custom_data);
+
+    throw exception_invalid_value(msg_null_pointer()) << JAGLOC;
+}
+
 } // namespace jag
 
 
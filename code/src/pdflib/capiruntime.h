@@ -35,6 +35,9 @@ namespace jag {
 
 
 void tls_set_error_info(exception const& exc);
+void check_borrowing_handle(void const* handle, jag_datarelease const* release,
+                            void const* data);
+void check_borrowing_handle(void const* handle, jag_streamin const* source);
 
 
 //
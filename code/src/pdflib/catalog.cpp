@@ -32,6 +32,9 @@ namespace pdf {
 
 namespace
 {
+  // minimum degree of the page tree, a page tree node has at most 2*t kids
+  const int PAGE_TREE_T = 3;
+
   //
   //
   //
@@ -56,9 +59,12 @@ namespace
           doc
           , bind(&output_icc_dict, intent.ncomponents, _1));
       
-      copy_stream(*intent.icc_stream, cstream.out_stream());
-      intent.profile_ref = IndirectObjectRef(cstream);
+      // the size is not known, so the profile is buffered
+      cstream.set_data_writer(bind(&copy_stream, ref(*intent.icc_stream), _1), 0);
+      // take the reference after the output, the profile might be an alias
+      // of an already written stream
       cstream.output_definition();
+      intent.profile_ref = IndirectObjectRef(cstream);
   }
 }
 
@@ -294,13 +300,22 @@ void ProcessPageTreeNode(TreeNode::TreeNodePtr& node)
 //////////////////////////////////////////////////////////////////////////
 bool PDFCatalog::on_before_output_definition()
 {
-    TRACE_INFO << "Writing pages." ;
-    PageTreeBuilder pg_tree_builder(doc(), 3);
-    TreeNode::TreeNodePtr tree_root = pg_tree_builder.BuildPageTree(m_pages);
+    TRACE_INFO << "Writing page tree." ;
+    PageTreeBuilder pg_tree_builder(doc(), PAGE_TREE_T);
+    TreeNode::TreeNodePtr tree_root = pg_tree_builder.BuildPageTree(m_page_parents);
     ProcessPageTreeNode(tree_root);
     m_page_tree_root =  IndirectObjectRef(*tree_root);
 
+    // annotations (they might refer to pages which did not exist at the
+    // time their page was written)
+    if (!m_annotations.empty())
+    {
+        TRACE_DETAIL << "Writing indirect annotations.";
+        for(int i=static_cast<int>(m_annotations.size()); i--;)
+            m_annotations[i].output_definition();
 
+        m_annotations.clear();
+    }
 
     // output document outline (if any)
     IIndirectObject* outline(doc().doc_outline_if_nonempty());
@@ -323,10 +338,31 @@ bool PDFCatalog::on_before_output_definition()
 }
 
 
-//////////////////////////////////////////////////////////////////////////
+/**
+ * @brief Writes a finished page.
+ *
+ * The page is written right away and only its compact record is kept. Its
+ * /Parent is a page tree node which is reserved now and written when the
+ * document is finalized.
+ *
+ * @param page finished page
+ */
 void PDFCatalog::add_page(std::auto_ptr<PageObject> page)
 {
-    m_pages.push_back(page.release());
+    if (m_page_parents.empty() ||
+        m_page_parents.back().num_leafs() == 2 * PAGE_TREE_T)
+    {
+        m_page_parents.push_back(new PageTreeNode(doc()));
+    }
+
+    PageTreeNode& parent = m_page_parents.back();
+    page->set_parent(&parent);
+    page->output_definition();
+
+    const IndirectObjectRef page_ref(*page);
+    parent.add_page(page_ref);
+    m_pages.push_back(page_record_t(page_ref, page->dimension()));
+    m_annotations.transfer(m_annotations.end(), page->annotations());
 }
 
 
@@ -336,7 +372,7 @@ void PDFCatalog::add_page(std::auto_ptr<PageObject> page)
 IndirectObjectRef PDFCatalog::page_ref(int page_num) const
 {
     JAG_PRECONDITION(page_num < static_cast<int>(num_pages()));
-    return IndirectObjectRef(m_pages[page_num]);
+    return m_pages[page_num].ref;
 }
 
 void PDFCatalog::add_output_intent(std::auto_ptr<output_intent_t> intent)
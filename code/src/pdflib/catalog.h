@@ -10,6 +10,8 @@
 
 #include "indirectobjectimpl.h"
 #include "page_object.h"
+#include "page_tree_node.h"
+#include "annotationimpl.h"
 #include "tree_node.h"
 #include "indirectobjectref.h"
 
@@ -33,12 +35,27 @@ struct output_intent_t
 };
 
 
+// Compact record of an already written page.
+struct page_record_t
+{
+    page_record_t(IndirectObjectRef const& ref, PageObject::Dimension const& dim)
+        : ref(ref)
+    {
+        dimension[0] = dim[0];
+        dimension[1] = dim[1];
+    }
+
+    IndirectObjectRef       ref;
+    PageObject::Dimension   dimension;
+};
+
+
 class PDFCatalog
     : public IndirectObjectImpl
 {
 public:
     DEFINE_VISITABLE
-    typedef boost::ptr_vector<PageObject> Pages;
+    typedef std::vector<page_record_t> Pages;
     explicit PDFCatalog(DocWriterImpl& doc);
     ~PDFCatalog() {}
     void add_page(std::auto_ptr<PageObject> page);
@@ -61,6 +78,8 @@ private: // IndirectObjectImpl
 
 private:
     Pages                                       m_pages;
+    boost::ptr_vector<PageTreeNode>             m_page_parents;
+    boost::ptr_vector<AnnotationImpl>           m_annotations;
     IndirectObjectRef                           m_doc_outline;
     IndirectObjectRef                           m_page_tree_root;
     IndirectObjectRef                           m_viewer_prefs;
@@ -19,6 +19,9 @@ namespace
       {"doc.encryption"        , ""},
       {"doc.static_file_id"    , "0"},  // not-documented
       {"doc.compressed"        , "1"},
+      {"doc.compression_threads", "0"},
+      {"doc.object_streams"    , "0"},
+      {"doc.dedup_streams"     , "0"},
       {"doc.strict_mode"       , "1"},
       {"doc.trace_level"       , "1"},  // not-documented
       {"doc.trace_show_loc"    , "0"},  // not-documented
@@ -29,6 +32,14 @@ namespace
       {"doc.viewer_preferences", ""},
       {"doc.topdown",            "0"},
 
+      // compression, effective only if doc.compressed is set
+      {"compression.content_level"   , "6"},
+      {"compression.content_strategy", "default"},
+      {"compression.image_level"     , "6"},
+      {"compression.image_strategy"  , "default"},
+      {"compression.font_level"      , "6"},
+      {"compression.font_strategy"   , "default"},
+
       // should not be used directly but via get_default_text_encoding()
       {"text.encoding"         , ""},   // not-documented
       {"text.kerning"          , "0"},
@@ -42,12 +53,14 @@ namespace
       {"fonts.synthesized"         , "1"},
       {"fonts.subset"              , "1"},
       {"fonts.force_cid"           , "1"},
+      {"fonts.shared_cache"        , "0"},
       {"fonts.default"             , "standard;name=Helvetica;size=12"},
 
       // images
       {"images.interpolated"       , "0"},
       {"images.intent"             , "-1"}, // not-documented
       {"images.default_dpi"        , "72"},
+      {"images.prepare_threads"    , "0"},
       {"images.softmask_16_to_8"   , "1"},  // not-documented
       {"images.png_advanced_color" , "1"},  // not-documented
 
@@ -14,6 +14,7 @@
 #include "contentstream.h"
 #include "resourcemanagement.h"
 #include "genericcontentstream.h"
+#include "iccprofilecache.h"
 #include <core/generic/smartptrutils.h>
 #include <core/generic/checked_cast.h>
 #include <core/generic/refcountedimpl.h>
@@ -37,6 +38,12 @@ namespace pdf {
 
 namespace
 {
+  // data writer of a stream with data already in memory
+  void write_data(Byte const* data, size_t size, ISeqStreamOutput& out)
+  {
+      out.write(data, size);
+  }
+
   /**
    * @brief Outputs common base of CIE based color spaces
    *
@@ -365,15 +372,31 @@ bool ColorSpaceObj::before_output_iccbased(resources::ICCBasedImpl& obj,
         return true;
 
     // output the stream with icc profile
-    GenericContentStream cstream(
-        m_doc
-        , bind(&ColorSpaceObj::output_iccbased_dict, this, ref(obj), _1)
-   );
+    GenericContentStream::callback_t dict_writer(
+        bind(&ColorSpaceObj::output_iccbased_dict, this, ref(obj), _1));
 
-    copy_stream(*obj.icc_profile(), cstream.out_stream());
+    std::auto_ptr<GenericContentStream> cstream;
+    if (obj.is_profile_static() && m_doc.is_compressed(STREAM_CLASS_CONTENT))
+    {
+        // a static profile is compressed once per process
+        std::vector<Byte> const& data = icc_profile_cache().compressed(
+            obj.profile_data(), obj.profile_size(),
+            m_doc.deflate_params(STREAM_CLASS_CONTENT));
+
+        const StreamFilter filter = STREAM_FILTER_FLATE_ENCODED;
+        cstream.reset(new GenericContentStream(m_doc, dict_writer, &filter, 1));
+        cstream->set_data_writer(bind(&write_data, &data[0], data.size(), _1), data.size());
+    }
+    else
+    {
+        cstream.reset(new GenericContentStream(m_doc, dict_writer));
+        cstream->set_data_writer(
+            bind(&write_data, obj.profile_data(), obj.profile_size(), _1),
+            obj.profile_size());
+    }
 
-    m_ref = IndirectObjectRef(cstream);
-    cstream.output_definition();
+    cstream->output_definition();
+    m_ref = IndirectObjectRef(*cstream);
 
     // output alternate color space (if any)
     ColorSpaceHandle alternate(obj.alternate());
@@ -11,20 +11,89 @@
 #include "docwriterimpl.h"
 
 #include <core/jstd/zlib_stream.h>
+#include <core/jstd/deflate.h>
+#include <core/jstd/threadpool.h>
 #include <core/jstd/file_stream.h>
 #include <core/jstd/memory_stream.h>
-#include <core/jstd/streamhelpers.h>
+#include <core/jstd/md5.h>
+#include <core/jstd/streampool.h>
 #include <core/errlib/errlib.h>
+#include <core/generic/checked_cast.h>
 
 #include <boost/bind.hpp>
 #include <boost/ref.hpp>
+#include <string>
 
 using namespace jag::jstd;
 
 namespace jag {
 namespace pdf {
 
-char const*const ContentStream::s_filter_names[] = { "FlateDecode", "DCTDecode" };
+char const*const ContentStream::s_filter_names[] = { "FlateDecode", "DCTDecode", "FlateDecode" };
+
+
+/**
+ * @brief Value of /Length of a stream written directly to the document.
+ *
+ * It is output right after the stream, once the length is known.
+ */
+class StreamLength
+    : public IndirectObjectImpl
+{
+public:
+    DEFINE_VISITABLE
+    explicit StreamLength(DocWriterImpl& doc)
+        : IndirectObjectImpl(doc)
+        , m_length(0)
+    {}
+
+    void length(ULong length) { m_length = length; }
+
+private:
+    void on_output_definition() {
+        object_writer().output(static_cast<UInt>(m_length));
+    }
+
+private:
+    ULong m_length;
+};
+
+
+namespace
+{
+  // data smaller than this are buffered, it is not worth the indirect /Length
+  const ULong DIRECT_OUTPUT_MIN_SIZE = 64 * 1024;
+
+  // passes the written data to the stream data of the object being output,
+  // optionally hashes them
+  class ObjectStreamData
+      : public ISeqStreamOutput
+  {
+  public:
+      ObjectStreamData(ObjFmt& writer, MD5Hash* md5)
+          : m_writer(writer)
+          , m_md5(md5)
+          , m_position(0)
+      {}
+
+      void write(void const* data, ULong size) {
+          if (m_md5)
+              m_md5->append(data, static_cast<md5_word_t>(size));
+
+          m_writer.stream_data(data, static_cast<size_t>(size));
+          m_position += size;
+      }
+
+      ULong tell() const { return m_position; }
+      void flush() {}
+
+  private:
+      ObjFmt&  m_writer;
+      MD5Hash* m_md5;
+      ULong    m_position;
+  };
+
+} // anonymous namespace
 
 
 /**
@@ -33,45 +102,66 @@ char const*const ContentStream::s_filter_names[] = { "FlateDecode", "DCTDecode"
  * @param body pdf file body
  * @param filters an ordered filters specification
  * @param number of filters
+ * @param cls stream class, selects the compression settings
  */
-ContentStream::ContentStream(DocWriterImpl& doc, StreamFilter const* filters, int num_filters)
+ContentStream::ContentStream(DocWriterImpl& doc, StreamFilter const* filters, int num_filters,
+                             StreamClass cls)
     : IndirectObjectImpl(doc)
     , m_state(INITIAL)
+    , m_class(cls)
+    , m_stream(doc.stream_pool())
     , m_top_stream(&m_stream)
+    , m_size_hint(0)
 {
-    if (num_filters)
+    m_filter_ids.reserve(num_filters);
+    for(int i=num_filters-1; i>=0; --i)
+        m_filter_ids.push_back(filters[i]);
+
+    create_filters(m_stream);
+    m_object_writer.reset(new ObjFmtBasic(*m_top_stream, doc.utf8_to_16be_stream()));
+}
+
+
+//
+// Builds the filter stack on top of the given stream.
+//
+void ContentStream::create_filters(ISeqStreamOutput& stream)
+{
+    JAG_PRECONDITION(m_filters.empty());
+    m_top_stream = &stream;
+    m_filters.reserve(m_filter_ids.size());
+    for(size_t i=0; i<m_filter_ids.size(); ++i)
     {
-        m_filters.reserve(num_filters);
-        m_filter_ids.reserve(num_filters);
-        for(int i=num_filters-1; i>=0; --i)
+        std::auto_ptr<ISeqStreamOutputControl> new_filter;
+        switch (m_filter_ids[i])
         {
-            std::auto_ptr<ISeqStreamOutputControl> new_filter;
-            switch (filters[i])
-            {
-            case STREAM_FILTER_FLATE:
-                new_filter.reset(new ZLibStreamOutput(*m_top_stream));
-                break;
-                
-            case STREAM_FILTER_DCTDECODE:
-                // =JPEG, no actual filter is instantiated; the client sends
-                // already encoded data
-                break;
-                
-            default:
-                JAG_INTERNAL_ERROR;
-            }
-
-            m_filter_ids.push_back(filters[i]);
-
-            if (new_filter.get())
-            {
-                m_top_stream = new_filter.get();
-                m_filters.push_back(new_filter.release());
-            }
+        case STREAM_FILTER_FLATE:
+            new_filter = doc().stream_pool()->create_deflate(*m_top_stream,
+                                                             doc().deflate_params(m_class));
+            if (ThreadPool* pool = doc().compression_pool())
+                new_filter.reset(new PooledZLibStreamOutput(new_filter, *pool));
+            break;
+
+        case STREAM_FILTER_DCTDECODE:
+            // =JPEG, no actual filter is instantiated; the client sends
+            // already encoded data
+            break;
+
+        case STREAM_FILTER_FLATE_ENCODED:
+            // e.g. PNG image data, the client sends already compressed
+            // data
+            break;
+
+        default:
+            JAG_INTERNAL_ERROR;
         }
-    }
 
-    m_object_writer.reset(new ObjFmtBasic(*m_top_stream, doc.utf8_to_16be_stream()));
+        if (new_filter.get())
+        {
+            m_top_stream = new_filter.get();
+            m_filters.push_back(new_filter.release());
+        }
+    }
 }
 
 
@@ -80,16 +170,18 @@ ContentStream::ContentStream(DocWriterImpl& doc, StreamFilter const* filters, in
 //
 ContentStream::~ContentStream()
 {
-    delete_filters();
+    // the document might be already gone
+    delete_filters(false);
 }
 
 //
 //
 //
-void ContentStream::delete_filters()
+void ContentStream::delete_filters(bool recycle)
 {
     // Delete filters in reverse order as they are chained and redirect
-    // m_top_stream to the physical stream.
+    // m_top_stream to the physical stream. If 'recycle' is set then closed
+    // deflate filters are returned to the stream pool.
     //
     // Upon finishing this function:
     // - m_object_writer can't be used as it might be using a dangling pointer
@@ -97,10 +189,24 @@ void ContentStream::delete_filters()
     //
     m_top_stream = &m_stream;
     std::size_t cnt = m_filters.size();
-    if (cnt > 0)
+    while(cnt--)
     {
-        while(cnt--)
-            delete m_filters[cnt];
+        std::auto_ptr<ISeqStreamOutputControl> filter(m_filters[cnt]);
+        if (!recycle)
+            continue;
+
+        StreamPool& stream_pool = *doc().stream_pool();
+        if (doc().compression_pool())
+        {
+            PooledZLibStreamOutput* pooled =
+                checked_static_cast<PooledZLibStreamOutput*>(filter.get());
+            if (m_state & CLOSED_FILTERS)
+                stream_pool.recycle_deflate(pooled->release_deflater());
+        }
+        else
+        {
+            stream_pool.recycle_deflate(filter);
+        }
     }
     m_filters.clear();
 }
@@ -127,7 +233,32 @@ ObjFmtBasic const& ContentStream::object_writer() const
 //////////////////////////////////////////////////////////////////////////
 bool ContentStream::on_before_output_definition()
 {
-    if (m_stream.tell())
+    if (m_state & DIRECT_OUTPUT)
+    {
+        // the data are written during the output
+        return true;
+    }
+
+    if (m_data_writer && use_direct_output())
+    {
+        // the filters are created again on top of the document stream
+        m_object_writer.reset();
+        close_filters();
+        delete_filters();
+        m_state &= ~CLOSED_FILTERS;
+        m_state |= DIRECT_OUTPUT | NON_EMPTY_STREAM;
+        return true;
+    }
+
+    if (m_data_writer)
+    {
+        m_data_writer(*m_top_stream);
+        m_data_writer.clear();
+    }
+
+    // the physical stream might be still being written by a pooled filter,
+    // so ask the top of the stream stack
+    if (m_top_stream->tell())
     {
         m_state |= NON_EMPTY_STREAM;
         return true;
@@ -151,18 +282,17 @@ void ContentStream::close_filters()
 }
 
 
-//////////////////////////////////////////////////////////////////////////
-void ContentStream::on_output_definition()
+//
+// Writes the stream dictionary. If 'indirect_length' is set then /Length
+// refers to m_length.
+//
+void ContentStream::output_dictionary(ObjFmt& writer, int stream_length, bool indirect_length)
 {
-    m_state |= OUTPUTTED;
-
-    close_filters();
-
-    int stream_length = static_cast<int>(m_stream.tell());
-    ObjFmt& writer = IndirectObjectImpl::object_writer();
-    
-    writer.dict_start()
-        .dict_key("Length").space().output(stream_length);
+    writer.dict_start().dict_key("Length").space();
+    if (indirect_length)
+        writer.ref(*m_length);
+    else
+        writer.output(stream_length);
 
     // write filters (if any were used)
     if (m_filter_ids.size())
@@ -182,14 +312,175 @@ void ContentStream::on_output_definition()
     if (m_writer_callback)
         m_writer_callback(writer);
 
-    writer.dict_end()
-        .raw_text("stream\n")
-        .stream_data(m_stream.data(), stream_length)
-        .raw_text("\nendstream")
-    ;
+    writer.dict_end();
+}
 
-    m_stream.close();
+
+//
+// Returns the unencrypted stream dictionary.
+//
+std::string ContentStream::dictionary_key(int stream_length)
+{
+    MemoryStreamOutput dict;
+    ObjFmt dict_writer(dict, 0, doc().utf8_to_16be_stream());
+    output_dictionary(dict_writer, stream_length);
+    return std::string(reinterpret_cast<char const*>(dict.data()),
+                       static_cast<size_t>(dict.tell()));
+}
+
+
+//
+// Returns the key identifying equal streams. The key is the unencrypted
+// dictionary followed by the digest of the data. The data length is part of
+// the dictionary.
+//
+std::string ContentStream::stream_key(int stream_length, MD5Hash& md5)
+{
+    std::string key(dictionary_key(stream_length));
+    key.append(reinterpret_cast<char const*>(md5.finish()), sizeof(MD5Hash::Sum));
+    return key;
+}
+
+
+//
+// Looks for an already written stream with the same dictionary and data.
+//
+Int ContentStream::on_find_equal_object()
+{
+    // streams written directly are hashed while being output
+    if (!doc().dedup_streams() || (m_state & DIRECT_OUTPUT))
+        return -1;
+
+    close_filters();
+
+    MD5Hash md5;
+    for(int i=0; i<m_stream.num_segments(); ++i)
+        md5.append(m_stream.segment(i),
+                   static_cast<md5_word_t>(m_stream.segment_length(i)));
+
+    const Int equal_object = doc().find_equal_stream(
+        stream_key(static_cast<int>(m_stream.tell()), md5), *this);
+    if (-1 != equal_object)
+    {
+        m_state |= OUTPUTTED;
+        release_data();
+    }
+
+    return equal_object;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void ContentStream::on_output_definition()
+{
+    m_state |= OUTPUTTED;
+
+    ObjFmt& writer = IndirectObjectImpl::object_writer();
+    if (m_state & DIRECT_OUTPUT)
+    {
+        output_direct(writer);
+        return;
+    }
+
+    close_filters();
+
+    int stream_length = static_cast<int>(m_stream.tell());
+    output_dictionary(writer, stream_length);
+
+    writer.raw_text("stream\n");
+    for(int i=0; i<m_stream.num_segments(); ++i)
+        writer.stream_data(m_stream.segment(i),
+                           static_cast<size_t>(m_stream.segment_length(i)));
+    writer.raw_text("\nendstream");
+
+    release_data();
+}
+
+
+//
+// Whether the data are written right to the document instead of being
+// buffered. If streams are deduplicated then a stream is buffered when a
+// stream with the same dictionary has already been written directly, so
+// that it can be found equal to it.
+//
+bool ContentStream::use_direct_output()
+{
+    if (m_state & ALWAYS_DIRECT)
+        return true;
+
+    if (m_size_hint < DIRECT_OUTPUT_MIN_SIZE)
+        return false;
+
+    if (!doc().dedup_streams())
+        return true;
+
+    return doc().register_direct_stream(dictionary_key(0));
+}
+
+
+//
+// Writes the data provided by the data writer right to the document through
+// the filter stack. The length is not known until the data are written so
+// it is referenced as an indirect object.
+//
+// The data are hashed on the way so that streams output later can be found
+// equal to this one.
+//
+void ContentStream::output_direct(ObjFmt& writer)
+{
+    m_length.reset(new StreamLength(doc()));
+    const bool dedup = doc().dedup_streams() && !(m_state & ALWAYS_DIRECT);
+    MD5Hash md5;
+    ObjectStreamData out(writer, dedup ? &md5 : 0);
+    create_filters(out);
+    try
+    {
+        output_dictionary(writer, 0, true);
+        writer.raw_text("stream\n");
+        m_data_writer(*m_top_stream);
+        close_filters();
+    }
+    catch(...)
+    {
+        // the filters must not outlive 'out'
+        delete_filters(false);
+        throw;
+    }
+
+    m_length->length(out.tell());
+    writer.raw_text("\nendstream");
+    m_data_writer.clear();
+
+    if (dedup)
+        doc().find_equal_stream(stream_key(static_cast<int>(out.tell()), md5), *this);
+
+    release_data();
+}
+
+
+//
+// Outputs the stream, followed by its length if it has been written
+// directly.
+//
+void ContentStream::output_definition()
+{
+    IndirectObjectImpl::output_definition();
+    if (m_length)
+    {
+        m_length->output_definition();
+        m_length.reset();
+    }
+}
+
+
+//
+// Frees the stream data once the stream has been output.
+//
+void ContentStream::release_data()
+{
     m_object_writer.reset();
+    delete_filters();
+    m_stream.close();
 }
 
 
@@ -199,7 +490,7 @@ bool ContentStream::is_empty() const
     if (m_state&OUTPUTTED)
         return !(m_state&NON_EMPTY_STREAM);
 
-    return m_stream.tell() ? false : true;
+    return m_top_stream->tell() ? false : true;
 }
 
 
@@ -217,6 +508,25 @@ void ContentStream::set_writer_callback(callback_t const& writer)
 }
 
 
+//
+// The data writer is invoked when the stream is output, the stream must not
+// be written otherwise. If 'size_hint', an estimate of the data size, is at
+// least DIRECT_OUTPUT_MIN_SIZE then the data are written right to the
+// document without being buffered. If 'always_direct' is set then the data
+// are written directly regardless of the size and the stream is not
+// deduplicated, e.g. for data that can be read only once.
+//
+void ContentStream::set_data_writer(data_writer_t const& writer, ULong size_hint,
+                                    bool always_direct)
+{
+    JAG_PRECONDITION(!(m_state & OUTPUTTED) && !m_top_stream->tell());
+    m_data_writer = writer;
+    m_size_hint = size_hint;
+    if (always_direct)
+        m_state |= ALWAYS_DIRECT;
+}
+
+
 //
 // Copies the content stream bytes and the state of the object writer.
 //
@@ -242,8 +552,8 @@ void ContentStream::copy_to(ContentStream& other)
     other.delete_filters();
 
     // Copy stream data & object writer state
-    MemoryStreamInput in_stream(m_stream.data(), m_stream.tell(), false);
-    copy_stream(in_stream, other.stream());
+    for(int i=0; i<m_stream.num_segments(); ++i)
+        other.stream().write(m_stream.segment(i), m_stream.segment_length(i));
     object_writer().copy_to(other.object_writer());
 }
 
@@ -15,14 +15,17 @@
 #include "defines.h"
 
 #include <interfaces/streams.h>
-#include <core/jstd/memory_stream.h>
+#include <core/jstd/streampool.h>
 #include <boost/scoped_ptr.hpp>
 #include <boost/function.hpp>
 #include <vector>
+#include <string>
 
 namespace jag {
+namespace jstd { class MD5Hash; }
 namespace pdf {
 class DocWriterImpl;
+class StreamLength;
 
 ///
 /// pdf content stream implementation
@@ -33,8 +36,10 @@ class ContentStream
 public:
     DEFINE_VISITABLE
 
-    ContentStream(DocWriterImpl& doc, StreamFilter const* filters=0, int num_filters=0);
+    ContentStream(DocWriterImpl& doc, StreamFilter const* filters=0, int num_filters=0,
+                  StreamClass cls=STREAM_CLASS_CONTENT);
     ~ContentStream();
+    void output_definition();
     ISeqStreamOutput& stream();
     ObjFmtBasic& object_writer();
     ObjFmtBasic const& object_writer() const;
@@ -45,13 +50,27 @@ public:
     typedef boost::function<void (ObjFmt& fmt)> callback_t;
     void set_writer_callback(callback_t const& writer);
 
+    /// writes the stream data when the stream is being output
+    typedef boost::function<void (ISeqStreamOutput& out)> data_writer_t;
+    void set_data_writer(data_writer_t const& writer, ULong size_hint,
+                         bool always_direct=false);
+
 private: // IndirectObjectImpl
     void on_output_definition();
     bool on_before_output_definition();
+    Int on_find_equal_object();
+    ObjectType object_type() const { return PDFOBJ_STREAM; }
 
 private:
+    void create_filters(ISeqStreamOutput& stream);
     void close_filters();
-    void delete_filters();
+    void output_dictionary(ObjFmt& writer, int stream_length, bool indirect_length=false);
+    std::string dictionary_key(int stream_length);
+    std::string stream_key(int stream_length, jstd::MD5Hash& md5);
+    bool use_direct_output();
+    void output_direct(ObjFmt& writer);
+    void release_data();
+    void delete_filters(bool recycle=true);
     static char const*const s_filter_names[];
 
     enum State
@@ -60,12 +79,15 @@ private:
         CLOSED_FILTERS =   1U << 1,
         OUTPUTTED =        1U << 2,
         NON_EMPTY_STREAM = 1U << 3,
+        DIRECT_OUTPUT =    1U << 4,
+        ALWAYS_DIRECT =    1U << 5,
     };
 
 private:    
     unsigned m_state;
+    StreamClass m_class;
     // 'physical' stream with content data
-    jstd::MemoryStreamOutput m_stream;
+    jstd::SegmentedStreamOutput m_stream;
     // stream used to write data (top of the stream stack)
     ISeqStreamOutput* m_top_stream;
     // owns used filters
@@ -74,6 +96,11 @@ private:
     std::vector<StreamFilter>            m_filter_ids;
     boost::scoped_ptr<ObjFmtBasic>       m_object_writer;
     callback_t                           m_writer_callback;
+    data_writer_t                        m_data_writer;
+    // estimated size of the data written by m_data_writer
+    ULong                                m_size_hint;
+    // /Length of a stream written directly to the document
+    boost::scoped_ptr<StreamLength>      m_length;
 };
 
 }} //namespace jag::pdf
@@ -46,6 +46,29 @@ void CrossReferenceSection::add_indirect_object(
     m_objects[object_number] = Entry(generation_number, stream_offset);
 }
 
+/**
+* @brief adds an object stored in an object stream
+*
+* @param object_number to be added
+* @param object_stream_number object stream containing the object
+* @param index index of the object within the object stream
+*/
+void CrossReferenceSection::add_compressed_object(
+      Int object_number
+    , Int object_stream_number
+    , Int index
+)
+{
+    JAG_ASSERT(object_number >= 0);
+
+    if (object_number >= static_cast<Int>(m_objects.size()))
+        m_objects.resize(object_number + 1);
+
+    JAG_ASSERT(!m_objects[object_number].m_valid);
+
+    m_objects[object_number] = Entry(index, object_stream_number, 'c');
+}
+
 /**
  * @brief outputs the crossreference section to the stream
  *
@@ -74,6 +97,7 @@ void CrossReferenceSection::output(ISeqStreamOutput& seq_stream)
         ++it)
     {
     JAG_ASSERT_MSG(it->m_valid, "page object registered to cross-ref table, but not outputted");
+    JAG_ASSERT_MSG(it->m_type != 'c', "compressed object requires cross-reference stream");
     written = jstd::snprintf(buffer, buffer_length, "%010d %05d %c \n",
         it->m_stream_offset,
         it->m_generation_number,
@@ -88,6 +112,50 @@ void CrossReferenceSection::output(ISeqStreamOutput& seq_stream)
 }
 
 
+/**
+ * @brief outputs the entries as cross-reference stream data (3.4.7)
+ *
+ * The cross-reference stream object itself has to be registered by
+ * add_indirect_object() before this call.
+ *
+ * @param seq_stream output storage
+ * @param xref_stream_offset offset of the cross-reference stream object
+ */
+void CrossReferenceSection::output_stream_data(ISeqStreamOutput& seq_stream,
+                                               ULong xref_stream_offset)
+{
+    JAG_ASSERT_MSG(!m_stream_offset, "we have been already here!");
+    m_stream_offset = xref_stream_offset;
+
+    const int entry_length = STREAM_TYPE_BYTES + STREAM_FIELD2_BYTES + STREAM_FIELD3_BYTES;
+    Byte entry[entry_length];
+    for(Entries::const_iterator it = m_objects.begin();
+        it != m_objects.end();
+        ++it)
+    {
+        JAG_ASSERT_MSG(it->m_valid, "page object registered to cross-ref table, but not outputted");
+
+        Byte type = 1;
+        if (it->m_type == 'f')
+            type = 0;
+        else if (it->m_type == 'c')
+            type = 2;
+
+        // big-endian fields
+        entry[0] = type;
+        const UInt field2 = static_cast<UInt>(it->m_stream_offset);
+        entry[1] = static_cast<Byte>(field2 >> 24);
+        entry[2] = static_cast<Byte>(field2 >> 16);
+        entry[3] = static_cast<Byte>(field2 >> 8);
+        entry[4] = static_cast<Byte>(field2);
+        const UInt field3 = static_cast<UInt>(it->m_generation_number);
+        JAG_ASSERT(field3 <= 0xffff);
+        entry[5] = static_cast<Byte>(field3 >> 8);
+        entry[6] = static_cast<Byte>(field3);
+        seq_stream.write(entry, entry_length);
+    }
+}
+
 /**
 * @return number of entries in the table
 */
@@ -37,12 +37,25 @@ public:
         , Int stream_offset
    );
 
+    /// adds an object stored in an object stream
+    void add_compressed_object(
+          Int object_number
+        , Int object_stream_number
+        , Int index
+   );
+
     void output(ISeqStreamOutput& seq_stream);
+    void output_stream_data(ISeqStreamOutput& seq_stream, ULong xref_stream_offset);
     int num_entries() const;
     UInt stream_offset() const;
 
+    /// field widths (/W) of cross-reference stream entries
+    enum { STREAM_TYPE_BYTES = 1, STREAM_FIELD2_BYTES = 4, STREAM_FIELD3_BYTES = 2 };
+
 private:
-    /// single object entry in crossreference table
+    /// single object entry in crossreference table; for objects
+    /// in object streams ('c') the stream offset is the number of the object
+    /// stream and the generation number is the index within that stream
     struct Entry
     {
         Int m_generation_number;
@@ -20,6 +20,30 @@ enum StreamFilter
 {     // DO NOT CHANGE ORDER
       STREAM_FILTER_FLATE
     , STREAM_FILTER_DCTDECODE
+    , STREAM_FILTER_FLATE_ENCODED    // FlateDecode, data already compressed
+};
+
+
+/// stream classes with separate compression settings
+enum StreamClass
+{
+      STREAM_CLASS_CONTENT    // page content, forms, patterns, other streams
+    , STREAM_CLASS_IMAGE      // image data
+    , STREAM_CLASS_FONT       // font programs, cmaps
+    , NUM_STREAM_CLASSES
+};
+
+
+/// text output settings, read from the configuration once per document
+struct TextOptions
+{
+    TextOptions()
+        : kerning(false)
+        , encoding(0)
+    {}
+
+    bool         kerning;    // text.kerning
+    char const*  encoding;   // canonical text encoding, null if not specified
 };
 
 
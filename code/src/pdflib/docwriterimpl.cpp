@@ -23,6 +23,7 @@
 #include "interfaces/security_handler.h"
 #include "docoutlineimpl.h"
 #include "indirectobjectfromdirect.h"
+#include "objectstreams.h"
 #include "interfaces/fontadapter.h"
 
 #include <resources/resourcebox/colorspacehelpers.h>
@@ -45,6 +46,10 @@
 #include <core/jstd/tracer.h>
 #include <core/jstd/icumain.h>
 #include <core/jstd/file_stream.h>
+#include <core/jstd/threadpool.h>
+#include <core/jstd/streampool.h>
+#include <core/jstd/deflate.h>
+#include <core/jstd/uconverterctrl.h>
 #include <core/generic/macros.h>
 #include <core/generic/refcountedimpl.h>
 #include <core/errlib/errlib.h>
@@ -60,6 +65,7 @@
 
 #include <iostream>
 #include <memory>
+#include <set>
 #include <boost/scoped_ptr.hpp>
 #include <boost/ptr_container/ptr_vector.hpp>
 #include <boost/ptr_container/ptr_map.hpp>
@@ -109,6 +115,12 @@ namespace
       Double advance_r(jag::Char const* start, jag::Char const* end) const { return m_other->advance_r(start, end);}
       Double glyph_width(UInt16 glyph_index) const {
           return m_other->glyph_width(glyph_index); }
+      void advances(Char const* txt_u, UInt const* ranges, UInt length,
+                    Double* widths, UInt widths_length) const {
+          m_other->advances(txt_u, ranges, length, widths, widths_length); }
+      UInt char_positions(Char const* txt_u,
+                          Double* positions, UInt positions_length) const {
+          return m_other->char_positions(txt_u, positions, positions_length); }
       Double height() const { return m_other->height(); }
       Double ascender() const { return m_other->ascender(); }
       Double descender() const { return m_other->descender(); }
@@ -144,17 +156,58 @@ namespace
   public: // IFont
       Double advance(Char const* txt_u) const
       {
-          std::vector<UChar> uchars;
-          const std::size_t in_len = strlen(txt_u)+1; // includes terminating 0
-          to_unicode(m_from_conv.get(), txt_u, txt_u+in_len, uchars);
-          JAG_ASSERT(uchars[uchars.size()-1] == 0);
-
           std::vector<Char> chars;
-          from_unicode(m_to_conv.get(), &uchars[0], &uchars[0]+uchars.size(), chars);
-
+          reencode(txt_u, txt_u+strlen(txt_u)+1, chars); // includes terminating 0
           JAG_ASSERT(chars[chars.size()-1] == 0);
           return FontAdapter::advance(&chars[0]);
       }
+
+      // the offsets refer to the original string, so each substring is
+      // reencoded separately
+      void advances(Char const* txt_u, UInt const* ranges, UInt length,
+                    Double* widths, UInt widths_length) const
+      {
+          if (length % 2)
+              throw exception_invalid_value(msg_invalid_argument()) << JAGLOC;
+
+          const std::size_t txt_len = strlen(txt_u);
+          std::vector<Char> chars;
+          std::vector<UInt> new_ranges;
+          new_ranges.reserve(length);
+          for(UInt i=0; i<length; i+=2)
+          {
+              if (ranges[i] > ranges[i+1] || ranges[i+1] > txt_len)
+                  throw exception_invalid_value(msg_invalid_argument()) << JAGLOC;
+
+              new_ranges.push_back(static_cast<UInt>(chars.size()));
+              reencode(txt_u+ranges[i], txt_u+ranges[i+1], chars);
+              new_ranges.push_back(static_cast<UInt>(chars.size()));
+          }
+          chars.push_back(0);
+          FontAdapter::advances(&chars[0],
+                                new_ranges.empty() ? 0 : &new_ranges[0], length,
+                                widths, widths_length);
+      }
+
+      UInt char_positions(Char const* txt_u,
+                          Double* positions, UInt positions_length) const
+      {
+          std::vector<Char> chars;
+          reencode(txt_u, txt_u+strlen(txt_u)+1, chars);
+          return FontAdapter::char_positions(&chars[0], positions, positions_length);
+      }
+
+  private:
+      // appends [begin, end) converted to the font encoding to chars
+      void reencode(Char const* begin, Char const* end, std::vector<Char>& chars) const
+      {
+          if (begin == end)
+              return;
+
+          std::vector<UChar> uchars;
+          to_unicode(m_from_conv.get(), begin, end, uchars);
+          from_unicode(m_to_conv.get(), &uchars[0], &uchars[0]+uchars.size(), chars);
+      }
   };
 
 
@@ -179,6 +232,7 @@ public:
         , m_out_stream(out_stream)
         , m_last_object_nr(0)
         , m_exec_context(*config)
+        , m_stream_pool(new jstd::StreamPool)
         , m_num_stream_filters(0)
         , m_default_font(0)
     {
@@ -207,16 +261,28 @@ public: //data
     Int                                   m_version;
     DocWriterImpl::FileID                 m_file_id;
     ExecContextImpl                       m_exec_context;
+    // buffers and deflate filters reused by content streams
+    shared_ptr<jstd::StreamPool>          m_stream_pool;
+    // must outlive all content streams
+    scoped_ptr<jstd::ThreadPool>          m_compression_pool;
     bool                                  m_static_file_id;
     bool                                  m_flatted_streams;
 
     enum { MAX_STREAM_FILTERS = 1 };
     StreamFilter                          m_stream_filters[MAX_STREAM_FILTERS];
     int                                   m_num_stream_filters;
+    jstd::DeflateParams                   m_deflate_params[NUM_STREAM_CLASSES];
 
     scoped_ptr<PDFCatalog>                m_catalog;
     scoped_ptr<PDFFileTrailer>            m_trailer;
     CrossReferenceSection                 m_cross_reference_section;
+    scoped_ptr<ObjectStreams>             m_object_streams;
+    // written streams - {dictionary and data digest: object number}
+    bool                                  m_dedup_streams;
+    typedef std::map<std::string, Int> StreamKeys;
+    StreamKeys                            m_stream_keys;
+    // dictionaries of streams written directly
+    std::set<std::string>                 m_direct_stream_dicts;
     scoped_ptr<DocOutlineImpl>            m_doc_outline;
     ptr_vector<IndirectObjectFromDirect>  m_destinations;
 
@@ -229,6 +295,9 @@ public: //data
     // resources
     shared_ptr<IResourceCtx>                m_resctx;
     scoped_ptr<ResourceManagement>          m_resource_management;
+    // prepares loaded images, the pending preparations are finished
+    // before the images are destroyed
+    scoped_ptr<jstd::ThreadPool>            m_image_pool;
 
     IFont*                              m_default_font;
 
@@ -236,6 +305,10 @@ public: //data
     typedef std::map<PDFFont const*, shared_ptr<IFontAdapter> > FontMap;
     FontMap m_font_map;
     bool m_is_topdown;
+
+    TextOptions                         m_text_options;
+    // converter of m_text_options.encoding
+    scoped_ptr<jstd::UConverterCtrl>    m_text_conv_ctrl;
 };
 
 
@@ -280,12 +353,58 @@ DocWriterImpl::DocWriterImpl(
     m_pimpl->m_static_file_id = config->get("doc.static_file_id") ? true : false;
     m_pimpl->m_is_topdown = config->get_int("doc.topdown");
 
+    // text
+    m_pimpl->m_text_options.kerning = config->get_int("text.kerning") ? true : false;
+    char const* txt_enc = get_default_text_encoding(exec_context());
+    if (!is_empty(txt_enc))
+    {
+        char const* txt_enc_canon = get_canonical_converter_name(txt_enc);
+        m_pimpl->m_text_options.encoding = txt_enc_canon ? txt_enc_canon : txt_enc;
+    }
+    m_pimpl->m_text_conv_ctrl.reset(
+        new jstd::UConverterCtrl(m_pimpl->m_text_options.encoding
+                                 ? m_pimpl->m_text_options.encoding
+                                 : ""));
+
     // encoding
     if (config->get_int("doc.compressed"))
+    {
         m_pimpl->m_stream_filters[m_pimpl->m_num_stream_filters++] = STREAM_FILTER_FLATE;
 
+        m_pimpl->m_deflate_params[STREAM_CLASS_CONTENT] = jstd::deflate_params_from_config(
+            *config, "compression.content_level", "compression.content_strategy");
+        m_pimpl->m_deflate_params[STREAM_CLASS_IMAGE] = jstd::deflate_params_from_config(
+            *config, "compression.image_level", "compression.image_strategy");
+        m_pimpl->m_deflate_params[STREAM_CLASS_FONT] = jstd::deflate_params_from_config(
+            *config, "compression.font_level", "compression.font_strategy");
+
+        const int num_threads = config->get_int("doc.compression_threads");
+        if (num_threads < 0)
+            throw exception_invalid_value(msg_option_out_of_range("doc.compression_threads")) << JAGLOC;
+
+        if (num_threads)
+            m_pimpl->m_compression_pool.reset(new jstd::ThreadPool(num_threads));
+    }
+
     JAG_ASSERT(m_pimpl->m_num_stream_filters <= DocWriterImpl_::MAX_STREAM_FILTERS);
 
+    // images
+    const int num_image_threads = config->get_int("images.prepare_threads");
+    if (num_image_threads < 0)
+        throw exception_invalid_value(msg_option_out_of_range("images.prepare_threads")) << JAGLOC;
+
+    if (num_image_threads)
+        m_pimpl->m_image_pool.reset(new jstd::ThreadPool(num_image_threads));
+
+
+    // object streams
+    if (config->get_int("doc.object_streams"))
+    {
+        ensure_version(5, "object streams");
+        m_pimpl->m_object_streams.reset(new ObjectStreams(*this));
+    }
+
+    m_pimpl->m_dedup_streams = config->get_int("doc.dedup_streams") ? true : false;
 
     // encryption
     if (!strcmp(config->get("doc.encryption"), "standard"))
@@ -386,20 +505,38 @@ void DocWriterImpl::finalize()
 
         res_mgm().finalize();
         m_pimpl->m_trailer->before_output();
-        m_pimpl->m_cross_reference_section.output(*m_pimpl->m_out_stream);
-        m_pimpl->m_trailer->output(
-            m_pimpl->m_cross_reference_section.stream_offset(),
-            m_pimpl->m_cross_reference_section.num_entries(),
-            *m_pimpl->m_catalog,
-            m_pimpl->m_security_handler
+
+        IIndirectObject* encrypt = m_pimpl->m_security_handler
             ? &m_pimpl->m_security_handler->indirect_object()
-            : static_cast<IIndirectObject*>(0));
+            : static_cast<IIndirectObject*>(0);
+
+        if (m_pimpl->m_object_streams)
+        {
+            m_pimpl->m_object_streams->flush();
+            m_pimpl->m_trailer->output_xref_stream(
+                m_pimpl->m_out_stream->tell(),
+                m_pimpl->m_cross_reference_section,
+                *m_pimpl->m_catalog,
+                encrypt);
+        }
+        else
+        {
+            m_pimpl->m_cross_reference_section.output(*m_pimpl->m_out_stream);
+            m_pimpl->m_trailer->output(
+                m_pimpl->m_cross_reference_section.stream_offset(),
+                m_pimpl->m_cross_reference_section.num_entries(),
+                *m_pimpl->m_catalog,
+                encrypt);
+        }
     }
     else
     {
         write_message(WRN_EMPTY_DOCUMENT);
     }
 
+    // images that have not been written do not need the client's memory
+    resource_ctx().image_man()->release_borrowed_data();
+
     m_pimpl->m_object_formatter->flush();
     m_pimpl->m_out_stream->flush();
 
@@ -409,6 +546,12 @@ void DocWriterImpl::finalize()
 //        m_stream_control->close();
     m_pimpl->m_out_stream->close();
 
+    const jstd::StreamPoolStats stats(m_pimpl->m_stream_pool->stats());
+    TRACE_INFO << "Stream pool: segments allocated " << stats.segments_allocated
+               << ", reused " << stats.segments_reused
+               << "; deflaters created " << stats.deflaters_created
+               << ", reused " << stats.deflaters_reused << ".";
+
     // from this point onward only Dispose method can be invoked
     //m_pimpl.reset();
 
@@ -482,9 +625,40 @@ void DocWriterImpl::add_indirect_object(
 }
 
 
+//
+// Registers an object stored in an object stream.
+//
+void DocWriterImpl::add_compressed_object(
+      Int object_number
+    , Int object_stream_number
+    , Int index)
+{
+    m_pimpl->m_cross_reference_section.add_compressed_object(
+        object_number,
+        object_stream_number,
+        index);
+}
+
+
+//
+// Returns the object streams collector, null if object streams are not used.
+//
+ObjectStreams* DocWriterImpl::object_streams() const
+{
+    return m_pimpl->m_object_streams.get();
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 ObjFmt& DocWriterImpl::object_writer() const
 {
+    // objects going to an object stream are formatted to memory
+    if (m_pimpl->m_object_streams)
+    {
+        if (ObjFmt* writer = m_pimpl->m_object_streams->object_writer())
+            return *writer;
+    }
+
     return *m_pimpl->m_object_formatter;
 }
 
@@ -574,17 +748,26 @@ IResourceCtx const& DocWriterImpl::resource_ctx() const
 //////////////////////////////////////////////////////////////////////////
 std::auto_ptr<CanvasImpl> DocWriterImpl::create_canvas_impl()
 {
+    const int num_filters = is_compressed(STREAM_CLASS_CONTENT)
+        ? m_pimpl->m_num_stream_filters
+        : 0;
+
     return std::auto_ptr<CanvasImpl>(
-        new CanvasImpl(*this,
-                       m_pimpl->m_stream_filters,
-                       m_pimpl->m_num_stream_filters));
+        new CanvasImpl(*this, m_pimpl->m_stream_filters, num_filters));
 }
 
-//////////////////////////////////////////////////////////////////////////
-std::auto_ptr<ContentStream> DocWriterImpl::create_content_stream()
+//
+// Creates a stream with the document filters. Streams of a class with
+// compression level 0 are not compressed at all.
+//
+std::auto_ptr<ContentStream> DocWriterImpl::create_content_stream(StreamClass cls)
 {
-    return create_content_stream(
-        m_pimpl->m_stream_filters, m_pimpl->m_num_stream_filters);
+    const int num_filters = is_compressed(cls)
+        ? m_pimpl->m_num_stream_filters
+        : 0;
+
+    return std::auto_ptr<ContentStream>(
+        new ContentStream(*this, m_pimpl->m_stream_filters, num_filters, cls));
 }
 
 
@@ -597,6 +780,96 @@ DocWriterImpl::create_content_stream(StreamFilter const* filters, int num_filter
 }
 
 
+//
+// Returns the pool used for stream compression, null if streams are compressed
+// on the calling thread.
+//
+jstd::ThreadPool* DocWriterImpl::compression_pool() const
+{
+    return m_pimpl->m_compression_pool.get();
+}
+
+
+//
+// Returns the pool preparing loaded images, null if images are prepared
+// when they are output.
+//
+jstd::ThreadPool* DocWriterImpl::image_pool() const
+{
+    return m_pimpl->m_image_pool.get();
+}
+
+
+//
+// Returns the pool of stream buffers and deflate filters.
+//
+shared_ptr<jstd::StreamPool> const& DocWriterImpl::stream_pool() const
+{
+    return m_pimpl->m_stream_pool;
+}
+
+
+//
+// Returns the deflate settings for streams of the given class.
+//
+jstd::DeflateParams const& DocWriterImpl::deflate_params(StreamClass cls) const
+{
+    JAG_PRECONDITION(cls < NUM_STREAM_CLASSES);
+    return m_pimpl->m_deflate_params[cls];
+}
+
+
+//
+// Whether streams of the given class are compressed, i.e. the document is
+// compressed and the class has a non-zero compression level.
+//
+bool DocWriterImpl::is_compressed(StreamClass cls) const
+{
+    JAG_PRECONDITION(cls < NUM_STREAM_CLASSES);
+    return m_pimpl->m_num_stream_filters && m_pimpl->m_deflate_params[cls].level;
+}
+
+
+//
+// Whether identical streams are written only once.
+//
+bool DocWriterImpl::dedup_streams() const
+{
+    return m_pimpl->m_dedup_streams;
+}
+
+
+//
+// Returns the number of an already written stream with the given key. If
+// there is no such stream then 'stream' is registered under the key and -1 is
+// returned.
+//
+Int DocWriterImpl::find_equal_stream(std::string const& key,
+                                     IIndirectObject const& stream)
+{
+    typedef DocWriterImpl_::StreamKeys::iterator It;
+    std::pair<It, bool> inserted = m_pimpl->m_stream_keys.insert(
+        DocWriterImpl_::StreamKeys::value_type(key, -1));
+
+    if (!inserted.second)
+        return inserted.first->second;
+
+    inserted.first->second = stream.object_number();
+    return -1;
+}
+
+
+//
+// Records the dictionary of a stream about to be written directly. Returns
+// false if a stream with the same dictionary has been recorded already, such
+// stream might be equal to it.
+//
+bool DocWriterImpl::register_direct_stream(std::string const& dict)
+{
+    return m_pimpl->m_direct_stream_dicts.insert(dict).second;
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 Int DocWriterImpl::version() const
 {
@@ -682,7 +955,7 @@ Double DocWriterImpl::page_height(int page_number) const
     }
     else
     {
-        return m_pimpl->m_catalog->pages()[page_number].dimension()[1];
+        return m_pimpl->m_catalog->pages()[page_number].dimension[1];
     }
 }
 
@@ -868,13 +1141,9 @@ IFont* DocWriterImpl::font_load(Char const* fspec)
     shared_ptr<IFontAdapter> obj;
     // Check whether a default text encoding is not specified. In such case we
     // need to install an adapter on IFont which translates between encodings.
-    char const* txt_enc = get_default_text_encoding(exec_context());
-    if (!is_empty(txt_enc))
-    {
-        char const* txt_enc_canon = get_canonical_converter_name(txt_enc);
-        if (strcmp(font->encoding_canonical(), txt_enc_canon))
-            obj.reset(new FontInfoReencoder(handle, txt_enc_canon));
-    }
+    char const* txt_enc_canon = text_options().encoding;
+    if (txt_enc_canon && strcmp(font->encoding_canonical(), txt_enc_canon))
+        obj.reset(new FontInfoReencoder(handle, txt_enc_canon));
 
     if (!obj)
         obj.reset(new FontAdapter(handle));
@@ -909,17 +1178,21 @@ IFont* DocWriterImpl::default_font()
 IImage* DocWriterImpl::image_load_file(Char const* image_file_path,
                                       ImageFormat image_type)
 {
-    return const_cast<IImageData*>(
+    IImageData const* img_data =
         resource_ctx().image_man()->image_load_file(image_file_path,
                                                     image_type,
-                                                    exec_context()));
+                                                    exec_context());
+    res_mgm().prepare_image(*img_data);
+    return const_cast<IImageData*>(img_data);
 }
 
 
 IImage* DocWriterImpl::image_load(IImageDef* image)
 {
-    return const_cast<IImageData*>(
-        resource_ctx().image_man()->image_load(image, exec_context()));
+    IImageData const* img_data =
+        resource_ctx().image_man()->image_load(image, exec_context());
+    res_mgm().prepare_image(*img_data);
+    return const_cast<IImageData*>(img_data);
 }
 
 
@@ -1008,6 +1281,35 @@ bool DocWriterImpl::is_topdown() const
 }
 
 
+//
+//
+//
+TextOptions const& DocWriterImpl::text_options() const
+{
+    return m_pimpl->m_text_options;
+}
+
+
+/**
+ * @brief Acquires converter of the text encoding.
+ *
+ * @return converter, or null if the text encoding is not specified
+ */
+UnicodeConverter* DocWriterImpl::acquire_text_converter() const
+{
+    return m_pimpl->m_text_conv_ctrl->acquire_converter();
+}
+
+
+//
+//
+//
+void DocWriterImpl::release_text_converter() const
+{
+    m_pimpl->m_text_conv_ctrl->release_converter();
+}
+
+
 void DocWriterImpl::add_output_intent(Char const* output_condition_id,
                                       Char const* iccpath,
                                       Char const* info,
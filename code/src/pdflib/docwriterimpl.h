@@ -19,6 +19,7 @@
 
 #include <boost/shared_ptr.hpp>
 #include <boost/intrusive_ptr.hpp>
+#include <string>
 
 namespace jag {
 // fwd
@@ -35,12 +36,13 @@ class IFontSpec;
 class IFont;
 class ISeqStreamOutputControl;
 
-namespace jstd { class UnicodeConverterStream; }
+namespace jstd { class UnicodeConverter; class UnicodeConverterStream; class ThreadPool; class StreamPool; struct DeflateParams; }
 
 namespace pdf
 {
 // fwd
 class ObjFmt;
+class ObjectStreams;
 class IIndirectObject;
 class IndirectObjectRef;
 class CanvasImpl;
@@ -122,6 +124,8 @@ public: //non-interface
     IMessageSink& message_sink();
     UInt assign_next_object_number();
     void add_indirect_object(Int object_number, Int generation_number, Int stream_offset);
+    void add_compressed_object(Int object_number, Int object_stream_number, Int index);
+    ObjectStreams* object_streams() const;
     ObjFmt& object_writer() const;
     FileID const& file_id();
     void ensure_version(Int version, Char const* feature, bool always_strict=true) const;
@@ -140,10 +144,21 @@ public: //non-interface
     jstd::UnicodeConverterStream& utf8_to_16be_stream();
     IFont* default_font();
     bool is_topdown() const;
+    TextOptions const& text_options() const;
+    jstd::UnicodeConverter* acquire_text_converter() const;
+    void release_text_converter() const;
 
     std::auto_ptr<CanvasImpl> create_canvas_impl();
-    std::auto_ptr<ContentStream> create_content_stream();
+    std::auto_ptr<ContentStream> create_content_stream(StreamClass cls=STREAM_CLASS_CONTENT);
     std::auto_ptr<ContentStream> create_content_stream(jag::pdf::StreamFilter const* filters, int num_filters);
+    jstd::ThreadPool* compression_pool() const;
+    jstd::ThreadPool* image_pool() const;
+    boost::shared_ptr<jstd::StreamPool> const& stream_pool() const;
+    jstd::DeflateParams const& deflate_params(StreamClass cls) const;
+    bool is_compressed(StreamClass cls) const;
+    bool dedup_streams() const;
+    Int find_equal_stream(std::string const& key, IIndirectObject const& stream);
+    bool register_direct_stream(std::string const& dict);
 
 private:
     struct DocWriterImpl_;
@@ -84,11 +84,26 @@ namespace
   };
 
 
+  // If the dictionary does not depend on the font program then the program
+  // can be written directly to the document.
   template<class W>
-  IndirectObjectRef output_embedded_font(DocWriterImpl& doc, IStreamInput& font_program, W writer)
+  IndirectObjectRef output_embedded_font(DocWriterImpl& doc, IStreamInput& font_program,
+                                         W writer, bool dict_needs_data)
   {
-      GenericContentStream cs(doc, writer);
-      jstd::copy_stream(font_program, cs.out_stream());
+      GenericContentStream cs(doc, writer, STREAM_CLASS_FONT);
+      if (dict_needs_data)
+      {
+          jstd::copy_stream(font_program, cs.out_stream());
+      }
+      else
+      {
+          font_program.seek(0, OFFSET_FROM_END);
+          const ULong size = font_program.tell();
+          font_program.seek(0, OFFSET_FROM_BEGINNING);
+          cs.set_data_writer(
+              boost::bind(&jstd::copy_stream, boost::ref(font_program), _1), size);
+      }
+
       cs.output_definition();
       return IndirectObjectRef(cs);
   }
@@ -339,7 +354,8 @@ bool FontDescriptor::on_before_output_definition()
         m_font_file2 = output_embedded_font(
             doc(),
             *font_program,
-            boost::bind(embed_tt_stream, boost::ref(*font_program), _1));
+            boost::bind(embed_tt_stream, boost::ref(*font_program), _1),
+            true);
     }
     else if (FACE_OPEN_TYPE_CFF == typeface.type())
     {
@@ -352,7 +368,8 @@ bool FontDescriptor::on_before_output_definition()
         m_font_file3 = output_embedded_font(
             doc(),
             *font_program,
-            boost::bind(embedded_cff_stream, subtype, _1));
+            boost::bind(embedded_cff_stream, subtype, _1),
+            false);
     }
     else
     {
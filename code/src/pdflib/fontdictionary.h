@@ -95,8 +95,6 @@ public:
      */
     boost::shared_ptr<FontDescriptor> const& font_descriptor() const;
 
-
-private:
     /**
      * @brief Retrieves converter associated with this font dictionary.
      *
@@ -118,7 +116,6 @@ private:
     class UsedCids;
     class Standard14T1Handler;
     class SimpleFontHandlerBase;
-    friend class CIDFontDictionary; //release/acquire_converter()
 
     PDFFontDictData                       m_font_data;
     jstd::UConverterCtrl               m_conv_ctrl;
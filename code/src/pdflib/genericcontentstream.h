@@ -24,8 +24,17 @@ public:
     DEFINE_VISITABLE;
     typedef boost::function<void (ObjFmt&)> callback_t;
 
-    GenericContentStream(DocWriterImpl& doc, callback_t const& t)
-        : m_content_stream(doc.create_content_stream())
+    GenericContentStream(DocWriterImpl& doc, callback_t const& t,
+                         StreamClass cls=STREAM_CLASS_CONTENT)
+        : m_content_stream(doc.create_content_stream(cls))
+    {
+        m_content_stream->set_writer_callback(t);
+        reset_indirect_object_worker(m_content_stream.get());
+    }
+
+    GenericContentStream(DocWriterImpl& doc, callback_t const& t,
+                         StreamFilter const* filters, int num_filters)
+        : m_content_stream(doc.create_content_stream(filters, num_filters))
     {
         m_content_stream->set_writer_callback(t);
         reset_indirect_object_worker(m_content_stream.get());
@@ -36,6 +45,10 @@ public:
         return m_content_stream->stream();
     }
 
+    void set_data_writer(ContentStream::data_writer_t const& writer, ULong size_hint) {
+        m_content_stream->set_data_writer(writer, size_hint);
+    }
+
 private:
     boost::scoped_ptr<ContentStream> m_content_stream;
 };
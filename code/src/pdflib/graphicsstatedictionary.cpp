@@ -48,10 +48,10 @@ bool operator<(GraphicsStateDictionary const& lhs, GraphicsStateDictionary const
 }
 
 //////////////////////////////////////////////////////////////////////////
+// Hashes the members compared by operator<.
 size_t hash_value(GraphicsStateDictionary const& gs_dict)
 {
     size_t seed = 0;
-    boost::hash_combine(seed, gs_dict.m_param_changed.to_ulong());
     boost::hash_combine(seed, gs_dict.m_alpha_is_shape);
     boost::hash_combine(seed, gs_dict.m_stroking_alpha);
     boost::hash_combine(seed, gs_dict.m_nonstroking_alpha);
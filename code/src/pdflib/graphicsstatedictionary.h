@@ -9,7 +9,6 @@
 #ifndef __GRAPHICSSTATEDICTIONARY_H_JG_1528__
 #define __GRAPHICSSTATEDICTIONARY_H_JG_1528__
 
-#include <boost/static_assert.hpp>
 #include <boost/shared_ptr.hpp>
 #include <bitset>
 
@@ -37,8 +36,6 @@ public:
         , GS_NUM_DICT_PARAMS
     };
 
-    // if this fail, then hashing must be adjusted
-    BOOST_STATIC_ASSERT(GS_NUM_DICT_PARAMS <= 8*sizeof(unsigned long));
     std::bitset<GS_NUM_DICT_PARAMS>    m_param_changed;
 };
 
@@ -46,6 +43,16 @@ bool operator==(GraphicsStateDictionary const& lhs, GraphicsStateDictionary cons
 bool operator<(GraphicsStateDictionary const& lhs, GraphicsStateDictionary const& rhs);
 size_t hash_value(GraphicsStateDictionary const& gs_dict);
 
+/// equivalence induced by operator<, hash_value() is consistent with it
+struct GraphicsStateDictionaryEquivalent
+{
+    bool operator()(GraphicsStateDictionary const& lhs,
+                    GraphicsStateDictionary const& rhs) const
+    {
+        return !(lhs < rhs) && !(rhs < lhs);
+    }
+};
+
 
 }} //namespace jag::pdf
 
@@ -0,0 +1,84 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+
+#ifndef __HANDLEMAP_H_JAG_1418__
+#define __HANDLEMAP_H_JAG_1418__
+#if defined(_MSC_VER) && (_MSC_VER>=1020)
+#   pragma once
+#endif
+
+#include <resources/interfaces/resourcehandle.h>
+#include <interfaces/constants.h>
+#include <core/generic/assert.h>
+#include <deque>
+
+namespace jag {
+namespace pdf {
+
+/// position of a handle in HandleMap, one based; 0 if the handle has no slot
+template<class T>
+UInt handle_map_key(THandle<T> handle)
+{
+    return handle.id();
+}
+
+/// color space handles carry the color space type in the lower bits
+inline UInt handle_map_key(ColorSpaceHandle handle)
+{
+    return handle.id() >> CS_COLOR_SPACE_ID_START_BIT;
+}
+
+
+/**
+ * @brief Maps resource handles to values.
+ *
+ * Resource handles are issued as consecutive numbers, so the values are kept
+ * in a sequence indexed by the handle. A deque is used as it keeps references
+ * to the values valid when the map grows.
+ */
+template<class Handle, class Value>
+class HandleMap
+{
+public:
+    /// value of the handle, null if not set
+    Value* find(Handle handle)
+    {
+        const UInt key = handle_map_key(handle);
+        if (!key || key > m_slots.size() || !m_slots[key-1].used)
+            return 0;
+
+        return &m_slots[key-1].value;
+    }
+
+    /// sets the value of the handle
+    Value& insert(Handle handle, Value const& value)
+    {
+        const UInt key = handle_map_key(handle);
+        JAG_PRECONDITION(key);
+        if (key > m_slots.size())
+            m_slots.resize(key);
+
+        Slot& slot = m_slots[key-1];
+        slot.value = value;
+        slot.used = true;
+        return slot.value;
+    }
+
+private:
+    struct Slot
+    {
+        Slot() : used(false) {}
+        Value   value;
+        bool    used;
+    };
+
+    std::deque<Slot> m_slots;
+};
+
+}} //namespace jag::pdf
+
+#endif //__HANDLEMAP_H_JAG_1418__
@@ -0,0 +1,103 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+
+#include "precompiled.h"
+#include "iccprofilecache.h"
+#include <core/jstd/memory_stream.h>
+#include <functional>
+
+using namespace jag::jstd;
+
+namespace jag {
+namespace pdf {
+
+namespace
+{
+  // Constructed during static initialization, i.e. before any
+  // document can be created.
+  ICCProfileCache g_icc_profile_cache;
+} // anonymous namespace
+
+
+//
+//
+//
+ICCProfileCache& icc_profile_cache()
+{
+    return g_icc_profile_cache;
+}
+
+
+///
+/// Retrieves the static profile compressed with the given settings, the
+/// profile is compressed if it is not cached yet. The returned data are
+/// valid until the process exits.
+///
+std::vector<Byte> const& ICCProfileCache::compressed(Byte const* profile,
+                                                     size_t size,
+                                                     DeflateParams const& params)
+{
+    const Key key(profile, params);
+    {
+        ScopedLock lock(m_mutex);
+        Entries::const_iterator it = m_entries.find(key);
+        if (it != m_entries.end())
+            return it->second;
+    }
+
+    // compress outside of the lock, a concurrent compression of the same
+    // profile yields the same data
+    MemoryStreamOutput mem;
+    std::auto_ptr<ISeqStreamOutputControl> deflater(
+        create_deflate_stream(mem, params));
+    deflater->write(profile, size);
+    deflater->close();
+
+    ScopedLock lock(m_mutex);
+    std::pair<Entries::iterator,bool> inserted =
+        m_entries.insert(std::make_pair(key, std::vector<Byte>()));
+
+    if (inserted.second)
+        inserted.first->second.assign(mem.data(), mem.data() + mem.tell());
+
+    return inserted.first->second;
+}
+
+
+//
+//
+//
+ICCProfileCache::Key::Key(Byte const* profile_, DeflateParams const& params)
+    : profile(profile_)
+    , level(params.level)
+    , strategy(params.strategy)
+    , factory(deflate_stream_factory())
+{
+}
+
+
+//
+//
+//
+bool ICCProfileCache::Key::operator<(Key const& other) const
+{
+    if (profile != other.profile)
+        return std::less<Byte const*>()(profile, other.profile);
+
+    if (level != other.level)
+        return level < other.level;
+
+    if (strategy != other.strategy)
+        return strategy < other.strategy;
+
+    return std::less<DeflateStreamFactory>()(factory, other.factory);
+}
+
+
+}} // namespace jag::pdf
+
+/** EOF @file */
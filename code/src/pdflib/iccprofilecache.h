@@ -0,0 +1,67 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+
+#ifndef __ICCPROFILECACHE_H_JAG_1312__
+#define __ICCPROFILECACHE_H_JAG_1312__
+#if defined(_MSC_VER) && (_MSC_VER>=1020)
+#   pragma once
+#endif
+
+#include <core/generic/noncopyable.h>
+#include <core/jstd/thread.h>
+#include <core/jstd/deflate.h>
+#include <interfaces/stdtypes.h>
+#include <vector>
+#include <map>
+
+namespace jag {
+namespace pdf {
+
+///
+/// Process-wide cache of compressed static ICC profiles.
+///
+/// Static profiles (the built-in sRGB and AdobeRGB) live as long as the
+/// process, so they are identified by their address. A profile is deflated
+/// once for each compression setting and the compressed data are then
+/// written by all documents as they are.
+///
+class ICCProfileCache
+    : public noncopyable
+{
+public:
+    std::vector<Byte> const& compressed(Byte const* profile,
+                                        size_t size,
+                                        jstd::DeflateParams const& params);
+
+private:
+    struct Key
+    {
+        Key(Byte const* profile, jstd::DeflateParams const& params);
+        bool operator<(Key const& other) const;
+
+        Byte const*                 profile;
+        int                         level;
+        jstd::DeflateStrategy       strategy;
+        jstd::DeflateStreamFactory  factory;
+    };
+
+    typedef std::map<Key, std::vector<Byte> > Entries;
+
+    jstd::Mutex     m_mutex;
+    Entries         m_entries;
+};
+
+
+/// retrieves the process-wide cache of compressed profiles
+ICCProfileCache& icc_profile_cache();
+
+
+}} // namespace jag::pdf
+
+#endif //__ICCPROFILECACHE_H_JAG_1312__
+
+/** EOF @file */
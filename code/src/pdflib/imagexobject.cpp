@@ -15,6 +15,7 @@
 #include "resourcemanagement.h"
 #include "defines.h"
 #include "xobjectutils.h"
+#include "preparedimage.h"
 #include <msg_pdflib.h>
 #include <resources/resourcebox/resourcepodarrays.h>
 #include <resources/interfaces/resourcectx.h>
@@ -34,12 +35,50 @@ using namespace boost;
 namespace jag {
 namespace pdf {
 
+namespace
+{
+  // Estimates the size of the image samples. Components of an indexed color
+  // space are not counted.
+  ULong samples_size(IImageData const& img_data, ColorSpaceHandle cs_handle,
+                     IColorSpaceMan const& cs_man, unsigned bpc)
+  {
+      int ncomponents = 1;
+      if (is_valid(cs_handle))
+      {
+          switch(color_space_type(cs_handle))
+          {
+          case CS_DEVICE_RGB:
+          case CS_CALRGB:
+          case CS_CIELAB:
+              ncomponents = 3;
+              break;
+
+          case CS_DEVICE_CMYK:
+              ncomponents = 4;
+              break;
+
+          case CS_ICCBASED:
+              ncomponents = cs_man.num_components(cs_handle);
+              break;
+
+          default:
+              ;
+          }
+      }
+
+      return static_cast<ULong>(img_data.width()) * img_data.height()
+          * ncomponents * bpc / 8;
+  }
+} // anonymous namespace
+
 
 //////////////////////////////////////////////////////////////////////////
 ImageXObject::ImageXObject(DocWriterImpl& doc, IImageData const* img_data)
     : m_img_data(img_data)
     , m_doc(doc)
     , m_actual_bpc(0)
+    , m_flate_predictor_colors(0)
+    , m_prepared(doc.res_mgm().take_prepared_image(img_data->handle()))
 {
     // setup stream filter according to image type
     switch(m_img_data->format())
@@ -51,9 +90,28 @@ ImageXObject::ImageXObject(DocWriterImpl& doc, IImageData const* img_data)
         }
         break;
 
+    case IMAGE_FORMAT_PNG:
+        if (!m_prepared && use_flate_predicted_data(m_doc, *m_img_data))
+        {
+            m_flate_predictor_colors = m_img_data->flate_predictor_colors();
+            const StreamFilter filter = STREAM_FILTER_FLATE_ENCODED;
+            m_content_stream.reset(m_doc.create_content_stream(&filter, 1).release());
+            break;
+        }
+        // fall through
+
+
     default:
+        if (m_prepared && m_prepared->compressed())
+        {
+            // deflated when the image was loaded
+            const StreamFilter filter = STREAM_FILTER_FLATE_ENCODED;
+            m_content_stream.reset(m_doc.create_content_stream(&filter, 1).release());
+            break;
+        }
+
         // use default stream settings
-        m_content_stream.reset(m_doc.create_content_stream().release());
+        m_content_stream.reset(m_doc.create_content_stream(STREAM_CLASS_IMAGE).release());
     }
 
     JAG_ASSERT(m_content_stream);
@@ -65,6 +123,40 @@ ImageXObject::ImageXObject(DocWriterImpl& doc, IImageData const* img_data)
 }
 
 
+///
+/// Finds out whether the image data can be copied to the content stream
+/// without decoding them.
+///
+bool ImageXObject::use_flate_predicted_data(DocWriterImpl const& doc,
+                                            IImageData const& img_data)
+{
+    if (!img_data.flate_predictor_colors())
+        return false;
+
+    // respect the client's wish to have uncompressed images, either the
+    // whole document or the image class (level 0)
+    if (!doc.is_compressed(STREAM_CLASS_IMAGE))
+        return false;
+
+    // 16-bits supported since 1.5, such data must be decoded and
+    // converted for older versions
+    return img_data.bits_per_component() <= 8 || doc.version() >= 5;
+}
+
+
+///
+/// Bits per component of the image data in the document.
+///
+unsigned ImageXObject::output_bits_per_component(DocWriterImpl const& doc,
+                                                 IImageData const& img_data)
+{
+    // 16-bits supported since 1.5
+    return img_data.bits_per_component()>8 && doc.version()<5
+        ? 8
+        : img_data.bits_per_component();
+}
+
+
 //
 //
 //
@@ -117,6 +209,10 @@ void ImageXObject::prepare_image_mask()
 //////////////////////////////////////////////////////////////////////////
 void ImageXObject::on_before_output()
 {
+    // the image mask might read the same source as the preparation
+    if (m_prepared)
+        m_prepared->wait();
+
     // ensure that a mask represent by an indirect object is outputted
     // before this object; do so by taking a reference to the mask
     if (m_img_data->image_mask_type() == IMT_IMAGE)
@@ -163,14 +259,44 @@ void ImageXObject::on_before_output()
     }
 
 
-    // 16-bits supported since 1.5
-    m_actual_bpc = m_img_data->bits_per_component()>8 && m_doc.version()<5
-        ? 8
-        : m_img_data->bits_per_component();
+    m_actual_bpc = m_prepared
+        ? m_prepared->bits_per_component()
+        : output_bits_per_component(m_doc, *m_img_data);
+
+    // jpeg data are not converted, check it before the output begins
+    if (m_img_data->format() == IMAGE_FORMAT_JPEG
+        && m_actual_bpc < m_img_data->bits_per_component())
+    {
+        throw exception_invalid_value(msg_16bits_since_15()) << JAGLOC;
+    }
 
-    // send image data to the content stream
-    if (!m_img_data->output_image(m_content_stream->stream(), m_actual_bpc))
+    // the image data are sent when the content stream is being output,
+    // pulled data are never buffered
+    m_content_stream->set_data_writer(
+        boost::bind(&ImageXObject::output_data, this, _1),
+        samples_size(*m_img_data, m_cs_handle,
+                     *m_doc.resource_ctx().color_space_man(), m_actual_bpc),
+        m_img_data->data_pulled());
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void ImageXObject::output_data(ISeqStreamOutput& out)
+{
+    if (m_prepared)
+    {
+        m_prepared->output(out);
+        m_prepared.reset();
+    }
+    else if (m_flate_predictor_colors)
+    {
+        JAG_ASSERT(m_actual_bpc == m_img_data->bits_per_component());
+        m_img_data->output_flate_predicted(out);
+    }
+    else if (!m_img_data->output_image(out, m_actual_bpc))
+    {
         throw exception_invalid_value(msg_16bits_since_15()) << JAGLOC;
+    }
 }
 
 
@@ -202,6 +328,19 @@ void ImageXObject::on_write(ObjFmt& fmt)
     }
 
 
+    if (m_flate_predictor_colors)
+    {
+        fmt
+            .dict_key("DecodeParms")
+            .dict_start()
+            .dict_key("Predictor").space().output(15)
+            .dict_key("Colors").space().output(m_flate_predictor_colors)
+            .dict_key("BitsPerComponent").space().output(m_actual_bpc)
+            .dict_key("Columns").space().output(m_img_data->width())
+            .dict_end()
+        ;
+    }
+
     output_image_mask(fmt);
     xobject_output(fmt.fmt_basic(), m_img_data->interpolate(), m_doc.exec_context().config());
     xobject_output(fmt.fmt_basic(), m_img_data->decode());
@@ -15,11 +15,13 @@
 #include "indirectobjectfwd.h"
 #include <resources/interfaces/resourcehandle.h>
 #include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
 #include <boost/intrusive_ptr.hpp>
 
 namespace jag
 {
 class IImageData;
+class ISeqStreamOutput;
 
 namespace pdf {
 
@@ -28,6 +30,7 @@ class ContentStream;
 class ImageXObjectSoftMask;
 class ImageXObjectMask;
 class ObjFmt;
+class PreparedImage;
 
 class ImageXObject
     : public IndirectObjectFwd
@@ -36,11 +39,15 @@ public:
     DEFINE_VISITABLE;
     ImageXObject(DocWriterImpl& doc, IImageData const*img_data);
 
+    static bool use_flate_predicted_data(DocWriterImpl const& doc, IImageData const& img_data);
+    static unsigned output_bits_per_component(DocWriterImpl const& doc, IImageData const& img_data);
+
 private: // IndirectObjectFwd
     void on_before_output();
 
 private:
     void on_write(ObjFmt& fmt);
+    void output_data(ISeqStreamOutput& out);
     void output_image_mask(ObjFmt& fmt);
     void output_rendering_intent(ObjFmt& fmt);
     void prepare_image_mask();
@@ -55,6 +62,10 @@ private:
     IndirectObjectRef                   m_cs_ref;
     ColorSpaceHandle                    m_cs_handle;
     unsigned                            m_actual_bpc;
+    // non-zero if image data are copied with PNG predictors
+    UInt                                m_flate_predictor_colors;
+    // set if the image data have been prepared when the image was loaded
+    boost::shared_ptr<PreparedImage>    m_prepared;
 };
 
 }} //namespace jag::pdf
@@ -26,7 +26,7 @@ namespace pdf {
 //////////////////////////////////////////////////////////////////////////
 ImageXObjectMask::ImageXObjectMask(DocWriterImpl& doc, IImageMaskData const& img_mask)
     : m_img_mask(img_mask)
-    , m_content_stream(doc.create_content_stream())
+    , m_content_stream(doc.create_content_stream(STREAM_CLASS_IMAGE))
     , m_doc(doc)
     , m_actual_bpc(0)
     , m_mask_type(detect_mask_type(img_mask, doc))
@@ -51,14 +51,27 @@ void ImageXObjectMask::on_before_output()
             ? (std::min)(m_img_mask.bits_per_component(), 8u)
             : m_img_mask.bits_per_component();
         ;
+    }
+
+    // the mask data are sent when the content stream is being output
+    const unsigned bpc = m_mask_type == DMT_SOFT ? m_actual_bpc : 1;
+    m_content_stream->set_data_writer(
+        boost::bind(&ImageXObjectMask::output_data, this, _1),
+        static_cast<ULong>(m_img_mask.width()) * m_img_mask.height() * bpc / 8);
+}
+
 
-        // send mask data to the content stream
-        if (!m_img_mask.output_mask(m_content_stream->stream(), m_actual_bpc))
+//////////////////////////////////////////////////////////////////////////
+void ImageXObjectMask::output_data(ISeqStreamOutput& out)
+{
+    if (m_mask_type == DMT_SOFT)
+    {
+        if (!m_img_mask.output_mask(out, m_actual_bpc))
             throw exception_invalid_value(msg_16bits_since_15()) << JAGLOC;
     }
     else
     {
-        m_img_mask.output_mask(m_content_stream->stream());
+        m_img_mask.output_mask(out);
     }
 }
 
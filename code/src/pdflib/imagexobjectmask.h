@@ -19,6 +19,7 @@ namespace jag
 {
 
 class IImageMaskData;
+class ISeqStreamOutput;
 
 namespace pdf {
 
@@ -36,6 +37,7 @@ public:
 private:
     void on_write(ObjFmt& fmt);
     void on_before_output();
+    void output_data(ISeqStreamOutput& out);
 
 private:
     IImageMaskData const&             m_img_mask;
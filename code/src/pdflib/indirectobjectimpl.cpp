@@ -9,6 +9,7 @@
 #include "indirectobjectimpl.h"
 #include "docwriterimpl.h"
 #include "objfmt.h"
+#include "objectstreams.h"
 #include <core/jstd/crt.h>
 #include <interfaces/streams.h>
 #include <core/generic/assert.h>
@@ -36,6 +37,28 @@ void IndirectObjectImpl::output_definition()
 
     if (on_before_output_definition())
     {
+        if (-1 == m_object_number)
+        {
+            // nobody refers to this object yet, so it can become an alias
+            // of an equal object
+            const Int equal_object = on_find_equal_object();
+            if (-1 != equal_object)
+            {
+                m_object_number = equal_object;
+                return;
+            }
+        }
+
+        ObjectStreams* object_streams = m_doc.object_streams();
+        if (object_streams && object_streams->can_store(object_type()))
+        {
+            // the object is listed in cross ref table by the object stream
+            object_streams->object_start(*this);
+            on_output_definition();
+            object_streams->object_end(*this);
+            return;
+        }
+
         ULong stream_offset = object_writer().object_start(object_type(), *this);
         on_output_definition();
         object_writer().object_end(object_type(), *this);
@@ -70,6 +93,12 @@ bool IndirectObjectImpl::on_before_output_definition()
     return true;
 }
 
+//////////////////////////////////////////////////////////////////////////
+Int IndirectObjectImpl::on_find_equal_object()
+{
+    return -1;
+}
+
 //////////////////////////////////////////////////////////////////////////
 DocWriterImpl& IndirectObjectImpl::doc() const
 {
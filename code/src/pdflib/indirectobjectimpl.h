@@ -65,6 +65,18 @@ protected:
      */
     virtual bool on_before_output_definition();
 
+    /**
+     * @brief Invoked right before an object which has not been referenced
+     *        yet is output.
+     *
+     * Allows the derivee to reuse an already written object with the same
+     * definition instead of writing itself.
+     *
+     * @return number of the object to reuse, or -1 if the derivee is to be
+     *         written
+     */
+    virtual Int on_find_equal_object();
+
     //////////////////////////////////////////////////////////////////////////
     virtual ObjectType object_type() const {
         return PDFOBJ_UNKNOWN;
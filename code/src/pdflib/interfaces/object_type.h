@@ -13,7 +13,9 @@ namespace jag { namespace pdf
 
 enum ObjectType
 {
-    PDFOBJ_UNKNOWN
+      PDFOBJ_UNKNOWN
+    , PDFOBJ_STREAM            // stream objects
+    , PDFOBJ_ENCRYPTION_DICT   // encryption dictionary
 };
 
 }} //namespace jag::pdf
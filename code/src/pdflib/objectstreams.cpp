@@ -0,0 +1,166 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+
+#include "precompiled.h"
+#include "objectstreams.h"
+#include "docwriterimpl.h"
+#include "contentstream.h"
+#include "objfmt.h"
+#include "interfaces/indirect_object.h"
+#include <core/jstd/memory_stream.h>
+#include <core/jstd/crt.h>
+#include <core/generic/assert.h>
+#include <core/generic/macros.h>
+
+#include <boost/bind.hpp>
+#include <memory>
+
+namespace jag {
+namespace pdf {
+
+namespace
+{
+  void output_object_stream_dict(ObjFmt& writer, Int num_objects, UInt first)
+  {
+      writer
+          .dict_key("Type").output("ObjStm")
+          .dict_key("N").space().output(num_objects)
+          .dict_key("First").space().output(first);
+  }
+
+} // anonymous namespace
+
+
+
+//////////////////////////////////////////////////////////////////////////
+ObjectStreams::ObjectStreams(DocWriterImpl& doc)
+    : m_doc(doc)
+    , m_in_object(false)
+{
+    m_objects.reserve(MAX_OBJECTS);
+    reset_buffer();
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+ObjectStreams::~ObjectStreams()
+{
+}
+
+
+/**
+ * @brief Whether an object of the given type can be stored in an object stream.
+ *
+ * Streams and the encryption dictionary must be direct children of the file
+ * body.
+ */
+bool ObjectStreams::can_store(ObjectType type) const
+{
+    return type == PDFOBJ_UNKNOWN;
+}
+
+
+/**
+ * @brief Starts an object; until object_end() is invoked the object is
+ *        expected to be written using object_writer().
+ */
+void ObjectStreams::object_start(IIndirectObject& obj)
+{
+    JAG_PRECONDITION(!m_in_object);
+    JAG_PRECONDITION(!obj.generation_number());
+
+    m_objects.push_back(
+        std::make_pair(obj.object_number(), static_cast<UInt>(m_data->tell())));
+    m_in_object = true;
+}
+
+
+/**
+ * @brief Finishes the current object, outputs the object stream if it is full.
+ */
+void ObjectStreams::object_end(IIndirectObject& obj)
+{
+    JAG_PRECONDITION(m_in_object);
+    JAG_ASSERT(m_objects.back().first == obj.object_number());
+    JAG_UNUSED_FUNCTION_ARGUMENT(obj);
+
+    m_writer->raw_text("\n");
+    m_in_object = false;
+
+    if (m_objects.size() >= MAX_OBJECTS)
+        flush();
+}
+
+
+/**
+ * @brief Retrieves the writer of the object being output.
+ *
+ * @return writer, or null if no object is being output.
+ */
+ObjFmt* ObjectStreams::object_writer() const
+{
+    return m_in_object ? m_writer.get() : 0;
+}
+
+
+/**
+ * @brief Outputs the collected objects as an object stream.
+ */
+void ObjectStreams::flush()
+{
+    JAG_PRECONDITION(!m_in_object);
+    if (m_objects.empty())
+        return;
+
+    std::auto_ptr<ContentStream> stream(m_doc.create_content_stream());
+    ISeqStreamOutput& out = stream->stream();
+
+    // header - pairs of object number and offset relative to the first object
+    const int buffer_length = 32;
+    char buffer[buffer_length];
+    for(size_t i=0; i<m_objects.size(); ++i)
+    {
+        int written = jstd::snprintf(buffer, buffer_length, "%d %u ",
+                                     m_objects[i].first, m_objects[i].second);
+        out.write(buffer, written);
+    }
+
+    const UInt first = static_cast<UInt>(out.tell());
+    out.write(m_data->data(), m_data->tell());
+
+    stream->set_writer_callback(
+        boost::bind(output_object_stream_dict, _1,
+                    static_cast<Int>(m_objects.size()), first));
+
+    const Int stream_number = stream->object_number();
+    stream->output_definition();
+
+    for(size_t i=0; i<m_objects.size(); ++i)
+    {
+        m_doc.add_compressed_object(
+            m_objects[i].first, stream_number, static_cast<Int>(i));
+    }
+
+    m_objects.clear();
+    reset_buffer();
+}
+
+
+//
+//
+//
+void ObjectStreams::reset_buffer()
+{
+    m_writer.reset();
+    m_data.reset(new jstd::MemoryStreamOutput);
+    m_writer.reset(new ObjFmt(*m_data, 0, m_doc.utf8_to_16be_stream()));
+}
+
+
+}} //namespace jag::pdf
+
+/** EOF @file */
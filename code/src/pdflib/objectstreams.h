@@ -0,0 +1,66 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+
+#ifndef __OBJECTSTREAMS_H_JAG_2312__
+#define __OBJECTSTREAMS_H_JAG_2312__
+#if defined(_MSC_VER) && (_MSC_VER>=1020)
+#   pragma once
+#endif
+
+#include "interfaces/object_type.h"
+#include <interfaces/stdtypes.h>
+#include <core/generic/noncopyable.h>
+#include <boost/scoped_ptr.hpp>
+#include <vector>
+
+namespace jag {
+namespace jstd { class MemoryStreamOutput; }
+
+namespace pdf {
+
+class DocWriterImpl;
+class IIndirectObject;
+class ObjFmt;
+
+/**
+ * @brief Collects indirect objects into object streams (PDF 1.5, 3.4.6).
+ *
+ * Objects are formatted to memory by a writer of their own and an object
+ * stream is output once MAX_OBJECTS objects are collected or flush() is
+ * invoked. The objects are listed in the cross reference section when their
+ * object stream is output.
+ */
+class ObjectStreams
+    : public noncopyable
+{
+public:
+    explicit ObjectStreams(DocWriterImpl& doc);
+    ~ObjectStreams();
+
+    bool can_store(ObjectType type) const;
+    void object_start(IIndirectObject& obj);
+    void object_end(IIndirectObject& obj);
+    ObjFmt* object_writer() const;
+    void flush();
+
+private:
+    void reset_buffer();
+
+private:
+    enum { MAX_OBJECTS = 100 };
+
+    DocWriterImpl&                             m_doc;
+    boost::scoped_ptr<jstd::MemoryStreamOutput> m_data;
+    boost::scoped_ptr<ObjFmt>                  m_writer;
+    // object numbers and their offsets in m_data
+    std::vector<std::pair<Int, UInt> >         m_objects;
+    bool                                       m_in_object;
+};
+
+}} //namespace jag::pdf
+
+#endif //__OBJECTSTREAMS_H_JAG_2312__
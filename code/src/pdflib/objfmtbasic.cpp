@@ -14,6 +14,7 @@
 #include <core/generic/macros.h>
 #include <core/generic/assert.h>
 #include <core/jstd/crt.h>
+#include <core/jstd/conversions.h>
 #include <core/jstd/streamhelpers.h>
 #include <core/jstd/tracer.h>
 #include <core/errlib/msg_writer.h>
@@ -277,39 +278,6 @@ namespace
 
 
 
-///
-/// substitution table for non-printing ASCII characters
-///
-unsigned char const printable_map[256]={
- //00 //01 //02 //03 //04 //05 //06 //07 //08 //09
-    1,   1,   1,   1,   1,   1,   1,   1, 'b', 't', //000
-  'n',   1, 'f', 'r',   1,   1,   1,   1,   1,   1, //010
-    1,   1,   1,   1,   1,   1,   1,   1,   1,   1, //020
-    1,   1,   1,   1,   1,   1,   1,   1,   1,   1, //030
-  '(', ')',   1,   1,   1,   1,   1,   1,   1,   1, //040
-    1,   1,   1,   1,   1,   1,   1,   1,   1,   1, //050
-    1,   1,   1,   1,   1,   1,   1,   1,   1,   1, //060
-    1,   1,   1,   1,   1,   1,   1,   1,   1,   1, //070
-    1,   1,   1,   1,   1,   1,   1,   1,   1,   1, //080
-    1,   1,'\\',   1,   1,   1,   1,   1,   1,   1, //090
-    1,   1,   1,   1,   1,   1,   1,   1,   1,   1, //100
-    1,   1,   1,   1,   1,   1,   1,   1,   1,   1, //110
-    1,   1,   1,   1,   1,   1,   1,   1,   1,   1, //120
-    1,   1,   1,   1,   1,   1,   1,   1,   1,   1, //130
-    1,   1,   1,   1,   1,   1,   1,   1,   1,   1, //140
-    1,   1,   1,   1,   1,   1,   1,   1,   1,   1, //150
-    1,   1,   1,   1,   1,   1,   1,   1,   1,   1, //160
-    1,   1,   1,   1,   1,   1,   1,   1,   1,   1, //170
-    1,   1,   1,   1,   1,   1,   1,   1,   1,   1, //180
-    1,   1,   1,   1,   1,   1,   1,   1,   1,   1, //190
-    1,   1,   1,   1,   1,   1,   1,   1,   1,   1, //200
-    1,   1,   1,   1,   1,   1,   1,   1,   1,   1, //210
-    1,   1,   1,   1,   1,   1,   1,   1,   1,   1, //220
-    1,   1,   1,   1,   1,   1,   1,   1,   1,   1, //230
-    1,   1,   1,   1,   1,   1,   1,   1,   1,   1, //240
-    1,   1,   1,   1,   1,   1                      //250
-};
-
 /**
  * @brief ISeqStreamOutput based string formatting
  *
@@ -332,27 +300,49 @@ private:
 };
 
 /// implements string formatting
+///
+/// Runs of bytes which need no escaping are gathered together with the
+/// escape sequences in a local buffer, which is then written at once.
 void StringStream::write(void const* data, jag::ULong size)
 {
     unsigned char const *curr = static_cast<unsigned char const*>(data);
-    unsigned char const *end = curr + size;
-    unsigned char const *first_unprocessed = curr;
+    unsigned char const *const end = curr + size;
 
-    unsigned char buff[2] = { '\\', '?' };
-    for(;curr!=end; ++curr)
+    const size_t buffer_size = 512;
+    Char buffer[buffer_size];
+    Char* out = buffer;
+    while(curr != end)
     {
-        if (printable_map[*curr] != 1)
+        const size_t run = literal_string_run(curr, end - curr);
+        if (run > static_cast<size_t>(buffer + buffer_size - out))
+        {
+            // too long to be buffered
+            if (out != buffer)
+                m_next.write(buffer, static_cast<jag::UInt>(out - buffer));
+            m_next.write(curr, static_cast<jag::UInt>(run));
+            out = buffer;
+        }
+        else
+        {
+            memcpy(out, curr, run);
+            out += run;
+        }
+
+        curr += run;
+        if (curr == end)
+            break;
+
+        if (buffer + buffer_size - out < 2)
         {
-            if (curr != first_unprocessed)
-                m_next.write(first_unprocessed, static_cast<jag::UInt>(curr-first_unprocessed));
-            buff[1] = printable_map[*curr];
-            m_next.write(buff, 2);
-            first_unprocessed = curr+1;
+            m_next.write(buffer, static_cast<jag::UInt>(out - buffer));
+            out = buffer;
         }
+        *out++ = '\\';
+        *out++ = literal_string_escape(*curr++);
     }
 
-    if (curr != first_unprocessed)
-        m_next.write(first_unprocessed, static_cast<jag::UInt>(curr-first_unprocessed));
+    if (out != buffer)
+        m_next.write(buffer, static_cast<jag::UInt>(out - buffer));
 }
 
 
@@ -365,20 +355,17 @@ bool is_ascii7(jag::Char const* txt, size_t length)
 
   void hexlify_data(ISeqStreamOutput& out_stream, Char const* txt, size_t length)
   {
-      const int buffer_length = 128;
-      Char buffer[buffer_length+1];
+      const size_t chunk_length = 256;
+      Char buffer[2 * chunk_length];
+      Byte const* data = jag_reinterpret_cast<Byte const*>(txt);
 
-      for(size_t j=0; j<length;)
+      while(length)
       {
-          Char *buffer_next = buffer;
-          while((j<length) && (buffer+buffer_length!=buffer_next))
-          {
-              jstd::snprintf(buffer_next, 3, "%02x",
-                             static_cast<unsigned int>(
-                                 static_cast<unsigned char>(txt[j++])));
-              buffer_next+=2;
-          }
-          out_stream.write(buffer, static_cast<UInt>(buffer_next-buffer));
+          const size_t chunk = (min)(length, chunk_length);
+          Char* buffer_end = format_hex(buffer, data, chunk);
+          out_stream.write(buffer, static_cast<UInt>(buffer_end - buffer));
+          data += chunk;
+          length -= chunk;
       }
   }
 
@@ -507,9 +494,8 @@ ObjFmtBasic& ObjFmtBasic::dict_end()
 */
 ObjFmtBasic& ObjFmtBasic::output(Int value)
 {
-    const int buffer_length = std::numeric_limits<Int>::digits10 + 3;
-    Char buffer[buffer_length];
-    int written = jstd::snprintf(buffer, buffer_length, "%d", value);
+    Char buffer[jstd::FORMAT_INT_MAX_SIZE];
+    int written = jstd::format_int(buffer, value);
     m_stream->write(buffer, written);
     return *this;
 }
@@ -527,9 +513,8 @@ ObjFmtBasic& ObjFmtBasic::output(UInt value)
     // -2^31 <= allowed-integral-value <= 2^31-1
     value = (min)(static_cast<size_t>(0xffffffffu), value);
 
-    const int buffer_length = std::numeric_limits<Int>::digits10 + 3;
-    Char buffer[buffer_length];
-    int written = jstd::snprintf(buffer, buffer_length, "%d", value);
+    Char buffer[jstd::FORMAT_INT_MAX_SIZE];
+    int written = jstd::format_int(buffer, static_cast<Int>(value));
     m_stream->write(buffer, written);
     return *this;
 }
@@ -562,7 +547,7 @@ ObjFmtBasic& ObjFmtBasic::output(double value)
     else
     {
         Char buffer[PDF_DOUBLE_MAX_SIZE];
-        int written = snprintf_pdf_double(buffer, PDF_DOUBLE_MAX_SIZE, value);
+        int written = format_pdf_double(buffer, value);
         m_stream->write(buffer, written);
             
 //         value = (min)(value,3.403e+38);
@@ -944,16 +929,26 @@ ObjFmtBasic& ObjFmtBasic::unenc_text_string_hex(Char const* txt, size_t length)
 ObjFmtBasic& ObjFmtBasic::string_object_2b(UInt16 const* txt, size_t length)
 {
     JAG_PRECONDITION(length);
-    const int buffer_size = 32;
-    char buffer[buffer_size];
+    // the brackets are written together with the first and the last chunk
+    const size_t chunk_length = 128;
+    Char buffer[4 * chunk_length + 2];
+    Char* out = buffer;
 
-    m_stream->write("<", 1);
-    for(UInt16 const*const end=txt+length; txt!=end; ++txt)
+    *out++ = '<';
+    for(;;)
     {
-        jstd::snprintf(buffer, buffer_size, "%04x", (unsigned)*txt);
-        m_stream->write(buffer, 4);
+        const size_t chunk = (min)(length, chunk_length);
+        out = format_hex(out, txt, chunk);
+        txt += chunk;
+        length -= chunk;
+        if (!length)
+            break;
+
+        m_stream->write(buffer, static_cast<UInt>(out - buffer));
+        out = buffer;
     }
-    m_stream->write(">", 1);
+    *out++ = '>';
+    m_stream->write(buffer, static_cast<UInt>(out - buffer));
     return *this;
 }
 
@@ -964,28 +959,11 @@ ObjFmtBasic& ObjFmtBasic::string_object_2b(UInt16 const* txt, size_t length)
  */
 ObjFmtBasic& ObjFmtBasic::string_object_2b(Char const* start, Char const* end)
 {
-    JAG_TBD; // not actually tested
-
     JAG_PRECONDITION(start != end);
     JAG_PRECONDITION(!((end-start)%2));
 
-    const int buffer_size = 64;
-    char buffer[buffer_size];
-    char* curr=buffer;
-
-
     m_stream->write("<", 1);
-    for(; start!=end; ++start, curr+=2)
-    {
-        if (curr==end)
-        {
-            m_stream->write(buffer, buffer_size);
-            curr=buffer;
-        }
-        jstd::snprintf(curr, buffer_size, "%02x", static_cast<int>(*start));
-    }
-    if (curr!=buffer)
-        m_stream->write(buffer, curr-buffer);
+    hexlify_data(*m_stream, start, end - start);
     m_stream->write(">", 1);
     return *this;
 }
@@ -51,18 +51,13 @@ bool PageObject::on_before_output_definition()
             output_resource_dictionary(doc(), res_list, page_height);
     }
 
-    // output annotations
+    // reserve annotations, they are written by the catalog
     if (!m_annotations.empty())
     {
-        TRACE_DETAIL << "Writing indirect annotations.";
         JAG_ASSERT(m_annotation_refs.empty());
         m_annotation_refs.reserve(m_annotations.size());
         for(int i=static_cast<int>(m_annotations.size()); i--;)
-        {
             m_annotation_refs.push_back(IndirectObjectRef(m_annotations[i]));
-            m_annotations[i].output_definition();
-        }
-        m_annotations.clear();
     }
 
     return true;
@@ -44,6 +44,10 @@ public:
     Dimension const& dimension() const { return m_dimension; }
     void page_end();
 
+    /// Annotations referenced by this page, they are written later by the
+    /// catalog as they might refer to pages which do not exist yet.
+    boost::ptr_vector<AnnotationImpl>& annotations() { return m_annotations; }
+
 public: //IPage
     void annotation_uri(Double x, Double y, Double width, Double height, Char const* uri, Char const* style);
     void annotation_goto(Double x, Double y, Double width, Double height, Char const* destination, Char const* style);
@@ -8,7 +8,6 @@
 #include "precompiled.h"
 #include "page_tree.h"
 #include "page_tree_node.h"
-#include "page_object.h"
 #include <core/generic/refcountedimpl.h>
 #include <boost/ref.hpp>
 using namespace boost;
@@ -26,14 +25,15 @@ PageTreeBuilder::PageTreeBuilder(DocWriterImpl& doc, int t)
 
 
 //
-//
+// Builds the upper levels of the tree above the nodes which are parents of
+// the already written pages.
 //
 TreeNode::TreeNodePtr PageTreeBuilder::BuildPageTree(
-    boost::ptr_vector<PageObject>& nodes)
+    boost::ptr_vector<PageTreeNode>& nodes)
 {
-    // copy page objects to buffer_a
+    // copy page parents to buffer_a
     m_buffer_a.reserve(nodes.size());
-    boost::ptr_vector<PageObject>::iterator it;
+    boost::ptr_vector<PageTreeNode>::iterator it;
     for (it = nodes.begin(); it != nodes.end(); ++it)
     {
         TreeNode::TreeNodePtr data(&*it);
@@ -47,13 +47,12 @@ TreeNode::TreeNodePtr PageTreeBuilder::BuildPageTree(
     m_dest = &m_buffer_b;
 
     // build tree levels, one at a time
-    do
+    while(m_source->size() > 1)
     {
         BuildOneTreeLevel();
         std::swap(m_source, m_dest);
         m_dest->resize(0);
     }
-    while(m_source->size() > 1);
 
     if (m_source->size() == 1)
     {
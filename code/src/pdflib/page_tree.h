@@ -18,14 +18,13 @@ namespace jag { namespace pdf
 {
 
 //fwd
-class PageObject;
 class DocWriterImpl;
 
 class PageTreeBuilder
 {
 public:
     PageTreeBuilder(DocWriterImpl& body, int t);
-    TreeNode::TreeNodePtr BuildPageTree(boost::ptr_vector<PageObject>& nodes);
+    TreeNode::TreeNodePtr BuildPageTree(boost::ptr_vector<PageTreeNode>& nodes);
 
 private:
     void BuildOneTreeLevel();
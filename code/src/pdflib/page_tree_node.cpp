@@ -9,6 +9,7 @@
 #include "page_tree_node.h"
 #include "docwriterimpl.h"
 #include "objfmt.h"
+#include <core/generic/containerhelpers.h>
 
 namespace jag { namespace pdf
 {
@@ -20,6 +21,19 @@ PageTreeNode::PageTreeNode(DocWriterImpl& doc)
 };
 
 
+void PageTreeNode::add_page(IndirectObjectRef const& page)
+{
+    JAG_PRECONDITION(!num_kids());
+    m_pages.push_back(page);
+}
+
+
+int PageTreeNode::num_leafs() const
+{
+    return TreeNodeImpl::num_leafs() + static_cast<int>(m_pages.size());
+}
+
+
 void  PageTreeNode::on_output_definition()
 {
     ObjFmt& writer = object_writer();
@@ -33,17 +47,24 @@ void  PageTreeNode::on_output_definition()
         writer.dict_key("Parent").space().ref(*parent());
 
     writer.dict_key("Kids");
-    writer.array_start();
-    for (int i=0; i<num_kids(); ++i)
+    if (m_pages.empty())
     {
-        if (i != 0)
-            writer.space();
+        writer.array_start();
+        for (int i=0; i<num_kids(); ++i)
+        {
+            if (i != 0)
+                writer.space();
 
-        writer.ref(*kid_at(i));
+            writer.ref(*kid_at(i));
+        }
+        writer.array_end();
     }
-    writer.array_end()
-        .dict_end()
-    ;
+    else
+    {
+        writer.ref_array(address_of(m_pages), m_pages.size());
+    }
+
+    writer.dict_end();
 }
 
 }} //namespace jag::pdf
@@ -9,6 +9,7 @@
 #define __PAGE_TREE_NODE_H__2721837
 
 #include "indirectobjectimpl.h"
+#include "indirectobjectref.h"
 #include "treenodeimpl.h"
 
 
@@ -19,15 +20,25 @@ namespace jag { namespace pdf
 class DocWriterImpl;
 
 /// node of page tree
+///
+/// A node either has other nodes as kids or it is a parent of already written
+/// pages, in which case only the references to the pages are kept.
 class PageTreeNode
     : public TreeNodeImpl
 {
 public:
     DEFINE_VISITABLE
     explicit PageTreeNode(DocWriterImpl& doc);
+    void add_page(IndirectObjectRef const& page);
+
+public: // TreeNode
+    int num_leafs() const;
 
 private: // IndirectObjectImpl
     void on_output_definition();
+
+private:
+    ObjectRefs  m_pages;
 };
 
 }} //namespace jag::pdf
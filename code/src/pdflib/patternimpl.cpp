@@ -76,6 +76,7 @@ TilingPatternImpl::TilingPatternImpl(DocWriterImpl& doc,
     : PatternBase(pattern_str)
     , m_doc(doc)
     , m_canvas(checked_static_cast<CanvasImpl*>(canvas))
+    , m_paint_type(0)
 {
     if (m_canvas->content_stream().is_empty())
         throw exception_invalid_value(msg_pattern_no_canvas()) << JAGLOC;
@@ -127,6 +128,11 @@ TilingPatternImpl::~TilingPatternImpl()
 //
 bool TilingPatternImpl::is_colored() const
 {
+    // once the pattern canvas is written its object writer is gone, so use
+    // the paint type captured just before the output
+    if (m_paint_type)
+        return m_paint_type == 1;
+
     return m_canvas->content_stream().object_writer().operator_categories() &
         (OPCAT_COLOR | OPCAT_SHADING_PATTERNS | OPCAT_XOBJECT_IMAGE);
 }
@@ -137,6 +143,7 @@ bool TilingPatternImpl::is_colored() const
 //
 void TilingPatternImpl::on_before_output()
 {
+    m_paint_type = is_colored() ? 1 : 2;
     ContentStream& content_stream = m_canvas->content_stream();
 
     content_stream.set_writer_callback(
@@ -154,7 +161,7 @@ void TilingPatternImpl::on_write(ObjFmt& fmt)
     fmt
         .dict_key("Type").output("Pattern")
         .dict_key("PatternType").space().output(1)
-        .dict_key("PaintType").space().output(is_colored() ? 1 : 2)
+        .dict_key("PaintType").space().output(m_paint_type)
         .dict_key("TilingType").space().output(m_tiling_type)
         .dict_key("XStep").space().output(m_step[0])
         .dict_key("YStep").space().output(m_step[1])
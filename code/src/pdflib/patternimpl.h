@@ -93,6 +93,7 @@ private:
     DocWriterImpl&        m_doc;
     CanvasImpl*         m_canvas;
     IndirectObjectRef    m_res_dict;
+    int                 m_paint_type; // 0 until output, then 1 or 2
 
     PatternTilingType   m_tiling_type;
     Double                m_bbox[4];
@@ -10,9 +10,13 @@
 #include "docwriterimpl.h"
 #include "generic_dictionary.h"
 #include "objfmt.h"
+#include "crossrefsection.h"
+#include "defines.h"
 
 #include <jagpdf/detail/version.h>
 #include <core/jstd/crt.h>
+#include <core/jstd/deflate.h>
+#include <core/jstd/memory_stream.h>
 #include <core/generic/stringutils.h>
 #include <interfaces/configinternal.h>
 #include <interfaces/execcontext.h>
@@ -35,7 +39,92 @@ void PDFFileTrailer::output(
 {
     ObjFmt& writer = m_doc.object_writer();
     writer.raw_text("trailer\n")
+        .dict_start();
+
+    output_entries(writer, xref_size, root, encrypt);
+
+    writer.dict_end();
+    output_startxref(writer, xref_offset);
+}
+
+
+/**
+ * @brief Outputs the cross-reference stream which replaces both the
+ *        cross-reference table and the trailer (3.4.7).
+ *
+ * The stream is formatted here rather than by ContentStream as it lists
+ * itself and must not be encrypted.
+ *
+ * @param stream_offset where the stream object starts
+ * @param xref objects to list
+ */
+void PDFFileTrailer::output_xref_stream(
+      ULong stream_offset
+    , CrossReferenceSection& xref
+    , IIndirectObject const& root
+    , IIndirectObject* encrypt)
+{
+    const Int object_number = static_cast<Int>(m_doc.assign_next_object_number());
+    xref.add_indirect_object(object_number, 0, static_cast<Int>(stream_offset));
+
+    const bool compressed =
+        m_doc.exec_context().config().get_int("doc.compressed")
+        && m_doc.deflate_params(STREAM_CLASS_CONTENT).level;
+
+    jstd::MemoryStreamOutput data;
+    if (compressed)
+    {
+        std::auto_ptr<ISeqStreamOutputControl> deflate(
+            jstd::create_deflate_stream(data, m_doc.deflate_params(STREAM_CLASS_CONTENT)));
+        xref.output_stream_data(*deflate, stream_offset);
+        deflate->close();
+    }
+    else
+    {
+        xref.output_stream_data(data, stream_offset);
+    }
+
+    const Int widths[] = {
+        CrossReferenceSection::STREAM_TYPE_BYTES,
+        CrossReferenceSection::STREAM_FIELD2_BYTES,
+        CrossReferenceSection::STREAM_FIELD3_BYTES
+    };
+
+    ObjFmt& writer = m_doc.object_writer();
+    writer
+        .output(object_number).raw_text(" 0 obj")
         .dict_start()
+        .dict_key("Type").output("XRef");
+
+    output_entries(writer, xref.num_entries(), root, encrypt);
+
+    writer.dict_key("W");
+    output_array(writer, widths, widths + 3);
+
+    if (compressed)
+        writer.dict_key("Filter").output("FlateDecode");
+
+    writer
+        .dict_key("Length").space().output(static_cast<UInt>(data.tell()))
+        .dict_end()
+        .raw_text("stream\n")
+        .raw_bytes(data.data(), static_cast<size_t>(data.tell()))
+        .raw_text("\nendstream\nendobj\n");
+
+    output_startxref(writer, static_cast<UInt>(stream_offset));
+}
+
+
+//
+// Outputs entries common to the trailer and the cross-reference stream.
+//
+void PDFFileTrailer::output_entries(
+      ObjFmt& writer
+    , UInt xref_size
+    , IIndirectObject const& root
+    , IIndirectObject* encrypt)
+{
+    writer
         .dict_key("Size").space().output(xref_size)
         .dict_key("Root").space().ref(root);
 
@@ -54,9 +143,15 @@ void PDFFileTrailer::output(
         .unenc_text_string_hex(static_cast<Char const*>(static_cast<void const*>(&file_id[0])), 16)
         .array_end()
     ;
+}
 
 
-    writer.dict_end()
+//
+//
+//
+void PDFFileTrailer::output_startxref(ObjFmt& writer, UInt xref_offset)
+{
+    writer
         .raw_text("\nstartxref\n")
         .output(xref_offset)
         .raw_text("\n%%EOF\n")
@@ -18,6 +18,8 @@ namespace jag { namespace pdf
 {
 class DocWriterImpl;
 class IIndirectObject;
+class CrossReferenceSection;
+class ObjFmt;
 
 class PDFFileTrailer
     : public noncopyable
@@ -25,10 +27,13 @@ class PDFFileTrailer
 public:
     explicit PDFFileTrailer(DocWriterImpl& doc);
     void output(UInt xref_offset, UInt xref_size, IIndirectObject const& root, IIndirectObject* encrypt);
+    void output_xref_stream(ULong stream_offset, CrossReferenceSection& xref, IIndirectObject const& root, IIndirectObject* encrypt);
     void before_output();
 
 private:
     GenericDictionary& info_dictionary();
+    void output_entries(ObjFmt& writer, UInt xref_size, IIndirectObject const& root, IIndirectObject* encrypt);
+    void output_startxref(ObjFmt& writer, UInt xref_offset);
 
 private:
     boost::scoped_ptr<GenericDictionary>  m_info;
@@ -0,0 +1,150 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+
+#include "precompiled.h"
+#include "preparedimage.h"
+#include <msg_pdflib.h>
+#include <resources/interfaces/imagedata.h>
+#include <core/jstd/threadpool.h>
+#include <core/errlib/errlib.h>
+#include <core/generic/assert.h>
+
+#include <boost/bind.hpp>
+
+namespace jag {
+namespace pdf {
+
+/**
+ * @brief Constructor, submits the preparation.
+ *
+ * @param img_data image, must outlive this object
+ * @param bits_per_component requested precision of the image data
+ * @param deflate_params compression of the data, null if not compressed
+ * @param stream_pool provides memory for the data
+ * @param pool executes the preparation
+ */
+PreparedImage::PreparedImage(IImageData const& img_data,
+                             unsigned bits_per_component,
+                             jstd::DeflateParams const* deflate_params,
+                             boost::shared_ptr<jstd::StreamPool> const& stream_pool,
+                             jstd::ThreadPool& pool)
+    : m_img_data(img_data)
+    , m_bits_per_component(bits_per_component)
+    , m_compressed(deflate_params != 0)
+    , m_deflate_params(deflate_params ? *deflate_params : jstd::DeflateParams())
+    , m_data(stream_pool)
+    , m_done(false)
+    , m_failure(FAILURE_NONE)
+{
+    pool.submit(boost::bind(&PreparedImage::prepare, this));
+}
+
+
+//
+//
+//
+PreparedImage::~PreparedImage()
+{
+    // the worker might be still writing
+    wait_done();
+}
+
+
+//
+// Executed by a worker thread.
+//
+void PreparedImage::prepare()
+{
+    Failure failure = FAILURE_NONE;
+    try
+    {
+        if (m_compressed)
+        {
+            std::auto_ptr<ISeqStreamOutputControl> deflater(
+                jstd::create_deflate_stream(m_data, m_deflate_params));
+
+            if (m_img_data.output_image(*deflater, m_bits_per_component))
+                deflater->close();
+            else
+                failure = FAILURE_BITS;
+        }
+        else if (!m_img_data.output_image(m_data, m_bits_per_component))
+        {
+            failure = FAILURE_BITS;
+        }
+    }
+    catch(exception& exc)
+    {
+        failure = FAILURE_EXCEPTION;
+        m_error = exc.clone();
+    }
+    catch(...)
+    {
+        failure = FAILURE_EXCEPTION;
+    }
+
+    {
+        jstd::ScopedLock lock(m_mutex);
+        m_failure = failure;
+        m_done = true;
+    }
+    m_done_cond.notify_all();
+}
+
+
+//
+//
+//
+void PreparedImage::wait_done()
+{
+    jstd::ScopedLock lock(m_mutex);
+    while (!m_done)
+        m_done_cond.wait(m_mutex);
+}
+
+
+/**
+ * @brief Waits until the data are prepared.
+ *
+ * @exception exception_invalid_value if the requested precision is not
+ *            supported by the image
+ * @exception exception_operation_failed if the preparation failed, the cause
+ *            is chained if known
+ */
+void PreparedImage::wait()
+{
+    wait_done();
+
+    switch (m_failure)
+    {
+    case FAILURE_BITS:
+        throw exception_invalid_value(msg_16bits_since_15()) << JAGLOC;
+
+    case FAILURE_EXCEPTION:
+        throw exception_operation_failed(msg_cannot_prepare_image(), m_error.get()) << JAGLOC;
+
+    default:
+        ;
+    }
+}
+
+
+/**
+ * @brief Writes the prepared data and releases them.
+ */
+void PreparedImage::output(ISeqStreamOutput& out)
+{
+    wait();
+    for(int i=0; i<m_data.num_segments(); ++i)
+        out.write(m_data.segment(i), m_data.segment_length(i));
+
+    m_data.close();
+}
+
+}} //namespace jag::pdf
+
+/** EOF @file */
@@ -0,0 +1,76 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+
+#ifndef __PREPAREDIMAGE_H_JAG_1748__
+#define __PREPAREDIMAGE_H_JAG_1748__
+#if defined(_MSC_VER) && (_MSC_VER>=1020)
+#   pragma once
+#endif
+
+#include <core/jstd/thread.h>
+#include <core/jstd/streampool.h>
+#include <core/jstd/deflate.h>
+#include <core/generic/noncopyable.h>
+#include <boost/shared_ptr.hpp>
+#include <memory>
+
+namespace jag {
+class IImageData;
+class ISeqStreamOutput;
+class exception;
+namespace jstd { class ThreadPool; }
+
+namespace pdf {
+
+/**
+ * @brief Image data decoded, converted and compressed on a worker thread.
+ *
+ * The preparation is submitted to the thread pool in the constructor. The
+ * data are obtained by IImageData::output_image() and optionally deflated,
+ * i.e. they are the same as if they were written to the image content
+ * stream. wait() must be called before anything else reads the image source.
+ */
+class PreparedImage
+    : public noncopyable
+{
+public:
+    PreparedImage(IImageData const& img_data,
+                  unsigned bits_per_component,
+                  jstd::DeflateParams const* deflate_params,
+                  boost::shared_ptr<jstd::StreamPool> const& stream_pool,
+                  jstd::ThreadPool& pool);
+    ~PreparedImage();
+
+    unsigned bits_per_component() const { return m_bits_per_component; }
+    bool compressed() const { return m_compressed; }
+    void wait();
+    void output(ISeqStreamOutput& out);
+
+private:
+    void prepare();
+    void wait_done();
+
+private:
+    IImageData const&             m_img_data;
+    const unsigned                m_bits_per_component;
+    const bool                    m_compressed;
+    const jstd::DeflateParams     m_deflate_params;
+    jstd::SegmentedStreamOutput   m_data;
+
+    // guarded by m_mutex
+    jstd::Mutex                   m_mutex;
+    jstd::Condition               m_done_cond;
+    bool                          m_done;
+    // set by the worker if the preparation failed
+    enum Failure { FAILURE_NONE, FAILURE_BITS, FAILURE_EXCEPTION };
+    Failure                       m_failure;
+    std::auto_ptr<exception>      m_error;
+};
+
+}} //namespace jag::pdf
+
+#endif //__PREPAREDIMAGE_H_JAG_1748__
@@ -13,6 +13,7 @@
 #include "docwriterimpl.h"
 #include "imagexobject.h"
 #include "imagexobjectmask.h"
+#include "preparedimage.h"
 #include "graphicsstatedictonaryobject.h"
 #include "fontdictionary.h"
 #include "fontdescriptor.h"
@@ -33,6 +34,7 @@
 #include <resources/interfaces/imagedata.h>
 #include <resources/interfaces/imagemaskdata.h>
 #include <resources/interfaces/resourcectx.h>
+#include <interfaces/execcontext.h>
 #include <core/generic/checked_cast.h>
 #include <core/generic/refcountedimpl.h>
 #include <boost/mem_fn.hpp>
@@ -273,15 +275,12 @@ namespace
   template<class Handle, class Map, class Table>
   IndirectObjectRef const& resource_ref(Handle handle, Map& map, Table& table)
   {
-      typename Map::iterator it = map.find(handle);
-      if (it == map.end())
-      {
-          IIndirectObject& resource(table.lookup(handle));
-          resource.output_definition();
-          it = map.insert(std::make_pair(handle,
-                                         IndirectObjectRef(resource))).first;
-      }
-      return it->second;
+      if (IndirectObjectRef const* ref = map.find(handle))
+          return *ref;
+
+      IIndirectObject& resource(table.lookup(handle));
+      resource.output_definition();
+      return map.insert(handle, IndirectObjectRef(resource));
   };
 } // namespace
 
@@ -565,21 +564,66 @@ IndirectObjectRef const& ResourceManagement::image_reference(ImageHandle image_i
 }
 
 
+/**
+ * @brief starts preparing the image data on the image thread pool
+ *
+ * Only images whose data are decoded or compressed when outputted are
+ * prepared. The prepared data are picked up by the image object. Pulled
+ * image data are not prepared, they are written straight to the output so
+ * that the image is never held in memory as a whole. Neither are borrowed
+ * data, their release callback runs on the thread writing the document.
+ */
+void ResourceManagement::prepare_image(IImageData const& img_data)
+{
+    jstd::ThreadPool* pool = m_doc.image_pool();
+    if (!pool
+        || img_data.data_pulled()
+        || img_data.borrows_data()
+        || img_data.format() == IMAGE_FORMAT_JPEG
+        || ImageXObject::use_flate_predicted_data(m_doc, img_data))
+    {
+        return;
+    }
+
+    // the image is written uncompressed if the image class has level 0
+    const bool compressed = m_doc.is_compressed(STREAM_CLASS_IMAGE);
+
+    m_prepared_images[img_data.handle()].reset(
+        new PreparedImage(
+            img_data,
+            ImageXObject::output_bits_per_component(m_doc, img_data),
+            compressed ? &m_doc.deflate_params(STREAM_CLASS_IMAGE) : 0,
+            m_doc.stream_pool(),
+            *pool));
+}
+
+
+/**
+ * @brief retrieves prepared data of the image, if any
+ *
+ * The data can be taken only once.
+ */
+boost::shared_ptr<PreparedImage>
+ResourceManagement::take_prepared_image(ImageHandle image_id)
+{
+    boost::shared_ptr<PreparedImage> result;
+    PreparedImageMap::iterator it = m_prepared_images.find(image_id);
+    if (it != m_prepared_images.end())
+    {
+        result.swap(it->second);
+        m_prepared_images.erase(it);
+    }
+    return result;
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 // Functions
 //////////////////////////////////////////////////////////////////////////
 
 IndirectObjectRef const& ResourceManagement::function_ref(FunctionHandle handle)
 {
-    FunctionsMap::iterator it = m_functions.find(handle);
-    if (it == m_functions.end())
-    {
-        IIndirectObject& fn(m_fun_table.lookup(handle));
-        fn.output_definition();
-        it = m_functions.insert(
-            std::make_pair(handle, IndirectObjectRef(fn))).first;
-    }
-    return it->second;
+    return resource_ref(handle, m_functions, m_fun_table);
 }
 
 
@@ -639,15 +683,21 @@ IndirectObjectRef const&  ResourceManagement::image_mask_reference(ImageMaskHand
 //////////////////////////////////////////////////////////////////////////
 GraphicsStateHandle ResourceManagement::register_graphics_state(GraphicsStateDictionary const& gs_dict)
 {
-    GraphicsStateToHandle::iterator it = m_gs_to_handle.find(gs_dict);
-    if (it == m_gs_to_handle.end())
-    {
-        GraphicsStateHandle result(m_handle_to_gs.register_resource(gs_dict));
-        m_gs_to_handle.insert(GraphicsStateToHandle::value_type(gs_dict, result));
-        return result;
-    }
+    return GraphicsStateHandle(
+        static_cast<UInt>(m_gs_dicts.intern(gs_dict).first + 1));
+}
 
-    return it->second;
+
+//
+//
+//
+GraphicsStateDictionary const&
+ResourceManagement::graphics_state(GraphicsStateHandle gs_handle) const
+{
+    if (!is_valid(gs_handle) || gs_handle.id() > m_gs_dicts.size())
+        throw exception_invalid_value(msg_invalid_object_handle()) << JAGLOC;
+
+    return m_gs_dicts.value(index_from_handle(gs_handle));
 }
 
 /**
@@ -660,12 +710,10 @@ GraphicsStateHandle ResourceManagement::register_graphics_state(GraphicsStateDic
  */
 IndirectObjectRef ResourceManagement::graphics_state_reference(GraphicsStateHandle gs_handle)
 {
-    typedef GSHandleToGSDict::record_t const& (GSHandleToGSDict::*overload_t)(GSHandleToGSDict::handle_t) const;
-
     return reference_provider<GraphicsStateDictionaryObject>(
         gs_handle
         , m_gs_to_obj
-        , bind(static_cast<overload_t>(&GSHandleToGSDict::resource_record), &m_handle_to_gs, _1)
+        , bind(&ResourceManagement::graphics_state, this, _1)
         , m_doc
    );
 }
@@ -17,13 +17,15 @@
 #include <resources/utils/resourcetable.h>
 
 #include <resources/interfaces/resourcehandle.h>
-#include "resourcehandletable.h"
 #include "graphicsstatedictionary.h"
+#include "handlemap.h"
+#include <core/generic/interner.h>
 
 #include <boost/range/iterator_range.hpp>
 #include <boost/iterator/transform_iterator.hpp>
 #include <boost/functional/hash.hpp>
 #include <boost/ptr_container/ptr_vector.hpp>
+#include <boost/shared_ptr.hpp>
 #include <map>
 #include <vector>
 
@@ -38,6 +40,7 @@ namespace pdf {
 class DocWriterImpl;
 class TilingPatternImpl;
 class FunctionObj;
+class PreparedImage;
 
 
 /**
@@ -96,6 +99,8 @@ public:
     // images & masks
     IndirectObjectRef const& image_reference(ImageHandle image_id);
     IndirectObjectRef const& image_mask_reference(ImageMaskHandle imagemask);
+    void prepare_image(IImageData const& img_data);
+    boost::shared_ptr<PreparedImage> take_prepared_image(ImageHandle image_id);
 
     // functions
     IndirectObjectRef const& function_ref(FunctionHandle handle);
@@ -128,6 +133,7 @@ public:
 
 private:
     IImageMan& image_man();
+    GraphicsStateDictionary const& graphics_state(GraphicsStateHandle gs_handle) const;
     class PatternVisitorTopdown;
 
 private:
@@ -135,10 +141,14 @@ private:
     FontManagement                      m_font_management;
 
     // image stuff
-    typedef std::map<ImageHandle,IndirectObjectRef>    ImageMap;
+    typedef HandleMap<ImageHandle,IndirectObjectRef>    ImageMap;
     ImageMap    m_images;
 
-    typedef std::map<ImageMaskHandle,IndirectObjectRef>    ImageMaskMap;
+    // images being prepared on worker threads, not referenced yet
+    typedef std::map<ImageHandle,boost::shared_ptr<PreparedImage> > PreparedImageMap;
+    PreparedImageMap    m_prepared_images;
+
+    typedef HandleMap<ImageMaskHandle,IndirectObjectRef>    ImageMaskMap;
     ImageMaskMap    m_image_masks;
 
     typedef std::map<ImageSoftMaskHandle,IndirectObjectRef>    ImageSoftMaskMap;
@@ -146,18 +156,18 @@ private:
 
 
     // color spaces
-    typedef std::map<ColorSpaceHandle,IndirectObjectRef> ColorSpacesMap;
+    typedef HandleMap<ColorSpaceHandle,IndirectObjectRef> ColorSpacesMap;
     ColorSpacesMap m_color_spaces;
 
     // functions
-    typedef std::map<FunctionHandle,IndirectObjectRef> FunctionsMap;
+    typedef HandleMap<FunctionHandle,IndirectObjectRef> FunctionsMap;
     FunctionsMap m_functions;
     resources::ResourceTable<FunctionHandle,
                              IIndirectObject,
                              boost::ptr_vector<IIndirectObject> > m_fun_table;
 
     // patterns
-    typedef std::map<PatternHandle,IndirectObjectRef> PatternsMap;
+    typedef HandleMap<PatternHandle,IndirectObjectRef> PatternsMap;
     PatternsMap m_patterns;
     resources::ResourceTable<PatternHandle,
                              IIndirectObject,
@@ -171,7 +181,7 @@ private:
     PatternsByPageHeight m_patterns_by_page_height;
 
     // shadings
-    typedef std::map<ShadingHandle,IndirectObjectRef> ShadingsMap;
+    typedef HandleMap<ShadingHandle,IndirectObjectRef> ShadingsMap;
     ShadingsMap m_shadings;
     resources::ResourceTable<ShadingHandle,
                              IIndirectObject,
@@ -180,15 +190,13 @@ private:
     PatternToShadingMap m_pattern_to_shading;
 
 
-    // graphics states - two copies are stored per handle
-    // one in GraphicsStateToHandle, the second in ResourceHandleTable<>
-    typedef std::map<GraphicsStateDictionary, GraphicsStateHandle> GraphicsStateToHandle;
-    GraphicsStateToHandle m_gs_to_handle;
-
-    typedef ResourceHandleTable<GraphicsStateHandle,GraphicsStateDictionary> GSHandleToGSDict;
-    GSHandleToGSDict m_handle_to_gs;
+    // graphics states, a handle is the index of the dictionary plus one
+    typedef Interner<GraphicsStateDictionary,
+                     boost::hash<GraphicsStateDictionary>,
+                     GraphicsStateDictionaryEquivalent> GraphicsStateDicts;
+    GraphicsStateDicts m_gs_dicts;
 
-    typedef std::map<GraphicsStateHandle,IndirectObjectRef>    GSStateToObject;
+    typedef HandleMap<GraphicsStateHandle,IndirectObjectRef>    GSStateToObject;
     GSStateToObject m_gs_to_obj;
 
     typedef std::map<ICanvas*, CanvasRecord> CanvasMap;
@@ -39,7 +39,7 @@ namespace
   *
   *  @param Handler object performing object output and providing reference to it
   *  @param handle resource handle
-  *  @param res_map handle to object reference mapping
+  *  @param res_map handle to object reference mapping (HandleMap)
   *  @param to_resource function object transforming handle to a resource
   *  @param doc document
   */
@@ -51,16 +51,13 @@ namespace
       , DocWriterImpl& doc
  )
   {
-      typename Map::iterator it = res_map.find(handle);
-      if (it == res_map.end())
-      {
-          typename ToResource::result_type resource(to_resource(handle));
-          Handler handler(doc, resource);
-          handler.output_definition();
-          it = res_map.insert(std::make_pair(handle, res_to_objref<Handler>(handler))).first;
-      }
+      if (IndirectObjectRef const* ref = res_map.find(handle))
+          return *ref;
 
-      return it->second;
+      typename ToResource::result_type resource(to_resource(handle));
+      Handler handler(doc, resource);
+      handler.output_definition();
+      return res_map.insert(handle, res_to_objref<Handler>(handler));
   }
 
 
@@ -35,6 +35,9 @@ public: //IIndirectObject
     void on_output_definition();
     DEFINE_VISITABLE;
 
+protected: //IndirectObjectImpl
+    ObjectType object_type() const { return PDFOBJ_ENCRYPTION_DICT; }
+
 public: //ISecurityHandler
     int    key_bit_length() const { return m_key_bit_length; }
     Byte const* encoding_key() { return m_enc_key; }
@@ -34,7 +34,7 @@ void ToUnicode::output_definition(DocWriterImpl& doc, GidAndUnicode const* gids,
     JAG_PRECONDITION(gids);
     JAG_PRECONDITION(num_gids);
 
-    std::auto_ptr<ContentStream> content_stream(doc.create_content_stream());
+    std::auto_ptr<ContentStream> content_stream(doc.create_content_stream(STREAM_CLASS_FONT));
     // source information: range of charcode ->[unicode, ..., unicode]
     //  - maybe sorted by charcodes as it is iterator over std::map (confirm this)
     //  - now, only range charcode->unicode is provided (i.e. no support for ligatures)
@@ -24,10 +24,9 @@ void TreeNodeImpl::add_kid(TreeNodePtr kid)
 {
     m_kids.push_back(kid);
 
-    if (!kid->num_kids())
-        m_leafs += 1;
-
-    m_leafs += kid->num_leafs();
+    // a kid without any leafs is a leaf itself
+    const int kid_leafs = kid->num_leafs();
+    m_leafs += kid_leafs ? kid_leafs : 1;
     kid->set_parent(this);
 }
 
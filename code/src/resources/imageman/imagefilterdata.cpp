@@ -37,6 +37,8 @@ ImageFilterData::ImageFilterData(
     , m_decode(m_img_filter->decode() ? *m_img_filter->decode() : img_data->decode())
     , m_interpolate(img_data->interpolate())
     , m_gamma(img_data->has_gamma() ? img_data->gamma() : m_img_filter->gamma())
+    , m_flate_predictor_colors(m_img_filter->flate_predictor_colors())
+    , m_borrows_data(img_data->borrows_data())
     , m_res_ctx(res_ctx)
 {
     // handle dpi
@@ -125,6 +127,23 @@ bool ImageFilterData::output_image(ISeqStreamOutput& out, unsigned max_bits) con
     return result;
 }
 
+//////////////////////////////////////////////////////////////////////////
+void ImageFilterData::output_flate_predicted(ISeqStreamOutput& out) const
+{
+    JAG_ASSERT_MSG(m_img_filter, "image_bits() already invoked");
+    JAG_PRECONDITION(m_flate_predictor_colors);
+    m_img_filter->output_flate_predicted(out);
+    m_img_filter.reset();
+}
+
+//////////////////////////////////////////////////////////////////////////
+void ImageFilterData::release_borrowed_data()
+{
+    // the filter reads the borrowed data
+    if (m_borrows_data)
+        m_img_filter.reset();
+}
+
 //////////////////////////////////////////////////////////////////////////
 shared_ptr<IStreamInput> ImageFilterData::data_stream() const
 {
@@ -45,8 +45,14 @@ public: //IImageData
     ColorKeyMaskArray const& color_key_mask() const { return m_color_key_mask; }
     ImageMaskHandle image_mask() const { return m_image_mask_handle; }
     bool output_image(ISeqStreamOutput& fout, unsigned max_bits) const;
+    UInt flate_predictor_colors() const { return m_flate_predictor_colors; }
+    void output_flate_predicted(ISeqStreamOutput& fout) const;
     ImageFormat format() const { return m_img_type; }
     boost::shared_ptr<IStreamInput> data_stream() const;
+    Char const* file_name() const { return ""; }
+    bool data_pulled() const { return false; }
+    bool borrows_data() const { return m_borrows_data; }
+    void release_borrowed_data();
 
     ImageHandle alternate_for_printing() const { return m_alternate; }
     RenderingIntentType rendering_intent() const { return m_rendering_intent; }
@@ -87,6 +93,8 @@ private:
     InterpolateType        m_interpolate;
     Double              m_gamma;
     ImageHandle         m_handle;
+    UInt                m_flate_predictor_colors;
+    bool                m_borrows_data;
 
 private:
     boost::weak_ptr<IResourceCtx>  m_res_ctx;
@@ -16,7 +16,6 @@
 #include <resources/interfaces/resourcectx.h>
 #include <resources/interfaces/imagedata.h>
 #include <resources/interfaces/colorspaceman.h>
-#include <resources/resourcebox/binresources.h>
 #include <interfaces/streams.h>
 #include <resources/resourcebox/resourcepodarrays.h>
 #include <msg_resources.h>
@@ -555,12 +554,23 @@ ImageJPEG::ImageJPEG(
       IImageData const* img_spec
     , shared_ptr<IResourceCtx> res_ctx
 )
-    : m_in_stream(img_spec->data_stream())
-    , m_res_ctx(res_ctx)
+    : m_res_ctx(res_ctx)
 
 {
     JAG_PRECONDITION(img_spec->format() == IMAGE_FORMAT_JPEG);
 
+    // a mapped file is parsed without system calls and its data can be
+    // written to the output at once
+    if (*img_spec->file_name())
+    {
+        m_mapped_file.reset(new jstd::MMapFileStreamInput(img_spec->file_name()));
+        m_in_stream = m_mapped_file;
+    }
+    else
+    {
+        m_in_stream = img_spec->data_stream();
+    }
+
     if (!ImageJPEG::ping(*m_in_stream))
         throw exception_invalid_input(msg_not_jpeg_format()) << JAGLOC;
 
@@ -601,16 +611,7 @@ void ImageJPEG::prepare_color_space()
     else if (m_info.exif_srgb)
     {
         // Exif specifies sRGB
-        intrusive_ptr<IICCBased> spec(
-            res_ctx->color_space_man()->define_iccbased());
-
-        spec->num_components(3);
-
-        std::auto_ptr<ISeqStreamInput> mem_stream(
-            create_stream_from_memory(binres::icc_srgb, binres::icc_srgb_size));
-
-        spec->icc_profile_stream(mem_stream);
-        m_info.cs_handle = res_ctx->color_space_man()->color_space_load(spec);
+        m_info.cs_handle = res_ctx->color_space_man()->register_srgb();
     }
 
     // CMYK needs a decode array to invert values
@@ -627,8 +628,15 @@ bool ImageJPEG::output_image(ISeqStreamOutput& dest, unsigned max_bits) const
     if (max_bits < (unsigned)m_info.bits_per_component)
         return false;
 
-    m_in_stream->seek(0, OFFSET_FROM_BEGINNING);
-    copy_stream(*m_in_stream, dest);
+    if (m_mapped_file)
+    {
+        dest.write(m_mapped_file->data(), m_mapped_file->size());
+    }
+    else
+    {
+        m_in_stream->seek(0, OFFSET_FROM_BEGINNING);
+        copy_stream(*m_in_stream, dest);
+    }
     return true;
 }
 
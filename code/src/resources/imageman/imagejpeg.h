@@ -12,6 +12,7 @@
 
 #include "interfaces/imagefilter.h"
 #include <core/jstd/memory_stream.h>
+#include <core/jstd/mmap.h>
 #include <core/errlib/errlib.h>
 #include <resources/interfaces/imagemaskdata.h>
 #include <boost/weak_ptr.hpp>
@@ -119,6 +120,10 @@ public: // IImageFilter
         JAG_INTERNAL_ERROR;
 //         return boost::intrusive_ptr<IImageMaskData>();
     }
+    UInt flate_predictor_colors() const { return 0; }
+    void output_flate_predicted(ISeqStreamOutput& /*dest*/) const {
+        JAG_INTERNAL_ERROR;
+    }
 
     boost::shared_ptr<IStreamInput> data_stream() const { JAG_ASSERT(!"suspicious"); return m_in_stream; }
 
@@ -153,6 +158,8 @@ private:
 private:
     jpeg_info_t                      m_info;
     boost::shared_ptr<IStreamInput>  m_in_stream;
+    // set if the image is read from a file
+    boost::shared_ptr<jstd::MMapFileStreamInput> m_mapped_file;
     boost::weak_ptr<IResourceCtx>    m_res_ctx;
     DecodeArray                      m_decode;
 };
@@ -14,11 +14,13 @@
 #include "imagejpeg.h"
 #include <msg_resources.h>
 #include <resources/interfaces/imagemaskdata.h>
+#include <resources/interfaces/resourcectx.h>
 #include <core/generic/refcountedimpl.h>
 #include <core/generic/checked_cast.h>
 #include <core/errlib/errlib.h>
 #include <boost/intrusive_ptr.hpp>
 #include <boost/checked_delete.hpp>
+#include <boost/mem_fn.hpp>
 
 using namespace boost;
 
@@ -76,7 +78,9 @@ IImageData const* ImageManImpl::image_load(IImageDef* image, IExecContext const&
         m_image_spec_list.lookup(
             checked_static_cast<ImageSpecImpl*>(image)));
 
-    it->check_consistency(exec_ctx);
+    it->check_consistency(
+        exec_ctx,
+        *shared_ptr<IResourceCtx>(m_resource_ctx)->color_space_man());
 
     // based on spec create IImageData and put it to the resource table
     IImageData* result = 0;
@@ -155,6 +159,15 @@ IImageMaskData const& ImageManImpl::image_mask_data(ImageMaskHandle imagemask) c
 }
 
 
+
+//////////////////////////////////////////////////////////////////////////
+void ImageManImpl::release_borrowed_data()
+{
+    m_image_spec_list.for_each(mem_fn(&ImageSpecImpl::release_borrowed_data));
+    m_images.for_each(mem_fn(&IImageData::release_borrowed_data));
+}
+
+
 // --------------------------------------------------------------------
 //                      Free functions
 
@@ -13,21 +13,25 @@
 #include <resources/interfaces/resourcectx.h>
 #include <resources/interfaces/colorspaceman.h>
 #include <resources/interfaces/colorspaces.h>
-#include <resources/resourcebox/binresources.h>
 #include <msg_resources.h>
 #include <core/jstd/memory_stream.h>
 #include <core/jstd/streamhelpers.h>
+#include <core/jstd/zlib_stream.h>
 #include <core/jstd/tracer.h>
 #include <core/errlib/msg_writer.h>
 #include <core/errlib/msgcodes.h>
 #include <core/errlib/errlib.h>
 #include <core/generic/refcountedimpl.h>
 #include <core/generic/floatpointtools.h>
+#include <core/generic/noncopyable.h>
 #include <interfaces/streams.h>
 #include <interfaces/execcontext.h>
 #include <interfaces/configinternal.h>
 
+#include <zlib.h>
 #include <boost/scoped_array.hpp>
+#include <boost/bind.hpp>
+#include <algorithm>
 #include <utility>
 
 using namespace jag::jstd;
@@ -40,30 +44,190 @@ namespace resources {
 namespace
 {
   const Double g_matte_1[4] = { 0.0, 0.0, 0.0, 0.0 };
+
+  // approximate size of a strip of rows decoded at once
+  const UInt g_strip_bytes = 64 * 1024;
+
+  /// reads exactly size bytes from a PNG stream
+  void read_png_bytes(IStreamInput& in, void* data, ULong size)
+  {
+      Byte* dest = static_cast<Byte*>(data);
+      ULong nr_read = 0;
+      while (size)
+      {
+          in.read(dest, size, &nr_read);
+          if (!nr_read)
+              throw exception_invalid_input(
+                  msg_error_while_processing_png_format("unexpected end of stream"))
+                  << JAGLOC;
+          dest += nr_read;
+          size -= nr_read;
+      }
+  }
+
+  /// retrieves a 4-byte unsigned integer in network byte order
+  inline ULong png_uint32(Byte const* data)
+  {
+      return (static_cast<ULong>(data[0]) << 24)
+          | (static_cast<ULong>(data[1]) << 16)
+          | (static_cast<ULong>(data[2]) << 8)
+          | static_cast<ULong>(data[3]);
+  }
 }
 
 
 struct ImagePNG::PNGData
 {
+    void alloc(UInt rowbytes, UInt nr_rows)
+    {
+        m_rowbytes = rowbytes;
+        m_image_data.reset(new png_byte[nr_rows*rowbytes]);
+        m_rows.reset(new png_bytep[nr_rows]);
+        for (UInt i=0; i<nr_rows; ++i)
+            m_rows[i] = m_image_data.get() + i*rowbytes;
+    }
+
     UInt                    m_rowbytes;
     scoped_array<png_byte>    m_image_data;
     scoped_array<png_bytep>    m_rows;
 };
 
 
+/**
+ * @brief Alpha channel of a non-interlaced image, split off while the image is
+ *        being decoded.
+ *
+ * The channel is kept at its native depth and compressed, the image may be
+ * prepared long before the soft mask is outputted. If the soft mask is
+ * outputted before the image, nothing is kept and the mask decodes the stream
+ * itself.
+ */
+struct ImagePNG::AlphaChannel
+{
+    explicit AlphaChannel(DeflateParams const& params_)
+        : params(params_)
+        , mask_output(false)
+        , complete(false)
+    {}
+
+    DeflateParams       params;
+    MemoryStreamOutput  data;         // zlib stream
+    std::auto_ptr<ISeqStreamOutputControl> deflater;  // writes to data
+    bool                mask_output;  // the soft mask has been outputted
+    bool                complete;     // data hold the whole channel
+};
+
+
+
+//////////////////////////////////////////////////////////////////////////
+// PNGReader
+//////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief libpng decoding session of a PNG stream
+ *
+ * The constructor reads the image info. Multiple readers can decode the same
+ * stream as each of them keeps its own position in the stream.
+ */
+class ImagePNG::PNGReader
+    : public noncopyable
+{
+public:
+    explicit PNGReader(shared_ptr<IStreamInput> const& stream);
+    ~PNGReader();
+
+    png_structp png() const { return m_png; }
+    png_infop info() const { return m_png_info; }
+
+    UInt start_rows();
+    void read_rows(png_bytepp rows, UInt nr_rows);
+    void finish();
+    void report_error();
+
+    template<class Fn>
+    void for_each_strip(UInt height, Fn fn);
+
+private:
+    void release_lib_data();
+
+    static void user_error_handler(png_structp png_struct, png_const_charp msg);
+    static void user_warning_handler(png_structp png_struct, png_const_charp msg);
+    static void user_read_data(png_structp png_struct, png_bytep data, png_size_t length);
+
+private:
+    shared_ptr<IStreamInput>  m_stream;
+    ULong                     m_offset;
+    png_structp               m_png;
+    png_infop                 m_png_info;
+    scoped_ptr<exception>     m_exception;
+};
+
+
+/**
+ * @brief Decodes a non-interlaced image by strips of rows.
+ *
+ * @param height  image height
+ * @param fn  invoked as fn(data, rowbytes, nr_rows) for each strip
+ */
+template<class Fn>
+void ImagePNG::PNGReader::for_each_strip(UInt height, Fn fn)
+{
+    const UInt rowbytes = start_rows();
+    const UInt strip_rows = (std::max)(1U, (std::min)(height, g_strip_bytes/rowbytes));
+
+    PNGData strip;
+    strip.alloc(rowbytes, strip_rows);
+    for (UInt row=0; row<height; row+=strip_rows)
+    {
+        const UInt nr_rows = (std::min)(strip_rows, height-row);
+        read_rows(strip.m_rows.get(), nr_rows);
+        fn(strip.m_image_data.get(), rowbytes, nr_rows);
+    }
+
+    finish();
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 // SoftMaskPNG
 //////////////////////////////////////////////////////////////////////////
 
+namespace
+{
+  /// sends the alpha channel of a strip of rows to an output stream
+  void output_alpha_channel(ISeqStreamOutput& dest,
+                            img_data_dict_t const& idict,
+                            int png_color_type,
+                            bool convert16to8)
+  {
+      if (png_color_type==PNG_COLOR_TYPE_RGB_ALPHA)
+      {
+          output_channel<rgba_big16_pixel_t,gil::rgba8_pixel_t>::apply(
+              dest, idict, 3, convert16to8);
+      }
+      else
+      {
+          JAG_ASSERT(png_color_type==PNG_COLOR_TYPE_GRAY_ALPHA);
+          output_channel<graya_big16_pixel_t,gil::dev2n8_pixel_t>::apply(
+              dest, idict, 1, convert16to8);
+      }
+  }
+}
+
+
+
 /// IImageSoftMask implementation for PNG format
 class SoftMaskPNG
     : public IImageMaskData
 {
+    // decoded image, available for interlaced images only
     mutable shared_ptr<ImagePNG::PNGData>    m_png_data;
+    // alpha channel split off by the image, non-interlaced images only
+    mutable shared_ptr<ImagePNG::AlphaChannel>    m_alpha;
+    shared_ptr<IStreamInput>                m_stream;
     const UInt                            m_width;
     const UInt                            m_height;
     const UInt                            m_bits_per_component;
-    const UInt                             m_image_byte_size;
     const int                                m_png_color_type;
     DecodeArray                                m_decode_array;
     ColorComponents                            m_matte;
@@ -78,16 +242,21 @@ public: // IImageMaskData
     InterpolateType interpolate() const { return INTERPOLATE_UNDEFINED; }
 
 private:
-    template<class Pix16, class Pix8>
-    void output_alpha(ISeqStreamOutput& dest, void const* data, int channel, bool convert16to8) const;
+    void output_alpha(ISeqStreamOutput& dest, png_byte const* data,
+                      UInt rowbytes, UInt nr_rows, bool convert16to8) const;
+    void output_kept_alpha(ISeqStreamOutput& dest, bool convert16to8) const;
 
 public:
-    SoftMaskPNG(ImagePNG const& image_png)
-        : m_png_data(image_png.get_image_data())
+    SoftMaskPNG(ImagePNG const& image_png,
+                shared_ptr<ImagePNG::AlphaChannel> const& alpha)
+        : m_png_data(image_png.interlaced()
+                     ? image_png.get_image_data()
+                     : shared_ptr<ImagePNG::PNGData>())
+        , m_alpha(alpha)
+        , m_stream(image_png.stream())
         , m_width(image_png.width())
         , m_height(image_png.height())
         , m_bits_per_component(image_png.bits_per_component())
-        , m_image_byte_size(image_png.height()*m_png_data->m_rowbytes)
         , m_png_color_type(image_png.png_color_type())
     {
         // provide matte to remedy problems with 16bit depth
@@ -106,37 +275,79 @@ bool SoftMaskPNG::output_mask(ISeqStreamOutput& dest, unsigned max_bits) const
         || m_png_color_type == PNG_COLOR_TYPE_GRAY_ALPHA
    );
 
-    png_byte const*const data = m_png_data->m_image_data.get();
     bool convert16to8 = max_bits==8 && m_bits_per_component>8;
 
-    if (m_png_color_type==PNG_COLOR_TYPE_RGB_ALPHA)
+    if (m_png_data)
     {
-        output_alpha<rgba_big16_pixel_t,gil::rgba8_pixel_t>(dest, data, 3, convert16to8);
+        output_alpha(dest, m_png_data->m_image_data.get(),
+                     m_png_data->m_rowbytes, m_height, convert16to8);
+        m_png_data.reset();
+    }
+    else if (m_alpha && m_alpha->complete)
+    {
+        // split off when the image was decoded
+        output_kept_alpha(dest, convert16to8);
     }
     else
     {
-        JAG_ASSERT(m_png_color_type==PNG_COLOR_TYPE_GRAY_ALPHA);
-        output_alpha<graya_big16_pixel_t,gil::dev2n8_pixel_t>(dest, data, 1, convert16to8);
+        if (m_alpha)
+            m_alpha->mask_output = true;
+
+        ImagePNG::PNGReader reader(m_stream);
+        reader.for_each_strip(
+            m_height,
+            boost::bind(&SoftMaskPNG::output_alpha, this, boost::ref(dest),
+                        _1, _2, _3, convert16to8));
     }
 
-    m_png_data.reset();
+    m_alpha.reset();
     return true;
 }
 
 
-template<class Pix16, class Pix8>
-void SoftMaskPNG::output_alpha(ISeqStreamOutput& dest, void const* data, int channel, bool convert16to8) const
+void SoftMaskPNG::output_alpha(ISeqStreamOutput& dest,
+                               png_byte const* data,
+                               UInt rowbytes,
+                               UInt nr_rows,
+                               bool convert16to8) const
 {
-    output_channel<Pix16,Pix8>::apply(
-        dest
-        , img_data_dict_t(
-              m_width
-            , m_height
-            , data
-            , m_png_data->m_rowbytes
-            , m_bits_per_component)
-        , channel
-        , convert16to8);
+    output_alpha_channel(
+        dest,
+        img_data_dict_t(m_width, nr_rows, data, rowbytes, m_bits_per_component),
+        m_png_color_type,
+        convert16to8);
+}
+
+
+/**
+ * @brief Sends the alpha channel kept by the image to an output stream.
+ *
+ * 16-bit samples are big endian, so the high byte comes first.
+ */
+void SoftMaskPNG::output_kept_alpha(ISeqStreamOutput& dest, bool convert16to8) const
+{
+    MemoryStreamInput compressed(m_alpha->data.data(), m_alpha->data.tell());
+    ZLibStreamInput alpha(compressed);
+    if (!convert16to8)
+    {
+        copy_stream(alpha, dest);
+        return;
+    }
+
+    // the buffer size is even, so a chunk holds whole samples
+    Byte buffer[4096];
+    ULong nr_read = 0;
+    bool has_data;
+    do
+    {
+        has_data = alpha.read(buffer, sizeof(buffer), &nr_read);
+        UInt nr_bytes = 0;
+        for (ULong i=0; i<nr_read; i+=2)
+            buffer[nr_bytes++] = buffer[i];
+
+        dest.write(buffer, nr_bytes);
+    }
+    while(has_data);
 }
 
 
@@ -191,35 +402,16 @@ ImagePNG::ImagePNG(IImageData const* img_data,
     , m_res_ctx(res_ctx)
     , m_exec_ctx(exec_ctx)
 {
-    {
-        JAG_PRECONDITION(img_data->format() == IMAGE_FORMAT_PNG);
+    JAG_PRECONDITION(img_data->format() == IMAGE_FORMAT_PNG);
 
-        if (!ImagePNG::ping(*m_in_stream))
-            throw exception_invalid_input(msg_not_png_format()) << JAGLOC;
-
-        m_png = png_create_read_struct(PNG_LIBPNG_VER_STRING
-                                        , this
-                                        , &ImagePNG::user_error_handler
-                                        , &ImagePNG::user_warning_handler);
-        if (!m_png) {
-            JAG_INTERNAL_ERROR_MSG("PNGlib initialization failed");
-        }
-    }
+    m_reader.reset(new PNGReader(m_in_stream));
+    m_png = m_reader->png();
+    m_png_info = m_reader->info();
 
     if (setjmp(m_png->jmpbuf)) {
-        release_lib_data();
-        report_error();
-    }
-
-    m_png_info = png_create_info_struct(m_png);
-    if (!m_png_info) {
-        JAG_INTERNAL_ERROR_MSG("PNGlib initialization failed");
+        m_reader->report_error();
     }
 
-    png_set_sig_bytes(m_png, ImagePNG::nr_ping_bytes);
-    png_set_read_fn(m_png, m_in_stream.get(), &ImagePNG::user_read_data);
-    png_read_info(m_png, m_png_info);
-
     read_image_info();
 }
 
@@ -271,15 +463,7 @@ void ImagePNG::read_color_space_srgb()
     if (png_get_sRGB(m_png, m_png_info, &srgb_intent))
     {
         boost::shared_ptr<IResourceCtx> res_ctx(m_res_ctx);
-        intrusive_ptr<IICCBased> spec(
-            res_ctx->color_space_man()->define_iccbased());
-
-        spec->num_components(3);
-        std::auto_ptr<ISeqStreamInput> mem_stream(
-            create_stream_from_memory(binres::icc_srgb, binres::icc_srgb_size));
-
-        spec->icc_profile_stream(mem_stream);
-        m_color_space = res_ctx->color_space_man()->color_space_load(spec);
+        m_color_space = res_ctx->color_space_man()->register_srgb();
     }
 }
 
@@ -561,30 +745,9 @@ void ImagePNG::read_resolution()
 }
 
 
-//////////////////////////////////////////////////////////////////////////
-void ImagePNG::release_lib_data()
-{
-    if (m_png)
-    {
-        png_destroy_read_struct(
-              &m_png
-            , m_png_info ? &m_png_info : 0
-            , 0
-       );
-
-        // delete image data as well
-        m_png_data.reset();
-    }
-
-    m_png_info = 0;
-    m_png = 0;
-}
-
-
 //////////////////////////////////////////////////////////////////////////
 ImagePNG::~ImagePNG()
 {
-    release_lib_data();
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -593,36 +756,22 @@ void ImagePNG::read_data() const
     if (m_png_data->m_image_data)
         return; //already read
 
-    if (setjmp(m_png->jmpbuf)) {
-        report_error();
-    }
-
-    png_start_read_image(m_png);
-
-    m_png_data->m_rowbytes = png_get_rowbytes(m_png, m_png_info);
-
-    const int image_byte_size = m_height*m_png_data->m_rowbytes;
-    m_png_data->m_image_data.reset(new png_byte[image_byte_size]);
-    m_png_data->m_rows.reset(new png_bytep[m_height]);
+    m_png_data->alloc(m_reader->start_rows(), m_height);
 
     // ------ testing
     // reference files should be generated with the following line
-    //memset(m_png_data->m_image_data.get(), 0xff, image_byte_size);
+    //memset(m_png_data->m_image_data.get(), 0xff, m_height*m_png_data->m_rowbytes);
     // difference ranges should be generated with the following line
-    //memset(m_png_data->m_image_data.get(), 0, image_byte_size);
+    //memset(m_png_data->m_image_data.get(), 0, m_height*m_png_data->m_rowbytes);
     // ------ testing
 
-
-    for (UInt i=0; i<m_height; ++i)
-        m_png_data->m_rows[i] = m_png_data->m_image_data.get() + i*m_png_data->m_rowbytes;
-
     for (int i=0; i<m_number_of_passes; ++i)
     {
         // "sparkle" effect"
-        png_read_rows(m_png, m_png_data->m_rows.get(), NULL, m_height);
+        m_reader->read_rows(m_png_data->m_rows.get(), m_height);
     }
 
-    png_read_end(m_png, m_png_info);
+    m_reader->finish();
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -647,20 +796,153 @@ ImageMaskType ImagePNG::image_mask_type() const
 //////////////////////////////////////////////////////////////////////////
 intrusive_ptr<IImageMaskData> ImagePNG::create_mask() const
 {
+    if (!interlaced())
+    {
+        m_alpha.reset(
+            new AlphaChannel(
+                deflate_params_from_config(m_exec_ctx.config(),
+                                           "compression.image_level",
+                                           "compression.image_strategy")));
+    }
+
     return intrusive_ptr<IImageMaskData>(
-        new RefCountImpl<SoftMaskPNG>(*this));
+        new RefCountImpl<SoftMaskPNG>(*this, m_alpha));
 }
 
 
 //////////////////////////////////////////////////////////////////////////
 bool ImagePNG::output_image(ISeqStreamOutput& dest, unsigned max_bits) const
 {
-    read_data();
-
-    png_byte const*const image_data = m_png_data->m_image_data.get();
-    UInt image_byte_size = m_height * m_png_data->m_rowbytes;
     bool convert16to8 = max_bits==8 && m_bits_per_component==16;
 
+    if (interlaced())
+    {
+        // all passes are needed to get a complete row
+        read_data();
+        output_rows(dest, m_png_data->m_image_data.get(),
+                    m_png_data->m_rowbytes, m_height, convert16to8);
+        return true;
+    }
+
+    if (m_alpha && !m_alpha->mask_output)
+    {
+        // keep the alpha channel so that the soft mask does not need to
+        // decode the stream again
+        m_alpha->deflater = create_deflate_stream(m_alpha->data, m_alpha->params);
+        m_reader->for_each_strip(
+            m_height,
+            boost::bind(&ImagePNG::output_rows_split_alpha, this, boost::ref(dest),
+                        _1, _2, _3, convert16to8));
+        m_alpha->deflater->close();
+        m_alpha->deflater.reset();
+        m_alpha->complete = true;
+    }
+    else
+    {
+        m_reader->for_each_strip(
+            m_height,
+            boost::bind(&ImagePNG::output_rows, this, boost::ref(dest),
+                        _1, _2, _3, convert16to8));
+    }
+
+    m_alpha.reset();
+    return true;
+}
+
+
+/**
+ * @brief Number of color components of flate predicted data.
+ *
+ * The concatenated IDAT chunks form a zlib stream of rows filtered by PNG
+ * predictors, which is exactly what FlateDecode with /Predictor 15
+ * expects. That holds only if the rows are not interlaced and there is no
+ * alpha channel to split off.
+ */
+UInt ImagePNG::flate_predictor_colors() const
+{
+    if (interlaced() || m_has_soft_mask)
+        return 0;
+
+    switch (m_png_color_type)
+    {
+    case PNG_COLOR_TYPE_RGB:
+        return 3;
+
+    case PNG_COLOR_TYPE_GRAY:
+    case PNG_COLOR_TYPE_PALETTE:
+        return 1;
+    }
+
+    return 0;
+}
+
+
+/**
+ * @brief Sends the content of IDAT chunks to an output stream.
+ *
+ * The image data are not decoded, only chunk CRCs are verified.
+ */
+void ImagePNG::output_flate_predicted(ISeqStreamOutput& dest) const
+{
+    JAG_PRECONDITION(flate_predictor_colors());
+
+    IStreamInput& in = *m_in_stream;
+    in.seek(nr_ping_bytes, OFFSET_FROM_BEGINNING);
+
+    scoped_array<Byte> buffer(new Byte[g_strip_bytes]);
+    for (;;)
+    {
+        // chunk length and type
+        Byte header[8];
+        read_png_bytes(in, header, 8);
+        ULong length = png_uint32(header);
+        Byte const* type = header + 4;
+
+        if (!memcmp(type, "IEND", 4))
+            break;
+
+        if (memcmp(type, "IDAT", 4))
+        {
+            // skip data and crc
+            in.seek(static_cast<Int>(length + 4), OFFSET_FROM_CURRENT);
+            continue;
+        }
+
+        uLong crc = crc32(0, type, 4);
+        while (length)
+        {
+            ULong nr_bytes = (std::min)(length, static_cast<ULong>(g_strip_bytes));
+            read_png_bytes(in, buffer.get(), nr_bytes);
+            crc = crc32(crc, buffer.get(), static_cast<uInt>(nr_bytes));
+            dest.write(buffer.get(), nr_bytes);
+            length -= nr_bytes;
+        }
+
+        Byte chunk_crc[4];
+        read_png_bytes(in, chunk_crc, 4);
+        if (png_uint32(chunk_crc) != crc)
+            throw exception_invalid_input(
+                msg_error_while_processing_png_format("IDAT: CRC error"))
+                << JAGLOC;
+    }
+}
+
+
+/**
+ * @brief Converts a strip of rows and sends it to an output stream.
+ *
+ * @param dest  output stream
+ * @param data  raw data of the rows
+ * @param rowbytes  size of a row in bytes
+ * @param nr_rows  number of rows
+ * @param convert16to8  whether to decrease bit depth from 16 to 8
+ */
+void ImagePNG::output_rows(ISeqStreamOutput& dest,
+                           png_byte const* data,
+                           UInt rowbytes,
+                           UInt nr_rows,
+                           bool convert16to8) const
+{
     switch (m_png_color_type)
     {
     case PNG_COLOR_TYPE_RGB:
@@ -671,12 +953,12 @@ bool ImagePNG::output_image(ISeqStreamOutput& dest, unsigned max_bits) const
                 gil::color_converted_view<gil::rgb8_pixel_t>(
                       gil::interleaved_view(
                           m_width
-                        , m_height
-                        , (rgb_big16_pixel_cptr_t)image_data
-                        , m_png_data->m_rowbytes)
+                        , nr_rows
+                        , (rgb_big16_pixel_cptr_t)data
+                        , rowbytes)
                     , my_color_converter())
            );
-            return true;
+            return;
         }
 
     case PNG_COLOR_TYPE_GRAY:
@@ -687,20 +969,20 @@ bool ImagePNG::output_image(ISeqStreamOutput& dest, unsigned max_bits) const
                 gil::color_converted_view<gil::gray8_pixel_t>(
                       gil::interleaved_view(
                           m_width
-                        , m_height
-                        , (gray_big16_pixel_cptr_t)image_data
-                        , m_png_data->m_rowbytes)
+                        , nr_rows
+                        , (gray_big16_pixel_cptr_t)data
+                        , rowbytes)
                     , my_color_converter())
            );
-            return true;
+            return;
         }
         break;
 
 
 
     case PNG_COLOR_TYPE_RGB_ALPHA:
-        rgb_from_rgba(dest, image_data, convert16to8);
-        return true;
+        rgb_from_rgba(dest, data, rowbytes, nr_rows, convert16to8);
+        return;
 
 
     case PNG_COLOR_TYPE_GRAY_ALPHA:
@@ -708,30 +990,53 @@ bool ImagePNG::output_image(ISeqStreamOutput& dest, unsigned max_bits) const
             dest
             , img_data_dict_t(
                 m_width
-                , m_height
-                , image_data
-                , m_png_data->m_rowbytes
+                , nr_rows
+                , data
+                , rowbytes
                 , m_bits_per_component)
             , 0
             , convert16to8);
-        return true;
+        return;
     }
 
-    dest.write(image_data, image_byte_size);
-    return true;
+    dest.write(data, nr_rows * rowbytes);
 }
 
 
 
 
+/**
+ * @brief Like output_rows() but also keeps the alpha channel of the rows.
+ */
+void ImagePNG::output_rows_split_alpha(ISeqStreamOutput& dest,
+                                       png_byte const* data,
+                                       UInt rowbytes,
+                                       UInt nr_rows,
+                                       bool convert16to8) const
+{
+    output_rows(dest, data, rowbytes, nr_rows, convert16to8);
+    output_alpha_channel(
+        *m_alpha->deflater,
+        img_data_dict_t(m_width, nr_rows, data, rowbytes, m_bits_per_component),
+        m_png_color_type,
+        false);
+}
+
+
 /**
  * @brief Converts RGBA to RGB and sends it an output stream.
  *
  * @param dest  output stream
  * @param data  image raw data
+ * @param rowbytes  size of a row in bytes
+ * @param nr_rows  number of rows
  * @param convert16to8  whether to decrease bit depth from 16 to 8
  */
-void ImagePNG::rgb_from_rgba(ISeqStreamOutput& dest, png_byte const* data, bool convert16to8) const
+void ImagePNG::rgb_from_rgba(ISeqStreamOutput& dest,
+                             png_byte const* data,
+                             UInt rowbytes,
+                             UInt nr_rows,
+                             bool convert16to8) const
 {
     if (convert16to8)
     {
@@ -740,9 +1045,9 @@ void ImagePNG::rgb_from_rgba(ISeqStreamOutput& dest, png_byte const* data, bool
             gil::color_converted_view<gil::rgb8_pixel_t>(
                 gil::interleaved_view(
                     m_width
-                    , m_height
+                    , nr_rows
                     , (rgba_big16_pixel_cptr_t)data
-                    , m_png_data->m_rowbytes)
+                    , rowbytes)
                 , my_color_converter())
            );
     }
@@ -756,9 +1061,9 @@ void ImagePNG::rgb_from_rgba(ISeqStreamOutput& dest, png_byte const* data, bool
                 gil::color_converted_view<rgb_big16_pixel_t>(
                     gil::interleaved_view(
                         m_width
-                        , m_height
+                        , nr_rows
                         , (rgba_big16_pixel_cptr_t)data
-                        , m_png_data->m_rowbytes)
+                        , rowbytes)
                     , my_color_converter())
                );
         }
@@ -771,9 +1076,9 @@ void ImagePNG::rgb_from_rgba(ISeqStreamOutput& dest, png_byte const* data, bool
                 gil::color_converted_view<gil::rgb8_pixel_t>(
                     gil::interleaved_view(
                         m_width
-                            , m_height
+                            , nr_rows
                         , (const gil::rgba8_pixel_t *)data
-                        , m_png_data->m_rowbytes)
+                        , rowbytes)
                     , my_color_converter())
                );
         }
@@ -798,10 +1103,120 @@ shared_ptr<IResourceCtx> ImagePNG::resource_ctx()
 }
 
 
+
+//////////////////////////////////////////////////////////////////////////
+// PNGReader
+//////////////////////////////////////////////////////////////////////////
+
+//
+//
+//
+ImagePNG::PNGReader::PNGReader(shared_ptr<IStreamInput> const& stream)
+    : m_stream(stream)
+    , m_offset(ImagePNG::nr_ping_bytes)
+    , m_png(0)
+    , m_png_info(0)
+{
+    {
+        if (!ImagePNG::ping(*m_stream))
+            throw exception_invalid_input(msg_not_png_format()) << JAGLOC;
+
+        m_png = png_create_read_struct(PNG_LIBPNG_VER_STRING
+                                        , this
+                                        , &PNGReader::user_error_handler
+                                        , &PNGReader::user_warning_handler);
+        if (!m_png) {
+            JAG_INTERNAL_ERROR_MSG("PNGlib initialization failed");
+        }
+    }
+
+    if (setjmp(m_png->jmpbuf)) {
+        release_lib_data();
+        report_error();
+    }
+
+    m_png_info = png_create_info_struct(m_png);
+    if (!m_png_info) {
+        release_lib_data();
+        JAG_INTERNAL_ERROR_MSG("PNGlib initialization failed");
+    }
+
+    png_set_sig_bytes(m_png, ImagePNG::nr_ping_bytes);
+    png_set_read_fn(m_png, this, &PNGReader::user_read_data);
+    png_read_info(m_png, m_png_info);
+}
+
+
+//
+//
+//
+ImagePNG::PNGReader::~PNGReader()
+{
+    release_lib_data();
+}
+
+
 //
 //
 //
-void ImagePNG::report_error() const
+void ImagePNG::PNGReader::release_lib_data()
+{
+    if (m_png)
+    {
+        png_destroy_read_struct(
+              &m_png
+            , m_png_info ? &m_png_info : 0
+            , 0
+       );
+    }
+
+    m_png_info = 0;
+    m_png = 0;
+}
+
+
+/// starts reading rows, returns the size of a row in bytes
+UInt ImagePNG::PNGReader::start_rows()
+{
+    if (setjmp(m_png->jmpbuf)) {
+        report_error();
+    }
+
+    png_start_read_image(m_png);
+    return png_get_rowbytes(m_png, m_png_info);
+}
+
+
+//
+//
+//
+void ImagePNG::PNGReader::read_rows(png_bytepp rows, UInt nr_rows)
+{
+    if (setjmp(m_png->jmpbuf)) {
+        report_error();
+    }
+
+    png_read_rows(m_png, rows, NULL, nr_rows);
+}
+
+
+//
+//
+//
+void ImagePNG::PNGReader::finish()
+{
+    if (setjmp(m_png->jmpbuf)) {
+        report_error();
+    }
+
+    png_read_end(m_png, m_png_info);
+}
+
+
+//
+//
+//
+void ImagePNG::PNGReader::report_error()
 {
     JAG_PRECONDITION(m_exception);
     if (!m_exception) {
@@ -816,19 +1231,24 @@ void ImagePNG::report_error() const
 }
 
 //////////////////////////////////////////////////////////////////////////
-void ImagePNG::user_read_data(png_structp png_struct, png_bytep data, png_size_t length)
+void ImagePNG::PNGReader::user_read_data(png_structp png_struct, png_bytep data, png_size_t length)
 {
     // Do not allow an exception to propagate from this function as this
     // function is called from a C code so stack unwinding stops there.
     try
     {
-        IStreamInput* stream_in = reinterpret_cast<IStreamInput*>(png_get_io_ptr(png_struct));
-        stream_in->read(data, length);
+        PNGReader* this_ = reinterpret_cast<PNGReader*>(png_get_io_ptr(png_struct));
+        // the stream can be shared with other readers
+        if (this_->m_stream->tell() != this_->m_offset)
+            this_->m_stream->seek(this_->m_offset, OFFSET_FROM_BEGINNING);
+
+        this_->m_stream->read(data, length);
+        this_->m_offset += length;
     }
     catch(exception const& exc)
     {
         {
-            ImagePNG* this_ = reinterpret_cast<ImagePNG*>(png_get_error_ptr(png_struct));
+            PNGReader* this_ = reinterpret_cast<PNGReader*>(png_get_error_ptr(png_struct));
             std::auto_ptr<exception> cloned(exc.clone());
             this_->m_exception.reset(cloned.release());
         }
@@ -837,7 +1257,7 @@ void ImagePNG::user_read_data(png_structp png_struct, png_bytep data, png_size_t
     catch(std::exception const& exc)
     {
         {
-            ImagePNG* this_ = reinterpret_cast<ImagePNG*>(png_get_error_ptr(png_struct));
+            PNGReader* this_ = reinterpret_cast<PNGReader*>(png_get_error_ptr(png_struct));
             this_->m_exception.reset(new exception_invalid_input(msg_error_while_processing_png_format(exc.what())));
             (*this_->m_exception) << JAGLOC;
         }
@@ -846,10 +1266,10 @@ void ImagePNG::user_read_data(png_structp png_struct, png_bytep data, png_size_t
 }
 
 //////////////////////////////////////////////////////////////////////////
-void ImagePNG::user_error_handler(png_structp png_struct, png_const_charp msg)
+void ImagePNG::PNGReader::user_error_handler(png_structp png_struct, png_const_charp msg)
 {
     {
-        ImagePNG* this_ = reinterpret_cast<ImagePNG*>(png_get_error_ptr(png_struct));
+        PNGReader* this_ = reinterpret_cast<PNGReader*>(png_get_error_ptr(png_struct));
         this_->m_exception.reset(new exception_invalid_input(msg_error_while_processing_png_format(msg)));
         (*this_->m_exception) << JAGLOC;
     }
@@ -857,7 +1277,7 @@ void ImagePNG::user_error_handler(png_structp png_struct, png_const_charp msg)
 }
 
 //////////////////////////////////////////////////////////////////////////
-void ImagePNG::user_warning_handler(png_structp /*png_struct*/, png_const_charp msg)
+void ImagePNG::PNGReader::user_warning_handler(png_structp /*png_struct*/, png_const_charp msg)
 {
     write_message(WRN_WARNING_WHILE_PROCESSING_PNG_FORMAT_w, msg);
 }
@@ -47,9 +47,13 @@ namespace resources
  *
  * In constructor, only image properties are read.
  *
- * The image data are read when output_image_data() is invoked and are released
- * immediately after this call has finished. If the image has a soft mask then
- * the image data are released after the soft mask data has been outputted.
+ * The image data are read when output_image_data() is invoked. Non-interlaced
+ * images are decoded and written in strips of rows so only a few strips are
+ * held in memory. The alpha channel of a non-interlaced image is kept while the
+ * image is decoded, so the soft mask is written from it; if the soft mask is
+ * outputted first, it decodes the PNG stream itself. Interlaced images have to
+ * be decoded as a whole; their data are released after the soft mask data has
+ * been outputted.
  *
  * Image data can be read only once (that can be subject to change). Image
  * properties are available during whole lifetime of this object.
@@ -94,19 +98,27 @@ public: // IImageFilter
     boost::intrusive_ptr<IImageMaskData> create_mask() const;
 
     bool output_image(ISeqStreamOutput& dest, unsigned max_bits) const;
+    UInt flate_predictor_colors() const;
+    void output_flate_predicted(ISeqStreamOutput& dest) const;
     boost::shared_ptr<IStreamInput> data_stream() const { JAG_ASSERT(!"suspicious"); return m_in_stream; }
 
 public:
     struct PNGData;
+    struct AlphaChannel;
+    class PNGReader;
     int png_color_type() const { return m_png_color_type; }
+    bool interlaced() const { return m_number_of_passes > 1; }
+    boost::shared_ptr<IStreamInput> const& stream() const { return m_in_stream; }
     boost::shared_ptr<PNGData> const& get_image_data() const;
 
 
 private:
-    void release_lib_data();
-
     void read_image_info();
     void read_data() const;
+    void output_rows(ISeqStreamOutput& dest, png_byte const* data,
+                     UInt rowbytes, UInt nr_rows, bool convert16to8) const;
+    void output_rows_split_alpha(ISeqStreamOutput& dest, png_byte const* data,
+                                 UInt rowbytes, UInt nr_rows, bool convert16to8) const;
 
     // invoked from read_image_info()
     void read_resolution();
@@ -119,20 +131,16 @@ private:
     void read_color_space_iccp();
     void read_color_space_chrm();
 
-    void rgb_from_rgba(ISeqStreamOutput& dest, png_byte const* data, bool convert16to8) const;
-    void report_error() const;
-
+    void rgb_from_rgba(ISeqStreamOutput& dest, png_byte const* data,
+                       UInt rowbytes, UInt nr_rows, bool convert16to8) const;
 
-private: // lpng related
-    static void user_error_handler(png_structp png_struct, png_const_charp msg);
-    static void user_warning_handler(png_structp png_struct, png_const_charp msg);
-    static void user_read_data(png_structp png_struct, png_bytep data, png_size_t length);
 
 private:
     static const int    nr_ping_bytes = 8;
     boost::shared_ptr<IResourceCtx> resource_ctx();
 
-    // set in constructor
+    // set in constructor, m_png and m_png_info are owned by m_reader
+    boost::scoped_ptr<PNGReader> m_reader;
     png_structp            m_png;
     png_infop            m_png_info;
 
@@ -152,14 +160,13 @@ private:
 
     // set by read_data()
     mutable boost::shared_ptr<PNGData>    m_png_data;
+    // set by create_mask(), shared with the soft mask
+    mutable boost::shared_ptr<AlphaChannel>    m_alpha;
 
 private:
     boost::shared_ptr<IStreamInput>    m_in_stream;
     boost::weak_ptr<IResourceCtx> m_res_ctx;
     IExecContext const&  m_exec_ctx;
-
-    std::string                   m_error;
-    mutable boost::scoped_ptr<exception>  m_exception;
 };
 
 
@@ -14,11 +14,13 @@
 #include <core/jstd/memory_stream.h>
 #include <core/jstd/file_stream.h>
 #include <core/jstd/streamhelpers.h>
+#include <core/jstd/externalstreamwrap.h>
 #include <core/generic/floatpointtools.h>
 #include <resources/resourcebox/colorspacehelpers.h>
 #include <interfaces/configinternal.h>
 #include <interfaces/execcontext.h>
 #include <core/generic/checked_cast.h>
+#include <algorithm>
 
 using namespace boost;
 using namespace jag::resources;
@@ -26,6 +28,106 @@ using namespace jag::resources;
 namespace jag {
 namespace resources {
 
+namespace
+{
+  // shared_ptr deleter invoking the release callback of borrowed data
+  class DataRelease
+  {
+  public:
+      explicit DataRelease(jag_datarelease const* release)
+          : m_release(release ? release->release : 0)
+          , m_custom_data(release ? release->custom_data : 0)
+      {}
+
+      void operator()(Byte const* data) const {
+          if (m_release)
+              m_release(m_custom_data, data);
+      }
+
+  private:
+      void (JAG_CALLSPEC *m_release)(void*, void const*);
+      void* m_custom_data;
+  };
+
+
+  // reads borrowed data and keeps them alive
+  class BorrowedStreamInput
+      : public IStreamInput
+  {
+      shared_ptr<Byte const> m_data;
+      jstd::MemoryStreamInput m_in;
+
+  public:
+      BorrowedStreamInput(shared_ptr<Byte const> const& data, UInt length)
+          : m_data(data)
+          , m_in(data.get(), length)
+      {}
+
+  public: // IStreamInput
+      bool read(void* data, ULong size, ULong* read) {
+          return m_in.read(data, size, read);
+      }
+
+      ULong tell() const {
+          return m_in.tell();
+      }
+
+      void close() {
+          m_in.close();
+      }
+
+      void seek(Int offset, StreamOffsetOrigin origin) {
+          m_in.seek(offset, origin);
+      }
+  };
+
+
+  // reads exactly the given number of bytes from a pulled source, a source
+  // which ends early is an error
+  class PulledSamplesInput
+      : public ISeqStreamInput
+  {
+      shared_ptr<ISeqStreamInput> m_source;
+      ULong m_remaining;
+      ULong m_pos;
+
+  public:
+      PulledSamplesInput(shared_ptr<ISeqStreamInput> const& source, ULong size)
+          : m_source(source)
+          , m_remaining(size)
+          , m_pos(0)
+      {}
+
+  public: // ISeqStreamInput
+      bool read(void* data, ULong size, ULong* nr_read) {
+          const ULong chunk = (std::min)(size, m_remaining);
+          ULong read = 0;
+          if (chunk)
+              m_source->read(data, chunk, &read);
+
+          if (read < chunk)
+          {
+              throw exception_io_error(msg_cannot_read_stream())
+                  << io_object_info("external stream")
+                  << JAGLOC;
+          }
+
+          m_remaining -= read;
+          m_pos += read;
+          if (nr_read)
+              *nr_read = read;
+
+          return m_remaining != 0;
+      }
+
+      ULong tell() const {
+          return m_pos;
+      }
+  };
+
+} // anonymous namespace
+
+
 //////////////////////////////////////////////////////////////////////////
 ImageSpecImpl::ImageSpecImpl()
     : m_type(IMAGE_FORMAT_AUTO)
@@ -37,15 +139,26 @@ ImageSpecImpl::ImageSpecImpl()
     , m_gamma(0)
     , m_rendering_intent(RI_UNDEFINED)
     , m_interpolate(INTERPOLATE_UNDEFINED)
+    , m_borrowed_length(0)
+    , m_source_size(0)
 {
 }
 
 //////////////////////////////////////////////////////////////////////////
-void ImageSpecImpl::check_consistency(IExecContext const& exec_ctx)
+void ImageSpecImpl::check_consistency(IExecContext const& exec_ctx, IColorSpaceMan const& cs_man)
 {
-    if (m_file_name.empty() && !m_image_data)
+    if (m_file_name.empty() && !m_image_data && !m_borrowed_data && !m_data_source)
         throw exception_invalid_value(msg_image_data_not_specified()) << JAGLOC;
 
+    // a pulled source can be read only once, so it cannot be pinged
+    if (m_data_source)
+    {
+        if (m_type == IMAGE_FORMAT_AUTO)
+            m_type = IMAGE_FORMAT_NATIVE;
+        else if (m_type != IMAGE_FORMAT_NATIVE)
+            throw exception_invalid_value(msg_unsupported_image_format()) << JAGLOC;
+    }
+
     // image format autodetection
     if (m_type == IMAGE_FORMAT_AUTO)
     {
@@ -83,6 +196,18 @@ void ImageSpecImpl::check_consistency(IExecContext const& exec_ctx)
             if (equal_to_zero(m_dpi_y))
                 m_dpi_y = default_dpi;
         }
+
+        // a pulled source is read up to the end of the samples (rows are
+        // padded to whole bytes)
+        if (m_data_source)
+        {
+            const ULong components = cs_type==CS_INDEXED
+                ? 1
+                : num_components(m_color_space, &cs_man);
+
+            m_source_size = static_cast<ULong>(m_height)
+                * ((static_cast<ULong>(m_width) * components * m_bpc + 7) / 8);
+        }
     }
 }
 
@@ -190,6 +315,8 @@ void ImageSpecImpl::file_name(Char const* file_name)
 {
     m_file_name = file_name;
     m_image_data.reset();
+    m_borrowed_data.reset();
+    m_data_source.reset();
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -199,6 +326,35 @@ void ImageSpecImpl::data(Byte const* data, UInt length)
         m_image_data.reset(new jstd::MemoryStreamOutput);
 
     m_image_data->write(data, length);
+    m_borrowed_data.reset();
+    m_data_source.reset();
+    std::string().swap(m_file_name);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void ImageSpecImpl::data_borrowed(Byte const* data, UInt length, jag_datarelease const* release)
+{
+    // the data are owned from now on, even if this method throws
+    shared_ptr<Byte const> borrowed(data, DataRelease(release));
+    if (!data && length)
+        throw exception_invalid_value(msg_null_pointer()) << JAGLOC;
+
+    m_borrowed_data.swap(borrowed);
+    m_borrowed_length = length;
+    m_image_data.reset();
+    m_data_source.reset();
+    std::string().swap(m_file_name);
+}
+
+//////////////////////////////////////////////////////////////////////////
+void ImageSpecImpl::data_source(jag_streamin const* source)
+{
+    if (!source)
+        throw exception_invalid_value(msg_null_pointer()) << JAGLOC;
+
+    m_data_source.reset(new jstd::ExternalStreamIn(*source));
+    m_image_data.reset();
+    m_borrowed_data.reset();
     std::string().swap(m_file_name);
 }
 
@@ -220,23 +376,52 @@ ImageMaskType ImageSpecImpl::image_mask_type() const
 //////////////////////////////////////////////////////////////////////////
 bool ImageSpecImpl::output_image(ISeqStreamOutput& dest, unsigned max_bits) const
 {
-    shared_ptr<IStreamInput> in_stream(data_stream());
-
     ColorSpaceType cs_type(color_space_type(m_color_space));
     if(cs_type!=CS_INDEXED && m_bpc>max_bits)
     {
         JAG_PRECONDITION(m_bpc==16 && max_bits==8);
-        downsample_big16_to_8(*in_stream, dest);
+        downsample_big16_to_8(*input_stream(), dest);
+    }
+    else if (m_borrowed_data)
+    {
+        // the filter chain consumes the caller's memory directly
+        dest.write(m_borrowed_data.get(), m_borrowed_length);
+    }
+    else if (m_image_data)
+    {
+        dest.write(m_image_data->data(), m_image_data->tell());
     }
     else
     {
-        jstd::copy_stream(*in_stream, dest);
+        jstd::copy_stream(*input_stream(), dest);
     }
     m_image_data.reset();
+    m_borrowed_data.reset();
+    m_data_source.reset();
 
     return true;
 }
 
+//////////////////////////////////////////////////////////////////////////
+void ImageSpecImpl::output_flate_predicted(ISeqStreamOutput& /*dest*/) const
+{
+    // native images are never flate predicted
+    JAG_INTERNAL_ERROR;
+}
+
+//////////////////////////////////////////////////////////////////////////
+shared_ptr<ISeqStreamInput> ImageSpecImpl::input_stream() const
+{
+    if (m_data_source)
+    {
+        return shared_ptr<ISeqStreamInput>(
+            new PulledSamplesInput(m_data_source, m_source_size)
+           );
+    }
+
+    return data_stream();
+}
+
 //////////////////////////////////////////////////////////////////////////
 shared_ptr<IStreamInput> ImageSpecImpl::data_stream() const
 {
@@ -246,6 +431,12 @@ shared_ptr<IStreamInput> ImageSpecImpl::data_stream() const
             new jstd::FileStreamInput(m_file_name.c_str())
            );
     }
+    else if (m_borrowed_data)
+    {
+        return shared_ptr<IStreamInput>(
+            new BorrowedStreamInput(m_borrowed_data, m_borrowed_length)
+           );
+    }
     else
     {
         return shared_ptr<IStreamInput>(
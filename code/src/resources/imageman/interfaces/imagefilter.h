@@ -77,6 +77,19 @@ public:
     /// Outputs image data in form recognizable by a PDF consumer
     virtual bool output_image(ISeqStreamOutput& dest, unsigned max_bits) const = 0;
 
+    /**
+     * @brief Number of color components of flate predicted image data.
+     *
+     * A non-zero value means that the image data can be sent as they are
+     * stored in the image stream, i.e. compressed by FlateDecode and encoded
+     * by PNG predictors (/Predictor 15, /Colors, /BitsPerComponent,
+     * /Columns), by output_flate_predicted().
+     */
+    virtual UInt flate_predictor_colors() const = 0;
+
+    /// Outputs flate compressed, PNG predicted image data
+    virtual void output_flate_predicted(ISeqStreamOutput& dest) const = 0;
+
     /// Provides the whole image stream
     virtual boost::shared_ptr<IStreamInput> data_stream() const = 0;
 
@@ -11,6 +11,7 @@
 #include <resources/resourcebox/binresources.h>
 #include <core/generic/refcountedimpl.h>
 #include <core/jstd/streamhelpers.h>
+#include <core/generic/checked_cast.h>
 #include <core/jstd/optionsparser.h>
 #include <boost/intrusive_ptr.hpp>
 #include <msg_resources.h>
@@ -40,7 +41,7 @@ namespace
 {
 
   /// This operation should be applied before looking up in the resource table
-  ColorSpaceHandle& unmask_handle(ColorSpaceHandle csh)
+  ColorSpaceHandle unmask_handle(ColorSpaceHandle csh)
   {
       return csh.rshift(CS_COLOR_SPACE_ID_START_BIT);
   }
@@ -185,24 +186,31 @@ ColorSpaceHandle ColorSpaceManImpl::register_palette(
 
 
 //
+// Registers a profile which lives as long as the process.
 //
-//
-ColorSpaceHandle ColorSpaceManImpl::register_icc_from_memory(Byte const* mem,
-                                                             size_t size,
-                                                             int nr_components)
+ColorSpaceHandle ColorSpaceManImpl::register_icc_static(Byte const* mem,
+                                                        size_t size,
+                                                        int nr_components)
 {
     JAG_PRECONDITION(mem && nr_components && size);
-    intrusive_ptr<IICCBased> spec(define_iccbased());
+    intrusive_ptr<ICCBasedImpl> spec(new RefCountImpl<ICCBasedImpl>);
     spec->num_components(nr_components);
-    std::auto_ptr<ISeqStreamInput> mem_stream(
-        create_stream_from_memory(mem, size));
-
-    spec->icc_profile_stream(mem_stream);
+    spec->icc_profile_static(mem, size);
     return color_space_load(spec);
 }
 
 
 
+//
+//
+//
+ColorSpaceHandle ColorSpaceManImpl::register_srgb()
+{
+    return register_icc_static(binres::icc_srgb, binres::icc_srgb_size, 3);
+}
+
+
+
 
 
 //
@@ -230,15 +238,13 @@ ColorSpaceManImpl::color_space_load(Char const* spec_str)
     switch (name)
     {
     case CSN_SRGB:
-        result.first = register_icc_from_memory(binres::icc_srgb,
-                                                binres::icc_srgb_size,
-                                                3);
+        result.first = register_srgb();
         break;
 
     case CSN_ADOBE_RGB:
-        result.first = register_icc_from_memory(binres::icc_adobe_rgb,
-                                                binres::icc_adobe_rgb_size,
-                                                3);
+        result.first = register_icc_static(binres::icc_adobe_rgb,
+                                           binres::icc_adobe_rgb_size,
+                                           3);
         break;
 
     case CSN_BYID:
@@ -390,7 +396,47 @@ ColorSpaceManImpl::color_space_load(intrusive_ptr<IColorSpace> cs)
 {
     cs->check_validity();
 
-    ColorSpaceHandle handle(m_cs_table.add(cs->clone()));
+    if (cs->color_space_type() == CS_ICCBASED)
+        return iccbased_load(cs);
+
+    return add_color_space(cs->clone());
+}
+
+
+
+//
+// Returns an already registered color space with the same profile, or
+// registers a new one.
+//
+ColorSpaceHandle
+ColorSpaceManImpl::iccbased_load(intrusive_ptr<IColorSpace> cs)
+{
+    intrusive_ptr<ICCBasedImpl> icc(
+        checked_static_cast<ICCBasedImpl*>(cs->clone().get()));
+    icc->fetch_profile();
+
+    MD5Hash md5;
+    md5.append(icc->profile_data(), static_cast<md5_word_t>(icc->profile_size()));
+    const ICCKey key(md5.finish(), icc->num_components(), icc->alternate());
+
+    ICCMap::const_iterator it = m_icc_map.find(key);
+    if (it != m_icc_map.end())
+        return it->second;
+
+    ColorSpaceHandle handle(add_color_space(icc));
+    m_icc_map.insert(std::make_pair(key, handle));
+    return handle;
+}
+
+
+
+//
+//
+//
+ColorSpaceHandle
+ColorSpaceManImpl::add_color_space(intrusive_ptr<IColorSpace> const& cs)
+{
+    ColorSpaceHandle handle(m_cs_table.add(cs));
     return handle
         .lshift(CS_COLOR_SPACE_ID_START_BIT)
         .bitwise_or(cs->color_space_type())
@@ -398,6 +444,36 @@ ColorSpaceManImpl::color_space_load(intrusive_ptr<IColorSpace> cs)
 }
 
 
+
+//
+//
+//
+ColorSpaceManImpl::ICCKey::ICCKey(MD5Hash::Sum const& digest_,
+                                  int num_components_,
+                                  ColorSpaceHandle alternate_)
+    : num_components(num_components_)
+    , alternate(alternate_)
+{
+    memcpy(digest, digest_, sizeof(digest));
+}
+
+
+
+//
+//
+//
+bool ColorSpaceManImpl::ICCKey::operator<(ICCKey const& other) const
+{
+    if (int cmp = memcmp(digest, other.digest, sizeof(digest)))
+        return cmp < 0;
+
+    if (num_components != other.num_components)
+        return num_components < other.num_components;
+
+    return alternate < other.alternate;
+}
+
+
 int ColorSpaceManImpl::num_components(ColorSpaceHandle csh) const
 {
     return m_cs_table.lookup(unmask_handle(csh))->num_components();
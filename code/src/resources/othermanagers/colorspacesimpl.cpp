@@ -11,10 +11,11 @@
 #include <core/generic/floatpointtools.h>
 #include <core/generic/containerhelpers.h>
 #include <core/generic/refcountedimpl.h>
-#include <core/generic/null_deleter.h>
 #include <core/errlib/errlib.h>
 #include <core/jstd/file_stream.h>
 #include <core/jstd/fileso.h>
+#include <core/jstd/memory_stream.h>
+#include <core/jstd/streamhelpers.h>
 #include <msg_resources.h>
 #include <string.h>
 
@@ -330,9 +331,8 @@ boost::intrusive_ptr<IColorSpace> CIELabImpl::clone() const
 
 ICCBasedImpl::ICCBasedImpl()
     : m_num_components(-1)
-#ifdef _DEBUG
-    , m_stream_retrieved(false)
-#endif
+    , m_profile(0)
+    , m_profile_size(0)
 {
 }
 
@@ -341,7 +341,7 @@ ICCBasedImpl::ICCBasedImpl()
 void ICCBasedImpl::check_validity() const
 {
     if (m_num_components==-1
-        || (!is_file(m_file_path.c_str()) && !m_stream.get()))
+        || (!is_file(m_file_path.c_str()) && !m_stream.get() && !m_profile))
     {
         throw exception_invalid_value(msg_invalid_cs_spec()) << JAGLOC;
     }
@@ -374,6 +374,8 @@ void ICCBasedImpl::icc_profile(Char const* file_path)
         throw exception_invalid_value(msg_invalid_argument()) << JAGLOC;
 
     m_stream.reset();
+    m_profile = 0;
+    m_profile_buffer.reset();
     m_file_path.assign(file_path);
 }
 
@@ -397,38 +399,82 @@ boost::intrusive_ptr<IColorSpace> ICCBasedImpl::clone() const
     cloned->m_alternate = m_alternate;
     cloned->m_file_path = m_file_path;
     cloned->m_stream = m_stream;
+    cloned->m_profile = m_profile;
+    cloned->m_profile_size = m_profile_size;
+    cloned->m_profile_buffer = m_profile_buffer;
     return cloned;
 }
 
 
 
+void ICCBasedImpl::icc_profile_stream(std::auto_ptr<ISeqStreamInput> stream)
+{
+    m_stream = stream;
+    m_profile = 0;
+    m_profile_buffer.reset();
+    m_file_path.clear();
+}
+
+
+
+/**
+ * @brief Uses a profile which lives as long as the process, e.g. a built-in one.
+ *
+ * The data are not copied.
+ */
+void ICCBasedImpl::icc_profile_static(Byte const* data, size_t size)
+{
+    JAG_PRECONDITION(data && size);
+    m_stream.reset();
+    m_file_path.clear();
+    m_profile_buffer.reset();
+    m_profile = data;
+    m_profile_size = size;
+}
+
+
+
 /**
- * @brief Provides stream containing the profile.
+ * @brief Reads the profile into memory.
  *
- * @todo return a stream proxy instead of the member
- * @return icc profile stream
+ * Called when the color space is being registered so that the profile can be
+ * hashed and written as many times as needed. A static profile is not copied.
  */
-boost::shared_ptr<ISeqStreamInput> ICCBasedImpl::icc_profile() const
+void ICCBasedImpl::fetch_profile()
 {
-    if (m_stream.get())
+    if (m_profile)
+        return;
+
+    std::auto_ptr<ISeqStreamInput> file_stream;
+    ISeqStreamInput* src = m_stream.get();
+    if (!src)
     {
-#ifdef _DEBUG
-        JAG_ASSERT(!m_stream_retrieved && "stream retrieved more than once");
-        m_stream_retrieved = 1;
-#endif
-        return boost::shared_ptr<ISeqStreamInput>(m_stream.get(), null_deleter);
+        file_stream.reset(new FileStreamInput(m_file_path.c_str()));
+        src = file_stream.get();
     }
 
-    return boost::shared_ptr<ISeqStreamInput>(
-        new FileStreamInput(m_file_path.c_str()));
+    MemoryStreamOutput profile;
+    copy_stream(*src, profile);
+    m_stream.reset();
+
+    m_profile_buffer = profile.shared_data();
+    m_profile = m_profile_buffer.get();
+    m_profile_size = static_cast<size_t>(profile.tell());
+    if (!m_profile_size)
+        throw exception_invalid_value(msg_invalid_cs_spec()) << JAGLOC;
 }
 
 
 
-void ICCBasedImpl::icc_profile_stream(std::auto_ptr<ISeqStreamInput> stream)
+/**
+ * @brief Provides the profile data.
+ *
+ * @pre fetch_profile() has been called
+ */
+Byte const* ICCBasedImpl::profile_data() const
 {
-    m_stream = stream;
-    m_file_path.clear();
+    JAG_PRECONDITION(m_profile);
+    return m_profile;
 }
 
 }} // namespace jag::resources
@@ -18,6 +18,7 @@
 #include <boost/functional/hash.hpp>
 #include <boost/tuple/tuple_comparison.hpp>
 #include <boost/intrusive_ptr.hpp>
+#include <algorithm>
 
 
 using namespace jag::jstd;
@@ -26,6 +27,29 @@ using namespace boost;
 namespace jag {
 namespace resources {
 
+namespace
+{
+  //
+  // Checks [start, end) byte offset pairs passed to IFont::advances().
+  //
+  void check_text_ranges(Char const* text,
+                         UInt const* ranges, UInt length,
+                         UInt widths_length)
+  {
+      if (length % 2 || widths_length < length / 2)
+          throw exception_invalid_value(msg_invalid_argument()) << JAGLOC;
+
+      const size_t text_length = strlen(text);
+      for(UInt i=0; i<length; i+=2)
+      {
+          if (ranges[i] > ranges[i+1] || ranges[i+1] > text_length)
+              throw exception_invalid_value(msg_invalid_argument()) << JAGLOC;
+      }
+  }
+
+} // anonymous namespace
+
+
 // ---------------------------------------------------------------------------
 //                 class FontImpl
 
@@ -88,8 +112,17 @@ Double FontImpl::horizontal_advance_dbg(jag::Char const* text, jag::ULong length
     UnicodeConverter* conv(m_conv_ctrl.acquire_converter());
     ON_BLOCK_EXIT_OBJ(m_conv_ctrl, &jstd::UConverterCtrl::release_converter);
 
+    return advance_conv(conv, text, text + length);
+}
+
+
+///
+/// Retrieves width of [text, end) using an already acquired converter.
+///
+Double FontImpl::advance_conv(UnicodeConverter* conv,
+                              Char const* text, Char const* end) const
+{
     Double result = 0.0;
-    Char const*const end = text + length;
     if (conv)
     {
         if (m_kerning)
@@ -165,6 +198,63 @@ Double FontImpl::advance_r(jag::Char const* start, jag::Char const* end) const
 }
 
 
+///
+/// The converter is acquired only once for all the substrings.
+///
+void FontImpl::advances(Char const* text,
+                        UInt const* ranges, UInt length,
+                        Double* widths, UInt widths_length) const
+{
+    check_text_ranges(text, ranges, length, widths_length);
+
+    UnicodeConverter* conv(m_conv_ctrl.acquire_converter());
+    ON_BLOCK_EXIT_OBJ(m_conv_ctrl, &jstd::UConverterCtrl::release_converter);
+
+    for(UInt i=0; i<length; i+=2)
+        *widths++ = advance_conv(conv, text + ranges[i], text + ranges[i+1]);
+}
+
+
+///
+/// Accumulates the width in the same order as advance_conv() so that the last
+/// position is exactly equal to advance().
+///
+UInt FontImpl::char_positions(Char const* text,
+                              Double* positions, UInt positions_length) const
+{
+    UnicodeConverter* conv(m_conv_ctrl.acquire_converter());
+    ON_BLOCK_EXIT_OBJ(m_conv_ctrl, &jstd::UConverterCtrl::release_converter);
+
+    Char const*const end = text + strlen(text);
+    Double result = 0.0;
+    UInt num_chars = 0;
+    Int prev = 0;
+    while (text != end)
+    {
+        if (conv)
+        {
+            Int cp = conv->next_code_point(&text, end);
+            result += m_typeface.char_horizontal_advance(cp);
+            if (m_kerning)
+                result += m_typeface.kerning_for_chars(prev, cp);
+            prev = cp;
+        }
+        else
+        {
+            // built-it font encoding
+            result += m_typeface.char_horizontal_advance(*text++);
+        }
+
+        if (num_chars < positions_length)
+            positions[num_chars] = m_coef * result;
+
+        ++num_chars;
+    }
+
+    return num_chars;
+}
+
+
 
 
 Int FontImpl::is_in_font_dbg(jag::Char const* text, jag::UInt length) const
@@ -312,6 +402,66 @@ Double MultiEncFontImpl::advance_r(jag::Char const* start, jag::Char const* end)
 }
 
 
+//
+//
+//
+void MultiEncFontImpl::advances(Char const* text,
+                                UInt const* ranges, UInt length,
+                                Double* widths, UInt widths_length) const
+{
+    check_text_ranges(text, ranges, length, widths_length);
+
+    for(UInt i=0; i<length; i+=2)
+        *widths++ = advance_r(text + ranges[i], text + ranges[i+1]);
+}
+
+
+//
+// Characters are passed to the font of their encoding segment by segment, the
+// positions are offset by the width of the preceding segments.
+//
+UInt MultiEncFontImpl::char_positions(Char const* text,
+                                      Double* positions, UInt positions_length) const
+{
+    Double offset = 0.0;
+    UInt num_chars = 0;
+    std::vector<Char> str;
+    UnicodeToCPIterator it(
+        m_from_unicode->create_iterator(text, text + strlen(text)));
+
+    for(;;)
+    {
+        EnumCharacterEncoding* enc = it.next(str);
+        if (!enc)
+            break;
+
+        IFontEx const& fnt = font_for_encoding(*enc);
+        const UInt first = num_chars;
+        if (first < positions_length)
+        {
+            str.push_back(0);
+            num_chars += fnt.char_positions(&str[0],
+                                            positions + first,
+                                            positions_length - first);
+            str.pop_back();
+
+            const UInt last = (std::min)(num_chars, positions_length);
+            for(UInt i=first; i<last; ++i)
+                positions[i] += offset;
+        }
+        else
+        {
+            // single-byte encodings only
+            num_chars += static_cast<UInt>(str.size());
+        }
+
+        offset += fnt.horizontal_advance_dbg(&str[0], str.size());
+    }
+
+    return num_chars;
+}
+
+
 Double MultiEncFontImpl::glyph_width(UInt16 /*glyph_index*/) const
 {
     throw exception_invalid_operation() << JAGLOC;
@@ -0,0 +1,175 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+
+#include "precompiled.h"
+#include <resources/typeman/kerningindex.h>
+#include <core/generic/autoarray.h>
+#include <core/generic/assert.h>
+
+#include FT_TRUETYPE_TAGS_H
+#include FT_TRUETYPE_TABLES_H
+
+namespace jag {
+namespace resources {
+
+namespace
+{
+  // gids are less than 0xffff, so no pair maps to this key
+  const boost::uint32_t EMPTY_KEY = 0xffffffff;
+
+  inline boost::uint32_t pair_key(UInt left, UInt right)
+  {
+      return (static_cast<boost::uint32_t>(left) << 16) | (right & 0xffff);
+  }
+
+  inline UInt read_ushort(Byte const* p)
+  {
+      return (p[0] << 8) | p[1];
+  }
+
+  //
+  // Retrieves keys of pairs stored in the horizontal format 0 subtables of
+  // the 'kern' table (the Microsoft version of the table, as FreeType).
+  //
+  void kern_table_pairs(FT_Face face, std::vector<boost::uint32_t>& keys)
+  {
+      FT_ULong length = 0;
+      if (FT_Load_Sfnt_Table(face, TTAG_kern, 0, 0, &length) || length < 4)
+          return;
+
+      auto_array<Byte> table(length);
+      if (FT_Load_Sfnt_Table(face, TTAG_kern, 0, table.ptr(), &length))
+          return;
+
+      Byte const* p = table.ptr();
+      Byte const*const end = p + length;
+      if (read_ushort(p) != 0)
+          return;
+
+      UInt num_tables = read_ushort(p + 2);
+      p += 4;
+      for(; num_tables && p + 6 <= end; --num_tables)
+      {
+          const UInt subtable_length = read_ushort(p + 2);
+          const UInt coverage = read_ushort(p + 4);
+          Byte const* next = p + subtable_length;
+          if (subtable_length <= 6 + 8 || next > end)
+              next = end;
+
+          if ((coverage >> 8) == 0 && (coverage & 3) == 1 && p + 14 <= next)
+          {
+              UInt num_pairs = read_ushort(p + 6);
+              Byte const* pair = p + 14;
+              // The pair count or the subtable length overflows in some
+              // fonts. Reading more pairs is harmless as the values are
+              // queried from FreeType.
+              const UInt available = static_cast<UInt>((end - pair) / 6);
+              if (num_pairs > available || num_tables == 1)
+                  num_pairs = available;
+
+              for(; num_pairs; --num_pairs, pair += 6)
+                  keys.push_back(pair_key(read_ushort(pair), read_ushort(pair + 2)));
+          }
+
+          p = next;
+      }
+  }
+
+} // anonymous namespace
+
+
+//////////////////////////////////////////////////////////////////////////
+KerningIndex::KerningIndex()
+{
+}
+
+
+/**
+ * @brief Fills the index with kerning pairs of the given face.
+ */
+void KerningIndex::build(FT_Face face)
+{
+    m_keys.clear();
+    m_values.clear();
+    if (!FT_HAS_KERNING(face))
+        return;
+
+    std::vector<boost::uint32_t> keys;
+    kern_table_pairs(face, keys);
+
+    // load factor at most 1/2
+    size_t size = 16;
+    while(size < 2 * keys.size())
+        size <<= 1;
+
+    m_keys.resize(size, EMPTY_KEY);
+    m_values.resize(size, 0);
+    for(size_t i=0; i<keys.size(); ++i)
+    {
+        FT_Vector delta;
+        if (FT_Get_Kerning(face, keys[i] >> 16, keys[i] & 0xffff,
+                           FT_KERNING_UNSCALED, &delta))
+        {
+            continue;
+        }
+
+        if (delta.x)
+            insert(keys[i], static_cast<Int>(delta.x));
+    }
+}
+
+
+/**
+ * @brief Retrieves kerning for the given pair of glyphs, in font units.
+ */
+Int KerningIndex::kerning(UInt left, UInt right) const
+{
+    if (m_keys.empty())
+        return 0;
+
+    const boost::uint32_t key = pair_key(left, right);
+    const size_t mask = m_keys.size() - 1;
+    for(size_t i = slot(key); ; i = (i + 1) & mask)
+    {
+        if (m_keys[i] == key)
+            return m_values[i];
+
+        if (m_keys[i] == EMPTY_KEY)
+            return 0;
+    }
+}
+
+
+//
+//
+//
+void KerningIndex::insert(boost::uint32_t key, Int value)
+{
+    JAG_PRECONDITION(key != EMPTY_KEY);
+    const size_t mask = m_keys.size() - 1;
+    size_t i = slot(key);
+    while(m_keys[i] != EMPTY_KEY && m_keys[i] != key)
+        i = (i + 1) & mask;
+
+    m_keys[i] = key;
+    m_values[i] = value;
+}
+
+
+//
+// Initial slot of the key, multiplicative hashing.
+//
+size_t KerningIndex::slot(boost::uint32_t key) const
+{
+    return static_cast<size_t>(
+        (key * static_cast<boost::uint32_t>(2654435761U)) >> 8) & (m_keys.size() - 1);
+}
+
+
+}} // namespace jag::resources
+
+/** EOF @file */
@@ -14,6 +14,7 @@
 #include <core/generic/assert.h>
 #include <core/jstd/tracer.h>
 #include <map>
+#include <set>
 
 using namespace boost::integer;
 
@@ -0,0 +1,85 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+
+#include "precompiled.h"
+#include "typefacecache.h"
+#include "freetypeopenargs.h"
+#include <resources/typeman/typefaceimpl.h>
+#include <core/jstd/fileso.h>
+#include <core/errlib/errlib.h>
+
+using namespace jag::jstd;
+using namespace boost;
+
+namespace jag {
+namespace resources {
+
+namespace
+{
+  // Constructed during static initialization, i.e. before any
+  // document can be created.
+  TypefaceCache g_typeface_cache;
+
+  shared_ptr<FT_LibraryRec_> create_ft_library()
+  {
+      FT_Library ft_library;
+      FT_Error err = FT_Init_FreeType(&ft_library);
+      if (err) {
+          JAG_INTERNAL_ERROR_MSG_CODE("FreeType initialization failed", err);
+      }
+
+      return shared_ptr<FT_LibraryRec_>(ft_library, &FT_Done_FreeType);
+  }
+} // anonymous namespace
+
+
+//
+//
+//
+TypefaceCache& typeface_cache()
+{
+    return g_typeface_cache;
+}
+
+
+///
+/// Retrieves a typeface for the given font file, the typeface is
+/// loaded if it is not cached yet or if the file has changed.
+///
+shared_ptr<ITypeface> TypefaceCache::typeface_from_file(Char const* filename)
+{
+    // checks that the file exists
+    std::auto_ptr<FTOpenArgs> ft_args(new FTOpenArgs(filename));
+    uintmax_t const size = file_size(filename);
+    uintmax_t const mtime = file_mtime(filename);
+
+    ScopedLock lock(m_mutex);
+    Entries::iterator it = m_entries.find(filename);
+    if (it != m_entries.end() &&
+        it->second.size == size &&
+        it->second.mtime == mtime)
+    {
+        return it->second.typeface;
+    }
+
+    Entry entry;
+    entry.size = size;
+    entry.mtime = mtime;
+    entry.typeface.reset(new TypefaceImpl(create_ft_library(), ft_args));
+
+    if (it != m_entries.end())
+        it->second = entry;
+    else
+        m_entries.insert(std::make_pair(std::string(filename), entry));
+
+    return entry.typeface;
+}
+
+
+}} // namespace jag::resources
+
+/** EOF @file */
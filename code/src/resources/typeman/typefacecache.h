@@ -0,0 +1,66 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+
+#ifndef __TYPEFACECACHE_H_JAG_2207__
+#define __TYPEFACECACHE_H_JAG_2207__
+
+#include <core/generic/noncopyable.h>
+#include <core/jstd/thread.h>
+#include <interfaces/stdtypes.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
+#include <string>
+#include <map>
+
+namespace jag {
+class ITypeface;
+
+namespace resources {
+
+///
+/// Process-wide cache of typefaces loaded from font files.
+///
+/// Parsing a font file is expensive compared to producing a small
+/// document, so documents can share typefaces through this cache
+/// (see the fonts.shared_cache option). Entries are keyed by the file
+/// path and are reloaded once the file size or modification time
+/// changes. Cached typefaces live until the process exits, a typeface
+/// replaced by a reload lives as long as some document refers to it.
+///
+/// Each cached typeface owns its FreeType library instance so that
+/// typefaces can be created and released from any thread.
+///
+class TypefaceCache
+    : public noncopyable
+{
+public:
+    boost::shared_ptr<ITypeface> typeface_from_file(Char const* filename);
+
+private:
+    struct Entry
+    {
+        boost::uintmax_t            size;
+        boost::uintmax_t            mtime;
+        boost::shared_ptr<ITypeface> typeface;
+    };
+
+    typedef std::map<std::string, Entry> Entries;
+
+    jstd::Mutex     m_mutex;
+    Entries         m_entries;
+};
+
+
+/// retrieves the process-wide typeface cache
+TypefaceCache& typeface_cache();
+
+
+}} // namespace jag::resources
+
+#endif //__TYPEFACECACHE_H_JAG_2207__
+
+/** EOF @file */
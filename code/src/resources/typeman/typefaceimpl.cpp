@@ -14,6 +14,7 @@
 #include <core/errlib/errlib.h>
 #include <core/jstd/tracer.h>
 #include <resources/typeman/typefaceimpl.h>
+#include <resources/typeman/kerningindex.h>
 #include <resources/typeman/typefaceutils.h>
 #include <resources/typeman/truetypetable.h>
 #include <resources/typeman/truetype/ttfont.h>
@@ -23,6 +24,7 @@
 
 #include FT_TRUETYPE_TABLES_H
 #include FT_TRUETYPE_TAGS_H
+#include FT_ADVANCES_H
 #include <freetype/ftxf86.h>
 
 using namespace jag::jstd;
@@ -65,6 +67,7 @@ TypefaceImpl::TypefaceImpl(boost::shared_ptr<FT_LibraryRec_> ftlib,
     calculate_hash();
     detect_type();
     preflight();
+    build_lookup_tables();
     
     JAG_POSTCONDITION(m_face);
 }
@@ -171,6 +174,7 @@ TypefaceImpl::font_program(int index, unsigned options) const
     if (options & EXTRACT_CFF)
     {
         JAG_ASSERT(m_type == FACE_OPEN_TYPE_CFF);
+        ScopedLock lock(m_face_mutex);
         FT_ULong cff_len = 0;
         FT_Error err = FT_Load_Sfnt_Table(
             m_face, FT_MAKE_TAG('C', 'F', 'F', ' '), 0, 0, &cff_len);
@@ -342,6 +346,7 @@ Char const* TypefaceImpl::family_name() const
 
 Char const* TypefaceImpl::postscript_name() const
 {
+    ScopedLock lock(m_face_mutex);
     return FT_Get_Postscript_Name(m_face);
 }
 
@@ -416,7 +421,16 @@ UInt16 TypefaceImpl::codepoint_to_gid(Int codepoint) const
     {
     case FACE_TRUE_TYPE:
     case FACE_OPEN_TYPE_CFF:
-        gid = static_cast<UInt16>(FT_Get_Char_Index(m_face, codepoint));
+        if (codepoint >= 0 && codepoint < static_cast<Int>(m_bmp_to_gid.size()))
+        {
+            gid = m_bmp_to_gid[codepoint];
+        }
+        else
+        {
+            AstralToGid::const_iterator it = m_astral_to_gid.find(codepoint);
+            if (it != m_astral_to_gid.end())
+                gid = it->second;
+        }
         break;
 
     default:
@@ -430,11 +444,19 @@ UInt16 TypefaceImpl::codepoint_to_gid(Int codepoint) const
 // 
 FaceCharIterator TypefaceImpl::char_iterator() const
 {
-    return FaceCharIterator(m_face);
+    return FaceCharIterator(m_face, &m_face_mutex);
 }
 
 
 Int TypefaceImpl::gid_horizontal_advance(UInt gid) const
+{
+    return gid < m_gid_advances.size()
+        ? m_gid_advances[gid]
+        : 0;
+}
+
+
+Int TypefaceImpl::gid_horizontal_advance_unlocked(UInt gid) const
 {
     if (!FT_Load_Glyph(m_face, gid, FT_LOAD_NO_SCALE))
         return m_face->glyph->metrics.horiAdvance;
@@ -446,30 +468,70 @@ Int TypefaceImpl::gid_horizontal_advance(UInt gid) const
 
 Int TypefaceImpl::char_horizontal_advance(Int codepoint) const
 {
-    Int advance=0;
     switch(m_type)
     {
     case FACE_OPEN_TYPE_CFF:
-    case FACE_TRUE_TYPE: {
-        // if FT_Get_Char_Index returns 0, it means that there is no glyph for
-        // that code point, however we can still load glyph at index 0 which
+    case FACE_TRUE_TYPE:
+        // if there is no glyph for the code point then gid 0 is used, it
         // should represent missing character by convention
-        return gid_horizontal_advance(FT_Get_Char_Index(m_face, codepoint));
-    }
+        return gid_horizontal_advance(codepoint_to_gid(codepoint));
 
     default:
         JAG_TBD;
     }
 
-    return advance;
+    return 0;
+}
+
+
+//
+// Builds the gid to advance table (from hmtx for sfnt faces), the unicode to
+// gid tables and the kerning index so that the metrics queries do not need to
+// touch the face. The tables are shared by all fonts using this typeface.
+//
+// Called by the constructor, i.e. before the typeface can be shared.
+//
+void TypefaceImpl::build_lookup_tables()
+{
+    // advances, in font units
+    const FT_Long num_glyphs = m_face->num_glyphs;
+    m_gid_advances.resize(num_glyphs);
+    std::vector<FT_Fixed> advances(num_glyphs);
+    if (num_glyphs &&
+        !FT_Get_Advances(m_face, 0, num_glyphs, FT_LOAD_NO_SCALE, &advances[0]))
+    {
+        for(FT_Long gid=0; gid<num_glyphs; ++gid)
+            m_gid_advances[gid] = static_cast<Int>(advances[gid]);
+    }
+    else
+    {
+        for(FT_Long gid=0; gid<num_glyphs; ++gid)
+            m_gid_advances[gid] = gid_horizontal_advance_unlocked(gid);
+    }
+
+    // unicode charmap - flat for BMP, sparse for the other planes
+    m_bmp_to_gid.resize(0x10000, 0);
+    FT_UInt gid = 0;
+    FT_ULong codepoint = FT_Get_First_Char(m_face, &gid);
+    while(gid)
+    {
+        if (codepoint < 0x10000)
+            m_bmp_to_gid[codepoint] = static_cast<UInt16>(gid);
+        else
+            m_astral_to_gid[static_cast<Int>(codepoint)] = static_cast<UInt16>(gid);
+
+        codepoint = FT_Get_Next_Char(m_face, codepoint, &gid);
+    }
+
+    // kerning pairs
+    m_kerning.reset(new KerningIndex);
+    m_kerning->build(m_face);
 }
 
+
 Int TypefaceImpl::kerning_for_gids(UInt left, UInt right) const
 {
-    FT_Vector delta;
-    CHECK_FT(FT_Get_Kerning(m_face, left, right,
-                            FT_KERNING_UNSCALED, &delta));
-    return delta.x;
+    return m_kerning->kerning(left, right);
 }
 
 Int TypefaceImpl::kerning_for_chars(Int left, Int right) const
@@ -527,22 +589,20 @@ UInt16 UsedGlyphs::add_codepoint(Int codepoint)
         
     m_impl->update_glyphs = true;
 
-    typedef UsedGlyphs::CodepointToGlyph::iterator Iterator;
-    Iterator it = m_impl->codepoint_to_glyph.find(codepoint);
-    if (it == m_impl->codepoint_to_glyph.end())
+    UInt16 glyph;
+    if (!m_impl->codepoints.find(codepoint, glyph))
     {
-        UInt16 glyph = m_face.codepoint_to_gid(codepoint);
+        glyph = m_face.codepoint_to_gid(codepoint);
         if (!glyph)
         {
             TRACE_WRN << "Codepoint " << codepoint
                       << "not found in " << m_face.family_name();
         }
 
-        it = m_impl->codepoint_to_glyph.insert(
-            std::make_pair(codepoint, glyph)).first;
+        m_impl->codepoints.insert(codepoint, glyph);
     }
 
-    return it->second;
+    return glyph;
 }
 
 void UsedGlyphs::add_glyph(UInt16 glyph)
@@ -563,7 +623,7 @@ void UsedGlyphs::merge(UsedGlyphs const& other)
 {
     JAG_ASSERT(m_impl.unique());
     
-    if (m_impl->glyphs.empty() && m_impl->codepoint_to_glyph.empty())
+    if (m_impl->glyphs.empty() && m_impl->codepoints.empty())
     {
         // fast path
         JAG_ASSERT(&m_face == &other.m_face);
@@ -571,25 +631,9 @@ void UsedGlyphs::merge(UsedGlyphs const& other)
     }
     else
     {
-        JAG_TO_BE_TESTED;
-
-        Glyphs result;
-        std::set_union(
-            other.m_impl->glyphs.begin(),
-            other.m_impl->glyphs.end(),
-            m_impl->glyphs.begin(),
-            m_impl->glyphs.end(),
-            std::inserter(result, result.begin()));
-
-        m_impl->glyphs.swap(result);
-
-        typedef CodepointToGlyph::const_iterator MapIter;
-        MapIter end = other.m_impl->codepoint_to_glyph.end();
-        for(MapIter it = other.m_impl->codepoint_to_glyph.begin();
-            it != end; ++it)
-        {
-            m_impl->codepoint_to_glyph.insert(*it);
-        }
+        m_impl->glyphs.merge(other.m_impl->glyphs);
+        m_impl->codepoints.merge(other.m_impl->codepoints);
+        update_codepoint_to_glyph();
 
         if (other.m_impl->update_map)
             m_impl->update_map = true;
@@ -601,15 +645,18 @@ void UsedGlyphs::merge(UsedGlyphs const& other)
 
 void UsedGlyphs::update()
 {
+    if (!m_impl->update_glyphs && !m_impl->update_map)
+        return;
+
     if (m_impl->update_glyphs)
     {
         // update used glyphs by iterating the map and storing the values
-        typedef CodepointToGlyph::const_iterator MapIter;
-        MapIter end = m_impl->codepoint_to_glyph.end();
-        for(MapIter it = m_impl->codepoint_to_glyph.begin();
-            it != end; ++it)
+        CodepointTable const& codepoints(m_impl->codepoints);
+        for(Int cp = codepoints.next(-1); cp >= 0; cp = codepoints.next(cp))
         {
-            m_impl->glyphs.insert(it->second);
+            UInt16 glyph = 0;
+            codepoints.find(cp, glyph);
+            m_impl->glyphs.insert(glyph);
         }
 
         m_impl->update_glyphs = false;
@@ -625,12 +672,28 @@ void UsedGlyphs::update()
             Item const& item = it.current();
             if (m_impl->glyphs.count(static_cast<UInt16>(item.glyph)))
             {
-                m_impl->codepoint_to_glyph.insert(
-                    std::make_pair(item.codepoint, item.glyph));
+                m_impl->codepoints.insert(item.codepoint,
+                                          static_cast<UInt16>(item.glyph));
             }
         }
         m_impl->update_map = false;
     }
+
+    update_codepoint_to_glyph();
+}
+
+// makes the sorted copy of the codepoint table
+void UsedGlyphs::update_codepoint_to_glyph()
+{
+    CodepointToGlyph& map = m_impl->codepoint_to_glyph;
+    CodepointTable const& codepoints(m_impl->codepoints);
+    map.clear();
+    for(Int cp = codepoints.next(-1); cp >= 0; cp = codepoints.next(cp))
+    {
+        UInt16 glyph = 0;
+        codepoints.find(cp, glyph);
+        map.insert(map.end(), std::make_pair(cp, glyph));
+    }
 }
 
 void UsedGlyphs::set_update_glyphs()
@@ -649,9 +712,16 @@ void UsedGlyphs::set_update_map()
 // ---------------------------------------------------------------------------
 //                     class FaceCharIterator
 
-FaceCharIterator::FaceCharIterator(FT_FaceRec_* face)
+FaceCharIterator::FaceCharIterator(FT_FaceRec_* face, jstd::Mutex* lock)
     : m_face(face)
+    , m_lock(lock)
 {
+    if (m_lock)
+    {
+        ScopedLock guard(*m_lock);
+        m_item.codepoint = FT_Get_First_Char(m_face, &m_item.glyph);
+        return;
+    }
     m_item.codepoint = FT_Get_First_Char(m_face, &m_item.glyph);
 }
 
@@ -668,6 +738,14 @@ FaceCharIterator::Item const& FaceCharIterator::current() const
 
 void FaceCharIterator::next()
 {
+    if (m_lock)
+    {
+        ScopedLock guard(*m_lock);
+        m_item.codepoint = FT_Get_Next_Char(m_face,
+                                            m_item.codepoint,
+                                            &m_item.glyph);
+        return;
+    }
     m_item.codepoint = FT_Get_Next_Char(m_face,
                                         m_item.codepoint,
                                         &m_item.glyph);
@@ -11,6 +11,7 @@
 #include "fontspecimpl.h"
 #include "systemfontmapping.h"
 #include "freetypeopenargs.h"
+#include "typefacecache.h"
 #include "t1adobestandardface.h"
 #include <core/generic/checked_cast.h>
 #include <core/generic/refcountedimpl.h>
@@ -243,28 +244,33 @@ TypeManImpl::font_load_internal(FontSpecImpl const& specimpl,
     CharEncodingRecord const& required_enc(
         find_encoding_record(specimpl.encoding()));
 
-    std::auto_ptr<ITypeface> typeface_ptr;
+    shared_ptr<ITypeface> typeface_ptr;
     if (specimpl.adobe14())
     {
         if (required_enc.encoding == ENC_UTF_8)
             return create_adobe14_multienc_font(specimpl, exec_ctx);
         else
-            typeface_ptr = create_typeface_adobe14(specimpl);
+            typeface_ptr.reset(create_typeface_adobe14(specimpl).release());
     }
     else
     {
-        typeface_ptr = specimpl.defined_by_filename()
-            ? create_typeface_from_file(specimpl, exec_ctx, required_enc)
-            : create_typeface_by_search(specimpl, exec_ctx, required_enc);
+        if (specimpl.defined_by_filename())
+            typeface_ptr = create_typeface_from_file(specimpl, exec_ctx, required_enc);
+        else
+            typeface_ptr.reset(
+                create_typeface_by_search(specimpl, exec_ctx, required_enc).release());
 
         // client might want to disable synthesized fonts
         check_synthesized_font(specimpl, *typeface_ptr, exec_ctx);
     }
     JAG_ASSERT(typeface_ptr.get());
 
-    Typefaces::iterator face_it = m_typefaces.find(*typeface_ptr);
+    Typefaces::iterator face_it = m_typefaces.find(boost::ref(*typeface_ptr));
     if (face_it == m_typefaces.end())
-        face_it = m_typefaces.insert(typeface_ptr.release()).first;
+    {
+        face_it = m_typefaces.insert(boost::ref(*typeface_ptr)).first;
+        m_typefaces_storage.push_back(typeface_ptr);
+    }
 
     // create a font object and find out whether it is not already
     // present in our m_fonts_map, if so just return the associated
@@ -310,13 +316,16 @@ IFontEx const& TypeManImpl::lookup_font(
 ///
 /// Try to load the typeface from a file specified in fontspec.
 ///
-std::auto_ptr<ITypeface>
+shared_ptr<ITypeface>
 TypeManImpl::create_typeface_from_file(FontSpecImpl const& spec,
-                                       IExecContext const& /*ctx*/,
+                                       IExecContext const& ctx,
                                        CharEncodingRecord const& /*enc_rec*/) const
 {
+    if (ctx.config().get_int("fonts.shared_cache"))
+        return typeface_cache().typeface_from_file(spec.filename());
+
     std::auto_ptr<FTOpenArgs> ft_args(new FTOpenArgs(spec.filename()));
-    return std::auto_ptr<ITypeface>(new TypefaceImpl(m_ft_library, ft_args));
+    return shared_ptr<ITypeface>(new TypefaceImpl(m_ft_library, ft_args));
 }
 
 
@@ -432,7 +441,7 @@ void TypeManImpl::dbg_dump_typefaces() const
         ; ++it
    )
     {
-        printf("%s %s\n", (*it).family_name(), (*it).style_name());
+        printf("%s %s\n", it->get().family_name(), it->get().style_name());
     }
 }
 
@@ -0,0 +1,158 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+//
+// Reports deflate throughput and compression ratio for each level and
+// strategy. Compresses the files given on the command line, or synthetic
+// content and image data if there are none.
+//
+//   deflatebench [file ...]
+//
+
+#include <core/jstd/deflate.h>
+#include <core/jstd/memory_stream.h>
+#include <core/errlib/except.h>
+#include <vector>
+#include <string>
+#include <iostream>
+#include <stdio.h>
+#include <time.h>
+
+using namespace jag;
+using namespace jag::jstd;
+
+namespace
+{
+  typedef std::vector<char> Buffer;
+
+  // page content like data
+  void synthetic_content(Buffer& buffer)
+  {
+      char line[128];
+      for(int i=0; buffer.size() < (4U << 20); ++i)
+      {
+          int len = sprintf(line, "%d.%d %d.%d m %d %d l %d.%d %d.%d %d %d c S\n",
+                            i%612, i%10, i%792, i%7, (i*3)%612, (i*5)%792,
+                            i%100, i%3, i%200, i%9, i%50, i%70);
+          buffer.insert(buffer.end(), line, line+len);
+      }
+  }
+
+  // rgb gradient with noise
+  void synthetic_image(Buffer& buffer)
+  {
+      const int width = 1024;
+      const int height = 1024;
+      unsigned seed = 1;
+      buffer.reserve(width*height*3);
+      for(int y=0; y<height; ++y)
+      {
+          for(int x=0; x<width; ++x)
+          {
+              seed = seed * 1103515245 + 12345;
+              const int noise = (seed >> 16) & 7;
+              buffer.push_back(static_cast<char>((x >> 2) + noise));
+              buffer.push_back(static_cast<char>((y >> 2) + noise));
+              buffer.push_back(static_cast<char>(((x+y) >> 3) + noise));
+          }
+      }
+  }
+
+  bool read_file(char const* path, Buffer& buffer)
+  {
+      FILE* f = fopen(path, "rb");
+      if (!f)
+          return false;
+
+      char chunk[65536];
+      size_t read;
+      while((read = fread(chunk, 1, sizeof(chunk), f)) > 0)
+          buffer.insert(buffer.end(), chunk, chunk+read);
+
+      fclose(f);
+      return true;
+  }
+
+  void run(std::string const& name, Buffer const& data)
+  {
+      static const char* strategy_names[] = { "default", "filtered", "huffman", "rle" };
+      static const DeflateStrategy strategies[] = {
+          DEFLATE_DEFAULT, DEFLATE_FILTERED, DEFLATE_HUFFMAN_ONLY, DEFLATE_RLE
+      };
+      static const int levels[] = { 1, 3, 6, 9 };
+
+      printf("%s: %lu bytes\n", name.c_str(), static_cast<unsigned long>(data.size()));
+      printf("  %-8s %5s %10s %8s\n", "strategy", "level", "MB/s", "ratio");
+      for(size_t s=0; s<sizeof(strategies)/sizeof(strategies[0]); ++s)
+      {
+          for(size_t l=0; l<sizeof(levels)/sizeof(levels[0]); ++l)
+          {
+              const DeflateParams params(levels[l], strategies[s]);
+              ULong compressed = 0;
+              int rounds = 0;
+              const clock_t start = clock();
+              clock_t elapsed;
+              do
+              {
+                  MemoryStreamOutput out;
+                  std::auto_ptr<ISeqStreamOutputControl> deflate(
+                      create_deflate_stream(out, params));
+                  deflate->write(&data[0], data.size());
+                  deflate->close();
+                  compressed = out.tell();
+                  ++rounds;
+                  elapsed = clock() - start;
+              }
+              while(elapsed < CLOCKS_PER_SEC / 2);
+
+              const double seconds = static_cast<double>(elapsed) / CLOCKS_PER_SEC;
+              const double mb = static_cast<double>(data.size()) * rounds / (1 << 20);
+              printf("  %-8s %5d %10.1f %8.3f\n",
+                     strategy_names[s], levels[l], mb / seconds,
+                     static_cast<double>(data.size()) / compressed);
+          }
+      }
+  }
+
+} // anonymous namespace
+
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        if (argc < 2)
+        {
+            Buffer content;
+            synthetic_content(content);
+            run("content (synthetic)", content);
+
+            Buffer image;
+            synthetic_image(image);
+            run("image (synthetic)", image);
+        }
+
+        for(int i=1; i<argc; ++i)
+        {
+            Buffer data;
+            if (!read_file(argv[i], data) || data.empty())
+            {
+                fprintf(stderr, "cannot read %s\n", argv[i]);
+                return 1;
+            }
+            run(argv[i], data);
+        }
+    }
+    catch(jag::exception const& exc)
+    {
+        jag::output_exception(exc, std::cerr);
+        return 1;
+    }
+
+    return 0;
+}
+
+/** EOF @file */
@@ -0,0 +1,159 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+#include "testtools.h"
+#include <core/jstd/glyphtables.h>
+#include <algorithm>
+#include <iterator>
+#include <set>
+#include <vector>
+
+using namespace jag;
+using namespace jag::jstd;
+
+namespace
+{
+  std::vector<UInt16> elements(GlyphSet const& glyphs)
+  {
+      std::vector<UInt16> result;
+      std::copy(glyphs.begin(), glyphs.end(), std::back_inserter(result));
+      return result;
+  }
+
+  void test_glyph_set()
+  {
+      GlyphSet glyphs;
+      BOOST_TEST(glyphs.empty());
+      BOOST_TEST(glyphs.begin() == glyphs.end());
+      BOOST_TEST(!glyphs.count(0));
+
+      // word boundaries and both ends of the range, inserted out of order
+      const UInt16 inserted[] = { 0xffff, 32, 31, 0, 64, 1000, 33, 0xffe0 };
+      std::set<UInt16> expected;
+      for(size_t i=0; i<sizeof(inserted)/sizeof(inserted[0]); ++i)
+      {
+          BOOST_TEST(glyphs.insert(inserted[i]));
+          expected.insert(inserted[i]);
+      }
+      BOOST_TEST(!glyphs.insert(32));
+      BOOST_TEST(glyphs.size() == expected.size());
+      BOOST_TEST(glyphs.count(0xffff) == 1);
+      BOOST_TEST(glyphs.count(0xfffe) == 0);
+
+      // ascending order
+      std::vector<UInt16> result(elements(glyphs));
+      BOOST_TEST(result == std::vector<UInt16>(expected.begin(), expected.end()));
+      BOOST_TEST(*glyphs.begin() == 0);
+      GlyphSet::const_iterator it = glyphs.begin();
+      BOOST_TEST(*it++ == 0);
+      BOOST_TEST(*it == 31);
+
+      // merge, the size counts the common glyphs once
+      GlyphSet other;
+      other.insert(31);
+      other.insert(2);
+      other.insert(0xfffe);
+      GlyphSet merged(glyphs);
+      merged.merge(other);
+      BOOST_TEST(merged.size() == expected.size() + 2);
+      expected.insert(2);
+      expected.insert(0xfffe);
+      BOOST_TEST(elements(merged) == std::vector<UInt16>(expected.begin(), expected.end()));
+
+      // merging into or from an empty set
+      GlyphSet empty;
+      empty.merge(other);
+      BOOST_TEST(elements(empty) == elements(other));
+      other.merge(GlyphSet());
+      BOOST_TEST(other.size() == 3);
+  }
+
+
+  std::vector<Int> codepoints(CodepointTable const& table)
+  {
+      std::vector<Int> result;
+      for(Int cp = table.next(-1); cp >= 0; cp = table.next(cp))
+          result.push_back(cp);
+      return result;
+  }
+
+  void test_codepoint_table()
+  {
+      CodepointTable table;
+      UInt16 glyph = 0;
+      BOOST_TEST(table.next(-1) == -1);
+      BOOST_TEST(!table.find(0, glyph));
+      BOOST_TEST(!table.find(0x10ffff, glyph));
+
+      // page boundaries, glyph 0 and 0xffff are valid values
+      table.insert(0x100, 7);
+      table.insert(0xff, 0);
+      table.insert(0x10ffff, 0xffff);
+      table.insert(0, 1);
+      table.insert(0x1f600, 2);
+      BOOST_TEST(table.find(0xff, glyph) && glyph == 0);
+      BOOST_TEST(table.find(0x10ffff, glyph) && glyph == 0xffff);
+      BOOST_TEST(!table.find(0x101, glyph));
+      BOOST_TEST(!table.find(0x1f5ff, glyph));
+
+      // the first assignment wins
+      table.insert(0x100, 8);
+      BOOST_TEST(table.find(0x100, glyph) && glyph == 7);
+
+      // ascending order
+      const Int expected[] = { 0, 0xff, 0x100, 0x1f600, 0x10ffff };
+      BOOST_TEST(codepoints(table) == std::vector<Int>(expected, expected + 5));
+      BOOST_TEST(table.next(0x100) == 0x1f600);
+      BOOST_TEST(table.next(0x10ffff) == -1);
+
+      // invalid codepoints are found but not iterated
+      BOOST_TEST(!table.find(-5, glyph));
+      table.insert(-5, 3);
+      table.insert(0x110000, 0);
+      BOOST_TEST(table.find(-5, glyph) && glyph == 3);
+      BOOST_TEST(table.find(0x110000, glyph) && glyph == 0);
+      BOOST_TEST(codepoints(table) == std::vector<Int>(expected, expected + 5));
+
+      // merge keeps the assignments of the target
+      CodepointTable other;
+      other.insert(0x100, 9);
+      other.insert(0x41, 4);
+      other.insert(-6, 5);
+      table.merge(other);
+      BOOST_TEST(table.find(0x100, glyph) && glyph == 7);
+      BOOST_TEST(table.find(0x41, glyph) && glyph == 4);
+      BOOST_TEST(table.find(-6, glyph) && glyph == 5);
+      BOOST_TEST(codepoints(table).size() == 6);
+      BOOST_TEST(table.next(0) == 0x41);
+
+      CodepointTable empty;
+      BOOST_TEST(empty.empty());
+      empty.merge(other);
+      BOOST_TEST(!empty.empty());
+      BOOST_TEST(codepoints(empty) == codepoints(other));
+
+      CodepointTable invalid_only;
+      invalid_only.insert(-1, 0);
+      BOOST_TEST(!invalid_only.empty());
+      BOOST_TEST(invalid_only.next(-1) == -1);
+  }
+
+  void test()
+  {
+      test_glyph_set();
+      test_codepoint_table();
+  }
+} // anonymous namespace
+
+int glyphtables(int, char ** const)
+{
+    int result = guarded_test_run(test);
+    result += boost::report_errors();
+    return result;
+}
+
+
+/** EOF @file */
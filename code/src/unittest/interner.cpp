@@ -0,0 +1,46 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+#include "testtools.h"
+#include "internersamples.h"
+
+using namespace jag;
+
+namespace
+{
+  void test()
+  {
+      GSDictInterner interner;
+      const int num_distinct = 1000;
+      for(int i=0; i<num_distinct; ++i)
+      {
+          std::pair<size_t,bool> result(interner.intern(gs_dict(i)));
+          BOOST_TEST(result.second);
+          BOOST_TEST(result.first == static_cast<size_t>(i));
+      }
+      BOOST_TEST(interner.size() == static_cast<size_t>(num_distinct));
+
+      // the table was rehashed several times, equal values are still found
+      for(int i=num_distinct; i--;)
+      {
+          std::pair<size_t,bool> result(interner.intern(gs_dict(i)));
+          BOOST_TEST(!result.second);
+          BOOST_TEST(result.first == static_cast<size_t>(i));
+          BOOST_TEST(interner.value(i) == gs_dict(i));
+      }
+      BOOST_TEST(interner.size() == static_cast<size_t>(num_distinct));
+  }
+} // anonymous namespace
+
+int interner(int, char ** const)
+{
+    int result = guarded_test_run(test);
+    result += boost::report_errors();
+    return result;
+}
+
+
+/** EOF @file */
@@ -0,0 +1,68 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+//
+// Compares lookups of graphics state dictionaries in std::map and in
+// Interner.
+//
+//   internerbench [num_lookups]
+//
+
+#include "internersamples.h"
+#include <map>
+#include <vector>
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace jag;
+
+namespace
+{
+  // a chart setting alpha for each shape
+  std::vector<pdf::GraphicsStateDictionary> sample_dicts(int num)
+  {
+      std::vector<pdf::GraphicsStateDictionary> dicts(num);
+      for(int i=0; i<num; ++i)
+          dicts[i] = gs_dict((i % 1000) * 7919 % 1000);
+      return dicts;
+  }
+
+  void benchmark(std::vector<pdf::GraphicsStateDictionary> const& dicts)
+  {
+      size_t checksum = 0;
+
+      clock_t start = clock();
+      std::map<pdf::GraphicsStateDictionary,size_t> map;
+      for(size_t i=0; i<dicts.size(); ++i)
+          checksum += map.insert(std::make_pair(dicts[i], map.size())).first->second;
+      clock_t map_time = clock() - start;
+
+      start = clock();
+      GSDictInterner interner;
+      for(size_t i=0; i<dicts.size(); ++i)
+          checksum -= interner.intern(dicts[i]).first;
+      clock_t interner_time = clock() - start;
+
+      if (checksum)
+          fprintf(stderr, "checksum mismatch\n");
+
+      printf("%d lookups: std::map %.0f ms, Interner %.0f ms\n",
+             static_cast<int>(dicts.size()),
+             map_time * 1000.0 / CLOCKS_PER_SEC,
+             interner_time * 1000.0 / CLOCKS_PER_SEC);
+  }
+} // anonymous namespace
+
+
+int main(int argc, char** argv)
+{
+    const int num = argc > 1 ? atoi(argv[1]) : 1000000;
+    benchmark(sample_dicts(num));
+    return 0;
+}
+
+/** EOF @file */
@@ -0,0 +1,38 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+#ifndef INTERNERSAMPLES_JG2114_H__
+#define INTERNERSAMPLES_JG2114_H__
+#include <interfaces/stdtypes.h>
+#include <resources/interfaces/resourcehandle.h>
+#include <core/generic/interner.h>
+#include "graphicsstatedictionary.h"
+#include <boost/functional/hash.hpp>
+
+//
+// Graphics state dictionaries interned the same way as in ResourceManagement,
+// shared by the Interner test and benchmark.
+//
+typedef jag::Interner<jag::pdf::GraphicsStateDictionary,
+                      boost::hash<jag::pdf::GraphicsStateDictionary>,
+                      jag::pdf::GraphicsStateDictionaryEquivalent> GSDictInterner;
+
+
+//
+// A dictionary as set by alpha(), distinct for i < 3700.
+//
+inline jag::pdf::GraphicsStateDictionary gs_dict(int i)
+{
+    jag::pdf::GraphicsStateDictionary result;
+    result.m_alpha_is_shape = i % 2 != 0;
+    result.m_stroking_alpha = (i % 100) / 100.0;
+    result.m_nonstroking_alpha = (i % 37) / 37.0;
+    return result;
+}
+
+
+#endif // INTERNERSAMPLES_JG2114_H__
+/** EOF @file */
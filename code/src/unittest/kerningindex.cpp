@@ -0,0 +1,141 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+#include "testtools.h"
+#include <resources/typeman/kerningindex.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+using namespace jag;
+using namespace jag::resources;
+
+namespace
+{
+  class Face
+  {
+  public:
+      Face(FT_Library library, char const* name)
+          : m_face(0)
+      {
+          std::string path(getenv("JAG_TEST_RESOURCES_DIR"));
+          path += "/fonts/";
+          path += name;
+          BOOST_TEST(!FT_New_Face(library, path.c_str(), 0, &m_face));
+      }
+      ~Face() { FT_Done_Face(m_face); }
+      operator FT_Face() const { return m_face; }
+      FT_Face operator->() const { return m_face; }
+
+  private:
+      FT_Face m_face;
+  };
+
+
+  Int ft_kerning(FT_Face face, UInt left, UInt right)
+  {
+      FT_Vector delta;
+      if (FT_Get_Kerning(face, left, right, FT_KERNING_UNSCALED, &delta))
+          return 0;
+      return static_cast<Int>(delta.x);
+  }
+
+
+  // Compares the index with FreeType for all pairs of the given glyphs,
+  // returns the number of kerned pairs.
+  int check_pairs(FT_Face face, KerningIndex const& index, std::vector<UInt> const& gids)
+  {
+      int kerned = 0;
+      for(size_t i=0; i<gids.size(); ++i)
+      {
+          for(size_t j=0; j<gids.size(); ++j)
+          {
+              const Int expected = ft_kerning(face, gids[i], gids[j]);
+              BOOST_TEST(index.kerning(gids[i], gids[j]) == expected);
+              if (expected)
+                  ++kerned;
+          }
+      }
+      return kerned;
+  }
+
+
+  std::vector<UInt> glyphs(FT_Face face, char const* chars)
+  {
+      std::vector<UInt> result;
+      for(; *chars; ++chars)
+          result.push_back(FT_Get_Char_Index(face, static_cast<Byte>(*chars)));
+
+      // the first and the last gids, and gids out of range
+      result.push_back(0);
+      result.push_back(static_cast<UInt>(face->num_glyphs - 1));
+      result.push_back(static_cast<UInt>(face->num_glyphs));
+      result.push_back(0xfffe);
+      result.push_back(0xffff);
+      return result;
+  }
+
+
+  void test_kern_table(FT_Library library)
+  {
+      Face face(library, "DejaVuSans.ttf");
+      BOOST_TEST(FT_HAS_KERNING(face));
+      KerningIndex index;
+      index.build(face);
+
+      // kerning pairs, pairs the kern table does not list
+      const int kerned = check_pairs(
+          face, index, glyphs(face, "AVWYTLPFKRvwy.,-'\"aeo 0"));
+      BOOST_TEST(kerned > 20);
+      BOOST_TEST(index.kerning(FT_Get_Char_Index(face, 'A'), FT_Get_Char_Index(face, 'V')) < 0);
+
+      // a range of gids, most of them are looked up in the table and miss
+      std::vector<UInt> range;
+      for(UInt gid=0; gid<400; ++gid)
+          range.push_back(gid);
+      check_pairs(face, index, range);
+
+      // building again gives the same index
+      index.build(face);
+      BOOST_TEST(index.kerning(FT_Get_Char_Index(face, 'A'), FT_Get_Char_Index(face, 'V')) < 0);
+  }
+
+
+  void test_no_kern_table(FT_Library library)
+  {
+      // a face without the kern table
+      Face face(library, "DejaVuSansMono.ttf");
+      BOOST_TEST(!FT_HAS_KERNING(face));
+      KerningIndex index;
+      index.build(face);
+      BOOST_TEST(check_pairs(face, index, glyphs(face, "AVWY")) == 0);
+
+      // an index which has not been built
+      KerningIndex empty;
+      BOOST_TEST(empty.kerning(0, 0) == 0);
+      BOOST_TEST(empty.kerning(36, 57) == 0);
+  }
+
+
+  void test()
+  {
+      FT_Library library;
+      BOOST_TEST(!FT_Init_FreeType(&library));
+      test_kern_table(library);
+      test_no_kern_table(library);
+      FT_Done_FreeType(library);
+  }
+} // anonymous namespace
+
+int kerningindex(int, char ** const)
+{
+    int result = guarded_test_run(test);
+    result += boost::report_errors();
+    return result;
+}
+
+
+/** EOF @file */
@@ -18,6 +18,7 @@ namespace
   void test()
   {
       JAG_MUST_THROW(MMapFileStreamOutput("/this/file/cerainly/does/not/exist"), jag::exception);
+      JAG_MUST_THROW(MMapFileStreamInput("/this/file/cerainly/does/not/exist"), jag::exception);
 
       char const* tmpname = tmpnam(0);
 
@@ -61,6 +62,21 @@ namespace
 
           BOOST_TEST(infile.tell() == 15390*13);
           BOOST_TEST(!memcmp(md5out.sum(), md5in.sum(), sizeof(MD5Hash::Sum)));
+          infile.close();
+
+          // read the file through a read-only mapping
+          MMapFileStreamInput mapped(tmpname);
+          BOOST_TEST(mapped.size() == 15390*13);
+          BOOST_TEST(!memcmp(mapped.data(), "nazdar!bazar!", 13));
+          mapped.seek(7, OFFSET_FROM_BEGINNING);
+          BOOST_TEST(mapped.read(buffer, 6, &nr_read) && nr_read == 6);
+          BOOST_TEST(!memcmp(buffer, "bazar!", 6));
+          BOOST_TEST(mapped.tell() == 13);
+
+          MD5Hash md5mapped;
+          md5mapped.append(mapped.data(), static_cast<md5_word_t>(mapped.size()));
+          md5mapped.finish();
+          BOOST_TEST(!memcmp(md5out.sum(), md5mapped.sum(), sizeof(MD5Hash::Sum)));
       }
       catch(...)
       {
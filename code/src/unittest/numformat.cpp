@@ -0,0 +1,77 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+#include "testtools.h"
+#include <core/jstd/conversions.h>
+#include <core/jstd/crt.h>
+#include "numformatsamples.h"
+#include <boost/integer_traits.hpp>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <vector>
+
+using namespace jag;
+using namespace jag::jstd;
+
+namespace
+{
+  bool same_double(double value)
+  {
+      Char expected[PDF_DOUBLE_MAX_SIZE];
+      Char actual[PDF_DOUBLE_MAX_SIZE];
+      int expected_len = snprintf_pdf_double(expected, PDF_DOUBLE_MAX_SIZE, value);
+      int actual_len = format_pdf_double(actual, value);
+      bool ok = expected_len == actual_len && !memcmp(expected, actual, actual_len);
+      if (!ok)
+          printf("%.17g: expected '%s', got '%.*s'\n", value, expected, actual_len, actual);
+
+      return ok;
+  }
+
+  bool same_int(Int value)
+  {
+      Char expected[FORMAT_INT_MAX_SIZE];
+      Char actual[FORMAT_INT_MAX_SIZE];
+      int expected_len = jstd::snprintf(expected, FORMAT_INT_MAX_SIZE, "%d", value);
+      int actual_len = format_int(actual, value);
+      return expected_len == actual_len && !memcmp(expected, actual, actual_len);
+  }
+
+  void test()
+  {
+      double const edge[] = {
+          0.0, -0.0, 1.0, -1.0, 0.5, 0.000004, 0.000005, -0.000005,
+          0.000015, 1.000005, 2.675, 0.1, 0.7, 1e-7, 123456.789012,
+          -32767.999996, 612.0, 792.0, 999999999.99999, -999999999.99999,
+          1e9, 1e12, -1e15
+      };
+      for(size_t i=0; i<sizeof(edge)/sizeof(edge[0]); ++i)
+          BOOST_TEST(same_double(edge[i]));
+
+      std::vector<double> values(sample_values(100000));
+      int mismatches = 0;
+      for(size_t i=0; i<values.size(); ++i)
+          if (!same_double(values[i]))
+              ++mismatches;
+      BOOST_TEST(!mismatches);
+
+      Int const ints[] = { 0, 1, -1, 9, 10, -10, 65535, 2147483647,
+                           boost::integer_traits<Int>::const_min };
+      for(size_t i=0; i<sizeof(ints)/sizeof(ints[0]); ++i)
+          BOOST_TEST(same_int(ints[i]));
+  }
+} // anonymous namespace
+
+int numformat(int, char ** const)
+{
+    int result = guarded_test_run(test);
+    result += boost::report_errors();
+    return result;
+}
+
+
+/** EOF @file */
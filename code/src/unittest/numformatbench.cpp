@@ -0,0 +1,71 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+//
+// Compares formatting of doubles by the C runtime and by
+// format_pdf_double().
+//
+//   numformatbench [num_values]
+//
+
+#include <core/jstd/conversions.h>
+#include <core/jstd/crt.h>
+#include <core/errlib/except.h>
+#include "numformatsamples.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <vector>
+#include <iostream>
+
+using namespace jag;
+using namespace jag::jstd;
+
+namespace
+{
+  void benchmark(std::vector<double> const& values)
+  {
+      Char buffer[PDF_DOUBLE_MAX_SIZE];
+      int checksum = 0;
+
+      clock_t start = clock();
+      for(size_t i=0; i<values.size(); ++i)
+          checksum += snprintf_pdf_double(buffer, PDF_DOUBLE_MAX_SIZE, values[i]);
+      clock_t crt_time = clock() - start;
+
+      start = clock();
+      for(size_t i=0; i<values.size(); ++i)
+          checksum -= format_pdf_double(buffer, values[i]);
+      clock_t fast_time = clock() - start;
+
+      if (checksum)
+          fprintf(stderr, "checksum mismatch\n");
+
+      printf("%d doubles: snprintf_pdf_double %.0f ms, format_pdf_double %.0f ms\n",
+             static_cast<int>(values.size()),
+             crt_time * 1000.0 / CLOCKS_PER_SEC,
+             fast_time * 1000.0 / CLOCKS_PER_SEC);
+  }
+} // anonymous namespace
+
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        const int num = argc > 1 ? atoi(argv[1]) : 1000000;
+        benchmark(sample_values(num));
+    }
+    catch(jag::exception const& exc)
+    {
+        jag::output_exception(exc, std::cerr);
+        return 1;
+    }
+
+    return 0;
+}
+
+/** EOF @file */
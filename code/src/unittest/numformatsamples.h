@@ -0,0 +1,30 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+#ifndef NUMFORMATSAMPLES_JG2148_H__
+#define NUMFORMATSAMPLES_JG2148_H__
+#include <stdlib.h>
+#include <vector>
+
+//
+// Values formatted by the number formatting test and benchmark, coordinates
+// as they typically appear in content streams. The sequence is reproducible.
+//
+inline std::vector<double> sample_values(int count)
+{
+    std::vector<double> values(count);
+    srand(1);
+    for(int i=0; i<count; ++i)
+    {
+        double v = (rand() - RAND_MAX / 2) / 37.0;
+        values[i] = (i % 4) ? v : v / 1e5;
+    }
+    return values;
+}
+
+
+#endif // NUMFORMATSAMPLES_JG2148_H__
+/** EOF @file */
@@ -0,0 +1,102 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+#include "testtools.h"
+#include <core/jstd/zlib_stream.h>
+#include <core/jstd/memory_stream.h>
+#include <core/jstd/threadpool.h>
+#include <boost/ptr_container/ptr_vector.hpp>
+#include <string.h>
+#include <stdio.h>
+
+using namespace jag;
+using namespace jag::jstd;
+
+namespace
+{
+  // writes the same pseudo-random content through the given filter
+  void fill(ISeqStreamOutputControl& out, int seed)
+  {
+      char buffer[512];
+      for(int i=0; i<2000; ++i)
+      {
+          int len = sprintf(buffer, "%d %d m %d.%d l ", i*seed, i%97, seed, i);
+          out.write(buffer, len);
+          if (!(i%300))
+          {
+              memset(buffer, i, sizeof(buffer));
+              out.write(buffer, sizeof(buffer));
+          }
+      }
+  }
+
+  void test()
+  {
+      const int num_streams = 8;
+      ThreadPool pool(3);
+
+      // reference
+      boost::ptr_vector<MemoryStreamOutput> expected;
+      for(int i=0; i<num_streams; ++i)
+      {
+          expected.push_back(new MemoryStreamOutput);
+          ZLibStreamOutput zlib(expected.back());
+          fill(zlib, i+1);
+          zlib.close();
+      }
+
+      // compress all streams concurrently
+      boost::ptr_vector<MemoryStreamOutput> out;
+      boost::ptr_vector<PooledZLibStreamOutput> pooled;
+      for(int i=0; i<num_streams; ++i)
+      {
+          out.push_back(new MemoryStreamOutput);
+          pooled.push_back(new PooledZLibStreamOutput(out.back(), pool));
+      }
+      for(int i=0; i<num_streams; ++i)
+          fill(pooled[i], i+1);
+
+      for(int i=0; i<num_streams; ++i)
+      {
+          pooled[i].close();
+          BOOST_TEST(pooled[i].tell() > out[i].tell());
+          BOOST_TEST(out[i].tell() == expected[i].tell());
+          BOOST_TEST(!memcmp(out[i].data(), expected[i].data(), out[i].tell()));
+      }
+
+      // deflate parameters are honoured
+      const DeflateParams params(9, DEFLATE_FILTERED);
+      MemoryStreamOutput expected_params;
+      ZLibStreamOutput zlib_params(expected_params, params);
+      fill(zlib_params, 7);
+      zlib_params.close();
+
+      MemoryStreamOutput out_params;
+      PooledZLibStreamOutput pooled_params(out_params, pool, params);
+      fill(pooled_params, 7);
+      pooled_params.close();
+      BOOST_TEST(out_params.tell() == expected_params.tell());
+      BOOST_TEST(!memcmp(out_params.data(), expected_params.data(), out_params.tell()));
+      BOOST_TEST(out_params.tell() != expected[6].tell()
+                 || memcmp(out_params.data(), expected[6].data(), out_params.tell()));
+
+      // empty stream produces no data
+      MemoryStreamOutput empty;
+      PooledZLibStreamOutput empty_zlib(empty, pool);
+      empty_zlib.close();
+      BOOST_TEST(!empty.tell());
+  }
+} // anonymous namespace
+
+int pooledzlib(int, char ** const)
+{
+    int result = guarded_test_run(test);
+    result += boost::report_errors();
+    return result;
+}
+
+
+/** EOF @file */
@@ -0,0 +1,109 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+#include "testtools.h"
+#include <core/jstd/streampool.h>
+#include <core/jstd/zlib_stream.h>
+#include <core/jstd/memory_stream.h>
+#include <string>
+#include <string.h>
+#include <stdio.h>
+
+using namespace jag;
+using namespace jag::jstd;
+
+namespace
+{
+  std::string contents(SegmentedStreamOutput const& stream)
+  {
+      std::string result;
+      for(int i=0; i<stream.num_segments(); ++i)
+          result.append(reinterpret_cast<char const*>(stream.segment(i)),
+                        static_cast<size_t>(stream.segment_length(i)));
+      return result;
+  }
+
+  std::string deflated(ZLibStreamOutput& zlib, MemoryStreamOutput& out, int seed)
+  {
+      char buffer[64];
+      for(int i=0; i<5000; ++i)
+      {
+          int len = sprintf(buffer, "%d %d l ", i*seed, i%13);
+          zlib.write(buffer, len);
+      }
+      zlib.close();
+      return std::string(reinterpret_cast<char const*>(out.data()),
+                         static_cast<size_t>(out.tell()));
+  }
+
+  void test()
+  {
+      boost::shared_ptr<StreamPool> pool(new StreamPool);
+
+      // data spanning several segments are kept in order
+      std::string expected;
+      {
+          SegmentedStreamOutput stream(pool);
+          char buffer[1000];
+          for(int i=0; i<300; ++i)
+          {
+              memset(buffer, i, sizeof(buffer));
+              stream.write(buffer, i % sizeof(buffer));
+              expected.append(buffer, i % sizeof(buffer));
+          }
+          BOOST_TEST(stream.tell() == expected.size());
+          BOOST_TEST(stream.num_segments() > 1);
+          BOOST_TEST(contents(stream) == expected);
+      }
+      const StreamPoolStats first(pool->stats());
+      BOOST_TEST(!first.segments_reused);
+
+      // the released segments are reused
+      {
+          SegmentedStreamOutput stream(pool);
+          stream.write(expected.data(), expected.size());
+          BOOST_TEST(contents(stream) == expected);
+          stream.close();
+          BOOST_TEST(!stream.tell() && !stream.num_segments());
+      }
+      const StreamPoolStats second(pool->stats());
+      BOOST_TEST(second.segments_allocated == first.segments_allocated);
+      BOOST_TEST(second.segments_reused == first.segments_allocated);
+
+      // a recycled deflater produces the same data as a new one
+      const DeflateParams params(9, DEFLATE_FILTERED);
+      MemoryStreamOutput ref_out;
+      ZLibStreamOutput ref(ref_out, params);
+      const std::string ref_data(deflated(ref, ref_out, 3));
+
+      MemoryStreamOutput out1;
+      std::auto_ptr<ISeqStreamOutputControl> zlib(pool->create_deflate(out1, params));
+      deflated(static_cast<ZLibStreamOutput&>(*zlib), out1, 5);
+      pool->recycle_deflate(zlib);
+
+      MemoryStreamOutput out2;
+      zlib = pool->create_deflate(out2, params);
+      BOOST_TEST(deflated(static_cast<ZLibStreamOutput&>(*zlib), out2, 3) == ref_data);
+      BOOST_TEST(pool->stats().deflaters_created == 1);
+      BOOST_TEST(pool->stats().deflaters_reused == 1);
+
+      // different parameters need a new deflater
+      pool->recycle_deflate(zlib);
+      MemoryStreamOutput out3;
+      zlib = pool->create_deflate(out3, DeflateParams(1));
+      BOOST_TEST(pool->stats().deflaters_created == 2);
+  }
+} // anonymous namespace
+
+int streampool(int, char ** const)
+{
+    int result = guarded_test_run(test);
+    result += boost::report_errors();
+    return result;
+}
+
+
+/** EOF @file */
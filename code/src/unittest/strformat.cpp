@@ -0,0 +1,81 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+#include "testtools.h"
+#include "strformatref.h"
+#include <string.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+using namespace jag;
+using namespace jag::jstd;
+
+namespace
+{
+  bool same_hex(Byte const* data, size_t length)
+  {
+      std::vector<Char> buffer(2 * length + 1);
+      Char* end = format_hex(&buffer[0], data, length);
+      return std::string(&buffer[0], end) == crt_hex(data, length);
+  }
+
+  bool same_hex(UInt16 const* data, size_t length)
+  {
+      std::vector<Char> buffer(4 * length + 1);
+      Char* end = format_hex(&buffer[0], data, length);
+      return std::string(&buffer[0], end) == crt_hex(data, length);
+  }
+
+  void test()
+  {
+      Byte all_bytes[256];
+      UInt16 all_words[256];
+      for(int i=0; i<256; ++i)
+      {
+          all_bytes[i] = static_cast<Byte>(i);
+          all_words[i] = static_cast<UInt16>(i * 257 ^ 0x5a00);
+      }
+      BOOST_TEST(same_hex(all_bytes, 256));
+      BOOST_TEST(same_hex(all_words, 256));
+      BOOST_TEST(escape(all_bytes, 256) == plain_escape(all_bytes, 256));
+
+      // various lengths and alignments of random data, some of them without
+      // any character needing escape
+      srand(1);
+      std::vector<Byte> data(64);
+      int mismatches = 0;
+      for(int i=0; i<20000; ++i)
+      {
+          const int limit = (i % 3) ? 256 : 0x7f;
+          for(size_t j=0; j<data.size(); ++j)
+          {
+              data[j] = static_cast<Byte>(rand() % limit);
+              if (!(i % 3) && literal_string_escape(data[j]))
+                  data[j] = 'x';
+          }
+
+          const size_t offset = i % 8;
+          const size_t length = i % (data.size() - offset);
+          if (!same_hex(&data[offset], length))
+              ++mismatches;
+
+          if (escape(&data[offset], length) != plain_escape(&data[offset], length))
+              ++mismatches;
+      }
+      BOOST_TEST(!mismatches);
+  }
+} // anonymous namespace
+
+int strformat(int, char ** const)
+{
+    int result = guarded_test_run(test);
+    result += boost::report_errors();
+    return result;
+}
+
+
+/** EOF @file */
@@ -0,0 +1,98 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+//
+// Compares hex formatting of glyph indices and escaping of literal strings
+// with the C runtime and byte by byte implementations.
+//
+//   strformatbench
+//
+
+#include "strformatref.h"
+#include <core/errlib/except.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include <iostream>
+
+using namespace jag;
+using namespace jag::jstd;
+
+namespace
+{
+  // text with an occasional character needing escape
+  std::vector<Byte> sample_text(size_t length)
+  {
+      char const* words[] = { "Lorem ipsum dolor sit amet, ",
+                              "consectetur adipiscing elit, ",
+                              "sed do (eiusmod) tempor\n" };
+      std::string text;
+      for(int i=0; text.size() < length; ++i)
+          text += words[i % 3];
+      return std::vector<Byte>(text.begin(), text.begin() + length);
+  }
+
+  void benchmark()
+  {
+      std::vector<UInt16> gids(1000000);
+      for(size_t i=0; i<gids.size(); ++i)
+          gids[i] = static_cast<UInt16>(rand());
+
+      std::vector<Char> buffer(4 * gids.size());
+      clock_t start = clock();
+      size_t checksum = crt_hex(&gids[0], gids.size()).size();
+      clock_t crt_time = clock() - start;
+
+      start = clock();
+      checksum -= format_hex(&buffer[0], &gids[0], gids.size()) - &buffer[0];
+      clock_t fast_time = clock() - start;
+
+      if (checksum)
+          fprintf(stderr, "checksum mismatch\n");
+
+      printf("%d gids: snprintf %.0f ms, format_hex %.0f ms\n",
+             static_cast<int>(gids.size()),
+             crt_time * 1000.0 / CLOCKS_PER_SEC,
+             fast_time * 1000.0 / CLOCKS_PER_SEC);
+
+      std::vector<Byte> text(sample_text(10000000));
+      start = clock();
+      checksum = plain_escape(&text[0], text.size()).size();
+      crt_time = clock() - start;
+
+      start = clock();
+      checksum -= escape(&text[0], text.size()).size();
+      fast_time = clock() - start;
+
+      if (checksum)
+          fprintf(stderr, "checksum mismatch\n");
+
+      printf("%d text bytes: per byte %.0f ms, literal_string_run %.0f ms\n",
+             static_cast<int>(text.size()),
+             crt_time * 1000.0 / CLOCKS_PER_SEC,
+             fast_time * 1000.0 / CLOCKS_PER_SEC);
+  }
+} // anonymous namespace
+
+
+int main()
+{
+    try
+    {
+        benchmark();
+    }
+    catch(jag::exception const& exc)
+    {
+        jag::output_exception(exc, std::cerr);
+        return 1;
+    }
+
+    return 0;
+}
+
+/** EOF @file */
@@ -0,0 +1,86 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+#ifndef STRFORMATREF_JG2131_H__
+#define STRFORMATREF_JG2131_H__
+#include <core/jstd/conversions.h>
+#include <core/jstd/crt.h>
+#include <string>
+
+//
+// Reference implementations of hex formatting and literal string escaping,
+// shared by the string formatting test and benchmark.
+//
+
+// hex encoding by means of the C runtime
+inline std::string crt_hex(jag::Byte const* data, size_t length)
+{
+    std::string result;
+    jag::Char buffer[8];
+    for(size_t i=0; i<length; ++i)
+    {
+        jag::jstd::snprintf(buffer, 8, "%02x", static_cast<unsigned>(data[i]));
+        result.append(buffer, 2);
+    }
+    return result;
+}
+
+inline std::string crt_hex(jag::UInt16 const* data, size_t length)
+{
+    std::string result;
+    jag::Char buffer[8];
+    for(size_t i=0; i<length; ++i)
+    {
+        jag::jstd::snprintf(buffer, 8, "%04x", static_cast<unsigned>(data[i]));
+        result.append(buffer, 4);
+    }
+    return result;
+}
+
+// literal string escaping byte by byte
+inline std::string plain_escape(jag::Byte const* data, size_t length)
+{
+    std::string result;
+    for(size_t i=0; i<length; ++i)
+    {
+        switch(data[i])
+        {
+        case '\b': result += "\\b"; break;
+        case '\t': result += "\\t"; break;
+        case '\n': result += "\\n"; break;
+        case '\f': result += "\\f"; break;
+        case '\r': result += "\\r"; break;
+        case '(':  result += "\\("; break;
+        case ')':  result += "\\)"; break;
+        case '\\': result += "\\\\"; break;
+        default:   result += static_cast<jag::Char>(data[i]);
+        }
+    }
+    return result;
+}
+
+// literal string escaping by literal_string_run()
+inline std::string escape(jag::Byte const* data, size_t length)
+{
+    std::string result;
+    while(length)
+    {
+        size_t run = jag::jstd::literal_string_run(data, length);
+        result.append(reinterpret_cast<jag::Char const*>(data), run);
+        if (run == length)
+            break;
+
+        result += '\\';
+        result += jag::jstd::literal_string_escape(data[run]);
+        data += run + 1;
+        length -= run + 1;
+    }
+    return result;
+}
+
+
+#endif // STRFORMATREF_JG2131_H__
+/** EOF @file */
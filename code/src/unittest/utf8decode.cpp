@@ -0,0 +1,80 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+#include "testtools.h"
+#include <core/generic/scopeguard.h>
+#include "utf8decoderef.h"
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+using namespace jag;
+using namespace jag::jstd;
+
+namespace
+{
+  void test()
+  {
+      UErrorCode err = U_ZERO_ERROR;
+      UConverter* icu_cnv = ucnv_open("utf-8", &err);
+      ON_BLOCK_EXIT(ucnv_close, icu_cnv);
+      UnicodeConverter cnv("utf-8");
+
+      // all scalar values at the boundaries of the sequence lengths
+      UInt const boundaries[] = { 0, 0x7f, 0x80, 0x7ff, 0x800, 0xd7ff, 0xe000,
+                                  0xfffd, 0xffff, 0x10000, 0x10ffff };
+      std::string text;
+      for(size_t i=0; i<sizeof(boundaries)/sizeof(boundaries[0]); ++i)
+          text += utf8(boundaries[i]);
+      BOOST_TEST(code_points(cnv, text) == icu_code_points(icu_cnv, text));
+
+      // ill-formed sequences are left to ICU
+      char const* ill_formed[] = {
+          "\x80", "\xc0\xaf", "\xc1\xbf", "\xe0\x80\xaf", "\xed\xa0\x80",
+          "\xf4\x90\x80\x80", "\xf5\x80\x80\x80", "\xff", "abc\xe4\xb8",
+          "\xe4\xb8" "abcdefghij"
+      };
+      for(size_t i=0; i<sizeof(ill_formed)/sizeof(ill_formed[0]); ++i)
+      {
+          text = ill_formed[i];
+          BOOST_TEST(code_points(cnv, text) == icu_code_points(icu_cnv, text));
+      }
+
+      // random text, valid and damaged
+      srand(1);
+      int mismatches = 0;
+      for(int i=0; i<20000; ++i)
+      {
+          text.resize(0);
+          while(text.size() < 40)
+          {
+              switch(rand() % 4)
+              {
+              case 0:  text += static_cast<Char>(rand() % 0x80); break;
+              case 1:  text += utf8(0x80 + rand() % 0x780); break;
+              case 2:  text += utf8(0xe000 + rand() % 0x2000); break;
+              default: text += utf8(0x10000 + rand() % 0x100000); break;
+              }
+          }
+          if (i % 2)
+              text[rand() % text.size()] = static_cast<Char>(rand());
+
+          if (code_points(cnv, text) != icu_code_points(icu_cnv, text))
+              ++mismatches;
+      }
+      BOOST_TEST(!mismatches);
+  }
+} // anonymous namespace
+
+int utf8decode(int, char ** const)
+{
+    int result = guarded_test_run(test);
+    result += boost::report_errors();
+    return result;
+}
+
+
+/** EOF @file */
@@ -0,0 +1,85 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+//
+// Compares decoding of UTF-8 text to code points by ICU and by
+// UnicodeConverter.
+//
+//   utf8decodebench
+//
+
+#include <core/generic/scopeguard.h>
+#include "utf8decoderef.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include <iostream>
+
+using namespace jag;
+using namespace jag::jstd;
+
+namespace
+{
+  // mostly CJK text with ASCII runs
+  std::string sample_text(size_t length)
+  {
+      std::string text;
+      srand(1);
+      while(text.size() < length)
+      {
+          if (rand() % 4)
+              text += utf8(0x4e00 + rand() % 0x5000);
+          else
+              text += "Lorem ipsum dolor sit amet ";
+      }
+      return text;
+  }
+
+  void benchmark(UConverter* icu_cnv, UnicodeConverter& cnv)
+  {
+      std::string text(sample_text(10000000));
+
+      clock_t start = clock();
+      size_t checksum = icu_code_points(icu_cnv, text).size();
+      clock_t icu_time = clock() - start;
+
+      start = clock();
+      checksum -= code_points(cnv, text).size();
+      clock_t fast_time = clock() - start;
+
+      if (checksum)
+          fprintf(stderr, "checksum mismatch\n");
+
+      printf("%d UTF-8 bytes: ucnv_getNextUChar %.0f ms, code_points %.0f ms\n",
+             static_cast<int>(text.size()),
+             icu_time * 1000.0 / CLOCKS_PER_SEC,
+             fast_time * 1000.0 / CLOCKS_PER_SEC);
+  }
+} // anonymous namespace
+
+
+int main()
+{
+    try
+    {
+        UErrorCode err = U_ZERO_ERROR;
+        UConverter* icu_cnv = ucnv_open("utf-8", &err);
+        ON_BLOCK_EXIT(ucnv_close, icu_cnv);
+        UnicodeConverter cnv("utf-8");
+        benchmark(icu_cnv, cnv);
+    }
+    catch(jag::exception const& exc)
+    {
+        jag::output_exception(exc, std::cerr);
+        return 1;
+    }
+
+    return 0;
+}
+
+/** EOF @file */
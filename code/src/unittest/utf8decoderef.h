@@ -0,0 +1,89 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+#ifndef UTF8DECODEREF_JG2140_H__
+#define UTF8DECODEREF_JG2140_H__
+#include <core/jstd/unicode.h>
+#include <core/errlib/except.h>
+#include <unicode/ucnv.h>
+#include <string>
+#include <vector>
+
+//
+// Decoding of UTF-8 text by ICU and by UnicodeConverter, shared by the UTF-8
+// decoding test and benchmark. A decoding error is reported as -1 following
+// the code points decoded so far.
+//
+
+// decodes the text by means of ICU only
+inline std::vector<jag::Int> icu_code_points(UConverter* cnv, std::string const& text)
+{
+    std::vector<jag::Int> result;
+    jag::Char const* curr = text.data();
+    jag::Char const*const end = curr + text.size();
+    ucnv_reset(cnv);
+    while(curr != end)
+    {
+        UErrorCode err = U_ZERO_ERROR;
+        const jag::Int code_point = ucnv_getNextUChar(cnv, &curr, end, &err);
+        if (U_FAILURE(err))
+        {
+            // UnicodeConverter throws
+            result.push_back(-1);
+            break;
+        }
+        result.push_back(code_point);
+    }
+    return result;
+}
+
+inline std::vector<jag::Int> code_points(jag::jstd::UnicodeConverter& cnv, std::string const& text)
+{
+    std::vector<jag::Int> result;
+    cnv.reset();
+    try
+    {
+        cnv.code_points(text.data(), text.data() + text.size(), result);
+    }
+    catch(jag::exception const&)
+    {
+        result.push_back(-1);
+    }
+    return result;
+}
+
+// encodes a code point to UTF-8
+inline std::string utf8(jag::UInt cp)
+{
+    std::string result;
+    if (cp < 0x80)
+    {
+        result += static_cast<jag::Char>(cp);
+    }
+    else if (cp < 0x800)
+    {
+        result += static_cast<jag::Char>(0xc0 | (cp >> 6));
+        result += static_cast<jag::Char>(0x80 | (cp & 0x3f));
+    }
+    else if (cp < 0x10000)
+    {
+        result += static_cast<jag::Char>(0xe0 | (cp >> 12));
+        result += static_cast<jag::Char>(0x80 | ((cp >> 6) & 0x3f));
+        result += static_cast<jag::Char>(0x80 | (cp & 0x3f));
+    }
+    else
+    {
+        result += static_cast<jag::Char>(0xf0 | (cp >> 18));
+        result += static_cast<jag::Char>(0x80 | ((cp >> 12) & 0x3f));
+        result += static_cast<jag::Char>(0x80 | ((cp >> 6) & 0x3f));
+        result += static_cast<jag::Char>(0x80 | (cp & 0x3f));
+    }
+    return result;
+}
+
+
+#endif // UTF8DECODEREF_JG2140_H__
+/** EOF @file */
@@ -9,10 +9,38 @@
 #include "ctestcommon.h"
 
 
+static void JAG_CALLSPEC count_release(void* custom, void const* data)
+{
+    JAG_IGNORE_UNUSED(data);
+    ++*(int*)custom;
+}
+
+
+static jag_Int JAG_CALLSPEC empty_read(void* custom, void* data, jag_ULong size, jag_ULong* read)
+{
+    JAG_IGNORE_UNUSED(custom);
+    JAG_IGNORE_UNUSED(data);
+    JAG_IGNORE_UNUSED(size);
+    *read = 0;
+    return 0;
+}
+
+
+static void JAG_CALLSPEC count_close(void* custom)
+{
+    ++*(int*)custom;
+}
+
+
 int errhandling(int argc, char ** const argv)
 {
     jag_Document doc;
     jag_Profile cfg;
+    jag_datarelease release;
+    jag_Byte pixels[3] = { 0, 0, 0 };
+    int num_released = 0;
+    jag_streamin source;
+    int num_closed = 0;
 
     jag_streamout stream_out = get_noop_stream();
 
@@ -41,6 +69,27 @@ int errhandling(int argc, char ** const argv)
         JAGC_FAIL;
     }
 
+    /* borrowed data are released even if the call fails */
+    release.release = count_release;
+    release.custom_data = &num_released;
+    if (jag_ImageDef_data_borrowed(0, pixels, 3, &release)) {
+        /* OK - really failed */
+    } else {
+        JAGC_FAIL;
+    }
+    JAGC_TEST(num_released == 1);
+
+    /* a source is closed even if the call fails */
+    source.read = empty_read;
+    source.close = count_close;
+    source.custom_data = &num_closed;
+    if (jag_ImageDef_data_source(0, &source)) {
+        /* OK - really failed */
+    } else {
+        JAGC_FAIL;
+    }
+    JAGC_TEST(num_closed == 1);
+
     jag_release(doc);
     jag_release(cfg);
 
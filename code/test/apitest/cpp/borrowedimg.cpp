@@ -0,0 +1,174 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <stdlib.h>
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <pthread.h>
+#endif
+
+#include "testcommon.h"
+using namespace jag;
+
+// tests that image data passed by data_borrowed() are released exactly once
+
+namespace
+{
+#ifdef _WIN32
+  typedef DWORD thread_id_t;
+  thread_id_t current_thread() { return GetCurrentThreadId(); }
+  bool same_thread(thread_id_t a, thread_id_t b) { return a == b; }
+#else
+  typedef pthread_t thread_id_t;
+  thread_id_t current_thread() { return pthread_self(); }
+  bool same_thread(thread_id_t a, thread_id_t b) { return pthread_equal(a, b) != 0; }
+#endif
+
+
+  class CountRelease
+      : public pdf::DataRelease
+  {
+  public:
+      CountRelease()
+          : m_count(0), m_data(0), m_thread(current_thread()), m_same_thread(false)
+      {}
+      int count() const { return m_count; }
+      void const* data() const { return m_data; }
+      // whether the data were released on the thread that created this object
+      bool same_thread() const { return m_same_thread; }
+
+  protected:
+      void release(void const* data) {
+          ++m_count;
+          m_data = data;
+          m_same_thread = ::same_thread(m_thread, current_thread());
+      }
+
+  private:
+      int m_count;
+      void const* m_data;
+      thread_id_t m_thread;
+      bool m_same_thread;
+  };
+
+
+  std::vector<pdf::Byte> read_file(char const* name)
+  {
+      std::ostringstream path;
+      path << getenv("JAG_TEST_RESOURCES_DIR") << "/images/" << name;
+      std::ifstream in(path.str().c_str(), std::ios::binary);
+      return std::vector<pdf::Byte>(std::istreambuf_iterator<char>(in),
+                                    std::istreambuf_iterator<char>());
+  }
+
+
+  void check_release(pdf::Profile const& cfg)
+  {
+      StreamNoop stream;
+      pdf::Document doc(pdf::create_stream(&stream, cfg));
+      doc.page_start(5.9*72, 3.5*72);
+      pdf::Canvas canvas(doc.page().canvas());
+
+      // native image
+      const pdf::UInt width = 64;
+      std::vector<pdf::Byte> pixels(width * width * 3);
+      for(size_t i=0; i<pixels.size(); ++i)
+          pixels[i] = static_cast<pdf::Byte>(i / 3 % width * 4);
+
+      CountRelease native_release;
+      pdf::ImageDef native_def(doc.image_definition());
+      native_def.data_borrowed(&pixels[0], static_cast<pdf::UInt>(pixels.size()), &native_release);
+      native_def.format(pdf::IMAGE_FORMAT_NATIVE);
+      native_def.dimensions(width, width);
+      native_def.color_space(pdf::CS_DEVICE_RGB);
+      native_def.bits_per_component(8);
+      canvas.image(doc.image_load(native_def), 36, 36);
+      BOOST_TEST(native_release.count() == 0);
+
+      // jpeg, the format is detected in the borrowed data
+      std::vector<pdf::Byte> jpeg(read_file("lena.jpg"));
+      BOOST_TEST(!jpeg.empty());
+      CountRelease jpeg_release;
+      pdf::ImageDef jpeg_def(doc.image_definition());
+      jpeg_def.data_borrowed(&jpeg[0], static_cast<pdf::UInt>(jpeg.size()), &jpeg_release);
+      canvas.image(doc.image_load(jpeg_def), 144, 36);
+
+      // replaced data are released immediately
+      CountRelease replaced_release;
+      pdf::ImageDef replaced_def(doc.image_definition());
+      replaced_def.data_borrowed(&pixels[0], 3, &replaced_release);
+      replaced_def.data(&pixels[0], 3);
+      BOOST_TEST(replaced_release.count() == 1);
+      BOOST_TEST(replaced_release.data() == &pixels[0]);
+
+      // loaded but never placed, and defined but never loaded
+      CountRelease unused_release;
+      pdf::ImageDef unused_def(doc.image_definition());
+      unused_def.data_borrowed(&jpeg[0], static_cast<pdf::UInt>(jpeg.size()), &unused_release);
+      doc.image_load(unused_def);
+      CountRelease unused_native_release;
+      pdf::ImageDef unused_native_def(doc.image_definition());
+      unused_native_def.data_borrowed(&pixels[0], static_cast<pdf::UInt>(pixels.size()), &unused_native_release);
+      unused_native_def.format(pdf::IMAGE_FORMAT_NATIVE);
+      unused_native_def.dimensions(width, width);
+      unused_native_def.color_space(pdf::CS_DEVICE_RGB);
+      unused_native_def.bits_per_component(8);
+      doc.image_load(unused_native_def);
+      CountRelease unloaded_release;
+      pdf::ImageDef unloaded_def(doc.image_definition());
+      unloaded_def.data_borrowed(&pixels[0], static_cast<pdf::UInt>(pixels.size()), &unloaded_release);
+
+      // released even if the call fails
+      CountRelease failed_release;
+      pdf::ImageDef failed_def(doc.image_definition());
+      JAG_MUST_THROW(failed_def.data_borrowed(0, 3, &failed_release));
+      BOOST_TEST(failed_release.count() == 1);
+
+      doc.page_end();
+      BOOST_TEST(unused_release.count() == 0);
+      BOOST_TEST(unused_native_release.count() == 0);
+      BOOST_TEST(unloaded_release.count() == 0);
+      doc.finalize();
+
+      // released when the document is finalized, not when it is destroyed
+      BOOST_TEST(unused_release.count() == 1);
+      BOOST_TEST(unused_native_release.count() == 1);
+      BOOST_TEST(unloaded_release.count() == 1);
+      BOOST_TEST(unloaded_release.data() == &pixels[0]);
+
+      BOOST_TEST(native_release.count() == 1);
+      BOOST_TEST(native_release.data() == &pixels[0]);
+      BOOST_TEST(native_release.same_thread());
+      BOOST_TEST(jpeg_release.count() == 1);
+      BOOST_TEST(jpeg_release.same_thread());
+  }
+
+
+  void test_main(int /*argc*/, char** /*argv*/)
+  {
+      check_release(pdf::Profile());
+
+      // borrowed images are not prepared on the image threads, so the data
+      // are released on this thread
+      pdf::Profile cfg(pdf::create_profile());
+      cfg.set("images.prepare_threads", "2");
+      check_release(cfg);
+  }
+} // anonymous namespace
+
+int borrowedimg(int argc, char ** const argv)
+{
+    return test_runner(test_main, argc, argv);
+}
+
+
+
+/** EOF @file */
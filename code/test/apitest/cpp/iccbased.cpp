@@ -0,0 +1,112 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "testcommon.h"
+using namespace jag;
+
+// tests that ICC based color spaces with the same profile share a single
+// ICCBased object
+
+namespace
+{
+  std::string resource_path(char const* name)
+  {
+      return std::string(getenv("JAG_TEST_RESOURCES_DIR")) + "/" + name;
+  }
+
+
+  size_t count(std::string const& str, char const* what)
+  {
+      size_t result = 0;
+      for(size_t pos = str.find(what); pos != std::string::npos; pos = str.find(what, pos + 1))
+          ++result;
+      return result;
+  }
+
+
+  // Registers a few color spaces before the tested ones, so that the handles
+  // of the tested color spaces do not refer to the first table entries.
+  void register_other_color_spaces(pdf::Document& doc)
+  {
+      doc.color_space_load("calgray; white=0.9505, 1.089");
+      doc.color_space_load("cielab; white=0.9505, 1.089");
+      doc.color_space_load("calrgb; white=0.9505, 1.089; gamma=1.8, 1.8, 1.8");
+  }
+
+
+  // Number of components of registered ICC based color spaces is needed when
+  // a color is set and when a native image is written.
+  void use_color_space(pdf::Document& doc, pdf::Canvas& canvas, pdf::ColorSpace cs, int pos)
+  {
+      canvas.color_space("f", cs);
+      canvas.color("f", 0.25, 0.5, 0.75);
+      canvas.rectangle(pos, 100, 10, 10);
+      canvas.path_paint("f");
+
+      const pdf::UInt width = 4;
+      std::vector<pdf::Byte> pixels(width * width * 3, 0x80);
+      pdf::ImageDef spec(doc.image_definition());
+      spec.data(&pixels[0], static_cast<pdf::UInt>(pixels.size()));
+      spec.format(pdf::IMAGE_FORMAT_NATIVE);
+      spec.dimensions(width, width);
+      spec.color_space(cs);
+      spec.bits_per_component(8);
+      canvas.image(doc.image_load(spec), pos, 150);
+  }
+
+
+  void test_main(int /*argc*/, char** /*argv*/)
+  {
+      pdf::Profile cfg(pdf::create_profile());
+      cfg.set("doc.compressed", "0");
+      StreamString stream;
+      pdf::Document doc(pdf::create_stream(&stream, cfg));
+      register_other_color_spaces(doc);
+      doc.page_start(5.9*72, 3.5*72);
+      pdf::Canvas canvas(doc.page().canvas());
+
+      // sRGB by name, by the profile and implied by images
+      const std::string srgb_icm(resource_path("icc/sRGB Color Space Profile.icm"));
+      pdf::ColorSpace srgb = doc.color_space_load("srgb");
+      BOOST_TEST(srgb == doc.color_space_load("srgb"));
+      BOOST_TEST(srgb == doc.color_space_load(("icc; components=3; profile=" + srgb_icm).c_str()));
+      for(int i=0; i<3; ++i)
+      {
+          canvas.image(doc.image_load_file(resource_path("images/cc3399-srgb.png").c_str()), 10 + 20*i, 10);
+          canvas.image(doc.image_load_file(resource_path("images/lena_srgb.jpg").c_str()), 10 + 20*i, 50);
+      }
+      use_color_space(doc, canvas, srgb, 10);
+
+      // Adobe RGB by name and by the profile
+      const std::string adobe_icc(resource_path("icc/AdobeRGB1998.icc"));
+      pdf::ColorSpace adobe_rgb = doc.color_space_load("adobe-rgb");
+      BOOST_TEST(adobe_rgb != srgb);
+      BOOST_TEST(adobe_rgb == doc.color_space_load(("icc; components=3; profile=" + adobe_icc).c_str()));
+      use_color_space(doc, canvas, adobe_rgb, 30);
+
+      doc.page_end();
+      doc.finalize();
+
+      std::string const& pdf = stream.str();
+      BOOST_TEST(count(pdf, "/ICCBased") == 2);
+      BOOST_TEST(count(pdf, "/N 3") == 2);
+      BOOST_TEST(count(pdf, "0.25 0.5 0.75 sc") == 2);
+  }
+} // anonymous namespace
+
+int iccbased(int argc, char ** const argv)
+{
+    return test_runner(test_main, argc, argv);
+}
+
+
+
+/** EOF @file */
@@ -0,0 +1,205 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "testcommon.h"
+using namespace jag;
+
+// tests that native image data are pulled from a source when written
+
+namespace
+{
+  // generates a gradient strip by strip
+  class GradientSource
+      : public pdf::StreamIn
+  {
+  public:
+      GradientSource(pdf::UInt width, pdf::UInt height, pdf::UInt sample_size)
+          : m_strip(width * 3 * sample_size * 16)
+          , m_size(static_cast<pdf::ULong>(width) * height * 3 * sample_size)
+          , m_pos(0)
+          , m_closed(0)
+      {
+          for(size_t i=0; i<m_strip.size(); ++i)
+              m_strip[i] = static_cast<pdf::Byte>(i / sample_size / 3 % width);
+      }
+
+      void resize(pdf::ULong size) { m_size = size; }
+      pdf::ULong pulled() const { return m_pos; }
+      int closed() const { return m_closed; }
+
+  protected:
+      pdf::Int read(void* data, pdf::ULong size, pdf::ULong* read) {
+          pdf::ULong chunk = m_size - m_pos;
+          if (chunk > size)
+              chunk = size;
+
+          // a strip at most
+          pdf::ULong offset = m_pos % m_strip.size();
+          if (chunk > m_strip.size() - offset)
+              chunk = m_strip.size() - offset;
+
+          memcpy(data, &m_strip[offset], chunk);
+          m_pos += chunk;
+          *read = chunk;
+          return 0;
+      }
+
+      void close() {
+          ++m_closed;
+      }
+
+  private:
+      std::vector<pdf::Byte> m_strip;
+      pdf::ULong m_size;
+      pdf::ULong m_pos;
+      int m_closed;
+  };
+
+
+  pdf::Image load_image(pdf::Document& doc, GradientSource& source,
+                        pdf::UInt width, pdf::UInt bpc)
+  {
+      pdf::ImageDef spec(doc.image_definition());
+      spec.data_source(&source);
+      spec.dimensions(width, width);
+      spec.color_space(pdf::CS_DEVICE_RGB);
+      spec.bits_per_component(bpc);
+      return doc.image_load(spec);
+  }
+
+
+  // Checks that the data of a small pulled image are written right to the
+  // document, i.e. that /Length of the image stream is an indirect object.
+  void check_direct_output(pdf::Profile const& cfg)
+  {
+      StreamString stream;
+      pdf::Document doc(pdf::create_stream(&stream, cfg));
+      doc.page_start(5.9*72, 3.5*72);
+      const pdf::UInt width = 16;
+      GradientSource source(width, width, 1);
+      doc.page().canvas().image(load_image(doc, source, width, 8), 36, 36);
+      doc.page_end();
+      doc.finalize();
+
+      std::string const& pdf = stream.str();
+      const size_t image = pdf.find("/Subtype/Image");
+      BOOST_TEST(image != std::string::npos);
+      const size_t dict = pdf.rfind("<<", image);
+      const size_t length_end = pdf.find_first_not_of("0123456789", dict + 10);
+      BOOST_TEST(!pdf.compare(dict, 10, "<</Length "));
+      BOOST_TEST(!pdf.compare(length_end, 4, " 0 R"));
+      BOOST_TEST(source.pulled() == width * width * 3);
+  }
+
+
+  void write_doc(pdf::Document& doc)
+  {
+      doc.page_end();
+      doc.finalize();
+  }
+
+
+  // Checks that exactly the samples (rows padded to whole bytes) are pulled
+  // from a source, i.e. that an endless source is not read to the end and
+  // that a short source is an error.
+  void check_source_size(pdf::UInt width, pdf::UInt bpc, char const* version,
+                         pdf::ULong expected)
+  {
+      pdf::Profile cfg(pdf::create_profile());
+      cfg.set("doc.version", version);
+      {
+          StreamNoop stream;
+          pdf::Document doc(pdf::create_stream(&stream, cfg));
+          doc.page_start(5.9*72, 3.5*72);
+          GradientSource source(width, width, 1);
+          source.resize(~static_cast<pdf::ULong>(0));
+          doc.page().canvas().image(load_image(doc, source, width, bpc), 36, 36);
+          write_doc(doc);
+          BOOST_TEST(source.pulled() == expected);
+          BOOST_TEST(source.closed() == 1);
+      }
+      {
+          StreamNoop stream;
+          pdf::Document doc(pdf::create_stream(&stream, cfg));
+          doc.page_start(5.9*72, 3.5*72);
+          GradientSource source(width, width, 1);
+          source.resize(expected - 1);
+          doc.page().canvas().image(load_image(doc, source, width, bpc), 36, 36);
+          JAG_MUST_THROW(write_doc(doc));
+          BOOST_TEST(source.pulled() == expected - 1);
+      }
+  }
+
+
+  void test_main(int /*argc*/, char** /*argv*/)
+  {
+      check_source_size(64, 8, "5", 64 * 64 * 3);
+      check_source_size(5, 1, "5", 5 * 2);
+      // downsampled
+      check_source_size(64, 16, "4", 64 * 64 * 6);
+
+      // pulled data are not buffered, neither with the default settings nor
+      // when streams are deduplicated
+      check_direct_output(pdf::Profile());
+      pdf::Profile dedup_cfg(pdf::create_profile());
+      dedup_cfg.set("doc.dedup_streams", "1");
+      check_direct_output(dedup_cfg);
+
+      // 16-bit images are downsampled in PDF 1.4
+      pdf::Profile cfg(pdf::create_profile());
+      cfg.set("doc.version", "4");
+
+      StreamNoop stream;
+      pdf::Document doc(pdf::create_stream(&stream, cfg));
+      doc.page_start(5.9*72, 3.5*72);
+      pdf::Canvas canvas(doc.page().canvas());
+
+      const pdf::UInt width = 256;
+      GradientSource source8(width, width, 1);
+      canvas.image(load_image(doc, source8, width, 8), 36, 36);
+
+      GradientSource source16(width, width, 2);
+      canvas.image(load_image(doc, source16, width, 16), 144, 36);
+
+      // the format cannot be recognized in a source
+      GradientSource source_jpeg(width, width, 1);
+      pdf::ImageDef jpeg_spec(doc.image_definition());
+      jpeg_spec.data_source(&source_jpeg);
+      jpeg_spec.format(pdf::IMAGE_FORMAT_JPEG);
+      JAG_MUST_THROW(doc.image_load(jpeg_spec));
+
+      // replaced sources are closed immediately
+      GradientSource replaced(width, width, 1);
+      pdf::ImageDef replaced_spec(doc.image_definition());
+      replaced_spec.data_source(&replaced);
+      replaced_spec.file_name("");
+      BOOST_TEST(replaced.closed() == 1);
+
+      doc.page_end();
+      doc.finalize();
+
+      BOOST_TEST(source8.closed() == 1);
+      BOOST_TEST(source8.pulled() == width * width * 3);
+      BOOST_TEST(source16.closed() == 1);
+      BOOST_TEST(source16.pulled() == width * width * 6);
+      BOOST_TEST(!replaced.pulled());
+      BOOST_TEST(!source_jpeg.pulled());
+  }
+} // anonymous namespace
+
+int imagesource(int argc, char ** const argv)
+{
+    return test_runner(test_main, argc, argv);
+}
+
+
+
+/** EOF @file */
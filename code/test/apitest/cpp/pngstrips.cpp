@@ -0,0 +1,182 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "testcommon.h"
+using namespace jag;
+
+// tests the samples of PNG images decoded by strips of rows (non-interlaced)
+// and as a whole (interlaced)
+
+namespace
+{
+  struct ImageStream
+  {
+      bool has_mask;
+      std::string data;
+  };
+  typedef std::vector<ImageStream> ImageStreams;
+
+
+  size_t read_number(std::string const& pdf, size_t pos)
+  {
+      return strtoul(pdf.c_str() + pos, 0, 10);
+  }
+
+
+  // retrieves the image streams of an uncompressed document
+  ImageStreams image_streams(std::string const& pdf)
+  {
+      ImageStreams result;
+      for(size_t pos = pdf.find("/Subtype/Image"); pos != std::string::npos;
+          pos = pdf.find("/Subtype/Image", pos + 1))
+      {
+          const size_t dict = pdf.rfind("<<", pos);
+          const size_t dict_end = pdf.find(">>stream\n", pos);
+          const size_t length = dict + 10;
+          BOOST_TEST(!pdf.compare(dict, 10, "<</Length "));
+          size_t size = read_number(pdf, length);
+          const size_t length_end = pdf.find_first_not_of("0123456789", length);
+          if (!pdf.compare(length_end, 4, " 0 R"))
+          {
+              std::string obj("\n" + pdf.substr(length, length_end - length) + " 0 obj");
+              size = read_number(pdf, pdf.find(obj) + obj.size());
+          }
+
+          ImageStream stream;
+          stream.has_mask = pdf.substr(dict, dict_end - dict).find("/SMask") != std::string::npos;
+          stream.data = pdf.substr(dict_end + 9, size);
+          result.push_back(stream);
+      }
+      return result;
+  }
+
+
+  ImageStreams load_image(char const* name, char const* version, char const* threads)
+  {
+      pdf::Profile cfg(pdf::create_profile());
+      cfg.set("doc.compressed", "0");
+      cfg.set("doc.version", version);
+      cfg.set("images.prepare_threads", threads);
+      StreamString stream;
+      pdf::Document doc(pdf::create_stream(&stream, cfg));
+      std::string path(getenv("JAG_TEST_RESOURCES_DIR"));
+      path += "/images/";
+      path += name;
+      pdf::Image img(doc.image_load_file(path.c_str()));
+      doc.page_start(5.9*72, 3.5*72);
+      doc.page().canvas().image(img, 36, 36);
+      doc.page_end();
+      doc.finalize();
+      return image_streams(stream.str());
+  }
+
+
+  bool same_streams(ImageStreams const& lhs, ImageStreams const& rhs)
+  {
+      if (lhs.size() != rhs.size())
+          return false;
+
+      for(size_t i=0; i<lhs.size(); ++i)
+      {
+          if (lhs[i].has_mask != rhs[i].has_mask || lhs[i].data != rhs[i].data)
+              return false;
+      }
+      return true;
+  }
+
+
+  // The strips_rgba*.png images are 256x256 RGBA, large enough to be decoded
+  // in several strips. A sample of color component c at column x is c in 8
+  // bit images and (c << 8) | ((c * 37 + x) & 0xff) in 16 bit images.
+  void append_sample(std::string& data, int c, int x, int bpc)
+  {
+      data += static_cast<char>(c);
+      if (bpc == 16)
+          data += static_cast<char>((c * 37 + x) & 0xff);
+  }
+
+  void check_strips_image(char const* name, int bpc, char const* version, char const* threads)
+  {
+      const int width = 256;
+      // 16 bit images are converted to 8 bits in PDF 1.4, soft masks are
+      // always 8 bit
+      const int out_bpc = (bpc == 16 && version[0] == '4') ? 8 : bpc;
+      std::string color, alpha;
+      for(int y=0; y<width; ++y)
+      {
+          for(int x=0; x<width; ++x)
+          {
+              append_sample(color, x, x, out_bpc);
+              append_sample(color, y, x, out_bpc);
+              append_sample(color, (x + 2*y) & 0xff, x, out_bpc);
+              append_sample(alpha, 255 - (x + y) / 2, x, 8);
+          }
+      }
+
+      ImageStreams streams(load_image(name, version, threads));
+      BOOST_TEST(streams.size() == 2);
+      for(size_t i=0; i<streams.size(); ++i)
+          BOOST_TEST(streams[i].data == (streams[i].has_mask ? color : alpha));
+  }
+
+
+  // interlaced and non-interlaced images from the PNG test suite
+  char const* g_suite_images[] = {
+      "0G04", // gray, 4 bits
+      "0G08", // gray
+      "0G16", // gray, 16 bits
+      "2C08", // rgb
+      "2C16", // rgb, 16 bits
+      "3P02", // palette, 2 bits
+      "3P08", // palette
+      "4A08", // gray + alpha
+      "4A16", // gray + alpha, 16 bits
+      "6A08", // rgb + alpha
+      "6A16", // rgb + alpha, 16 bits
+  };
+
+
+  void test_main(int /*argc*/, char** /*argv*/)
+  {
+      char const* versions[] = { "4", "5" };
+      char const* threads[] = { "0", "2" };
+      for(int v=0; v<2; ++v)
+      {
+          for(int t=0; t<2; ++t)
+          {
+              check_strips_image("strips_rgba8.png", 8, versions[v], threads[t]);
+              check_strips_image("strips_rgba8_interlaced.png", 8, versions[v], threads[t]);
+              check_strips_image("strips_rgba16.png", 16, versions[v], threads[t]);
+              check_strips_image("strips_rgba16_interlaced.png", 16, versions[v], threads[t]);
+
+              for(size_t i=0; i<sizeof(g_suite_images)/sizeof(g_suite_images[0]); ++i)
+              {
+                  const std::string suffix(std::string(g_suite_images[i]) + ".png");
+                  ImageStreams strips(load_image(("png_test_suite/BASN" + suffix).c_str(),
+                                                 versions[v], threads[t]));
+                  ImageStreams whole(load_image(("png_test_suite/BASI" + suffix).c_str(),
+                                                versions[v], threads[t]));
+                  BOOST_TEST(!strips.empty());
+                  BOOST_TEST(same_streams(strips, whole));
+              }
+          }
+      }
+  }
+} // anonymous namespace
+
+int pngstrips(int argc, char ** const argv)
+{
+    return test_runner(test_main, argc, argv);
+}
+
+
+
+/** EOF @file */
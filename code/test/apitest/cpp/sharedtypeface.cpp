@@ -0,0 +1,150 @@
+// Copyright (c) 2005-2009 Jaroslav Gresula
+//
+// Distributed under the MIT license (See accompanying file
+// LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+//
+
+
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <pthread.h>
+#endif
+
+#include "testcommon.h"
+using namespace jag;
+
+// tests that a typeface shared by documents produced on different threads
+// gives the same metrics and output as a private one
+
+namespace
+{
+  // kerning pairs, characters outside of ASCII and a character missing in
+  // the font
+  char const* g_texts[] = {
+      "AVAYA Tea, WAVE. Yarmil",
+      "\xc5\xbdlu\xc5\xa5ou\xc4\x8dk\xc3\xbd k\xc5\xaf\xc5\x88 \xe2\x82\xac",
+      "missing \xf0\x9f\x98\x80 glyph",
+  };
+  const int g_num_texts = sizeof(g_texts) / sizeof(g_texts[0]);
+
+
+  struct DocResult
+  {
+      DocResult() : shared(true) {}
+      bool shared;
+      std::vector<double> advances;
+      std::string pdf;
+  };
+
+
+  // replaces the subset tags (e.g. /ABCDEF+DejaVuSans) which are not
+  // reproducible
+  std::string without_subset_tags(std::string pdf)
+  {
+      for(size_t pos = pdf.find('+'); pos != std::string::npos; pos = pdf.find('+', pos + 1))
+      {
+          if (pos >= 7 && pdf[pos - 7] == '/')
+              pdf.replace(pos - 6, 6, "XXXXXX");
+      }
+      return pdf;
+  }
+
+
+  void create_doc(DocResult& result)
+  {
+      pdf::Profile cfg(pdf::create_profile());
+      cfg.set("doc.compressed", "0");
+      cfg.set("doc.static_file_id", "1");
+      cfg.set("info.creation_date", "0");
+      cfg.set("text.kerning", "1");
+      cfg.set("fonts.shared_cache", result.shared ? "1" : "0");
+      StreamString stream;
+      pdf::Document doc(pdf::create_stream(&stream, cfg));
+      doc.page_start(5.9*72, 3.5*72);
+      pdf::Canvas canvas(doc.page().canvas());
+      std::string spec("enc=utf-8; size=12; file=");
+      spec += getenv("JAG_TEST_RESOURCES_DIR");
+      spec += "/fonts/DejaVuSans.ttf";
+      pdf::Font font(doc.font_load(spec.c_str()));
+      canvas.text_font(font);
+      for(int i=0; i<g_num_texts; ++i)
+      {
+          result.advances.push_back(font.advance(g_texts[i]));
+          canvas.text(10, 20 + 20*i, g_texts[i]);
+      }
+      doc.page_end();
+      doc.finalize();
+      result.pdf = without_subset_tags(stream.str());
+  }
+
+
+#ifdef _WIN32
+  DWORD WINAPI create_doc_thread(LPVOID arg)
+  {
+      create_doc(*static_cast<DocResult*>(arg));
+      return 0;
+  }
+#else
+  void* create_doc_thread(void* arg)
+  {
+      create_doc(*static_cast<DocResult*>(arg));
+      return 0;
+  }
+#endif
+
+
+  void create_docs_in_parallel(std::vector<DocResult>& results)
+  {
+#ifdef _WIN32
+      std::vector<HANDLE> threads(results.size());
+      for(size_t i=0; i<results.size(); ++i)
+          threads[i] = CreateThread(0, 0, create_doc_thread, &results[i], 0, 0);
+      for(size_t i=0; i<threads.size(); ++i)
+      {
+          WaitForSingleObject(threads[i], INFINITE);
+          CloseHandle(threads[i]);
+      }
+#else
+      std::vector<pthread_t> threads(results.size());
+      for(size_t i=0; i<results.size(); ++i)
+          pthread_create(&threads[i], 0, create_doc_thread, &results[i]);
+      for(size_t i=0; i<threads.size(); ++i)
+          pthread_join(threads[i], 0);
+#endif
+  }
+
+
+  void test_main(int /*argc*/, char** /*argv*/)
+  {
+      DocResult expected;
+      expected.shared = false;
+      create_doc(expected);
+      BOOST_TEST(expected.advances[0] > 0);
+      // kerning is applied
+      BOOST_TEST(expected.pdf.find("] TJ") != std::string::npos);
+
+      for(int round=0; round<4; ++round)
+      {
+          std::vector<DocResult> results(4);
+          create_docs_in_parallel(results);
+          for(size_t i=0; i<results.size(); ++i)
+          {
+              BOOST_TEST(results[i].advances == expected.advances);
+              BOOST_TEST(results[i].pdf == expected.pdf);
+          }
+      }
+  }
+} // anonymous namespace
+
+int sharedtypeface(int argc, char ** const argv)
+{
+    return test_runner(test_main, argc, argv);
+}
+
+
+
+/** EOF @file */
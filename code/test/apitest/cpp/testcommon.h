@@ -16,6 +16,7 @@
 #include <cassert>
 #include <sstream>
 #include <map>
+#include <string>
 #include <stdexcept>
 
 jag::pdf::Document create_doc(char const* fname, jag::pdf::Profile* cfg=0);
@@ -109,6 +110,28 @@ public:
 
 
 
+//
+// collects the document
+//
+class StreamString
+    : public jag::pdf::StreamOut
+{
+public:
+    std::string const& str() const { return m_str; }
+
+    jag::pdf::Int write(void const* data, jag::pdf::ULong size) {
+        m_str.append(static_cast<char const*>(data), static_cast<size_t>(size));
+        return 0;
+    }
+
+    jag::pdf::Int close() { return 0; }
+
+private:
+    std::string m_str;
+};
+
+
+
 //
 //
 //
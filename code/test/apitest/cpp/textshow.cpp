@@ -7,6 +7,9 @@
 
 // tests text showing methods
 
+#include <string>
+#include <vector>
+
 #include "testcommon.h"
 
 using namespace jag;
@@ -111,11 +114,80 @@ namespace
   }
 
 
+//
+// literal strings, escaped byte by byte
+//
+  std::string literal_string(std::string const& text)
+  {
+      std::string result("(");
+      for(size_t i=0; i<text.size(); ++i)
+      {
+          switch(text[i])
+          {
+          case '\n': result += "\\n"; break;
+          case '\r': result += "\\r"; break;
+          case '\t': result += "\\t"; break;
+          case '\b': result += "\\b"; break;
+          case '\f': result += "\\f"; break;
+          case '(':  result += "\\("; break;
+          case ')':  result += "\\)"; break;
+          case '\\': result += "\\\\"; break;
+          default:   result += text[i];
+          }
+      }
+      return result + ")";
+  }
+
+
+  // Strings are escaped through a 512 byte buffer. Checks runs around the
+  // buffer size and escape sequences split by the buffer edge.
+  void long_strings()
+  {
+      std::vector<std::string> texts;
+      const size_t runs[] = { 511, 512, 513 };
+      for(size_t i=0; i<3; ++i)
+      {
+          std::string run(runs[i], 'a');
+          texts.push_back(run);
+          texts.push_back(run + "(" + run);
+          texts.push_back("(" + run + ")");
+          texts.push_back(std::string(runs[i], ')'));
+      }
+      for(size_t offset=506; offset<516; ++offset)
+      {
+          std::string text(offset, 'b');
+          text += "\\\n";
+          text.append(1024, 'c');
+          text += '\r';
+          texts.push_back(text);
+          texts.push_back(std::string(offset % 8, 'd') + std::string(offset, '('));
+      }
+
+      pdf::Profile cfg = pdf::create_profile();
+      cfg.set("doc.compressed", "0");
+      StreamString stream;
+      pdf::Document doc(pdf::create_stream(&stream, cfg));
+      g_font.set_writer(doc);
+      doc.page_start(200, 100);
+      pdf::Canvas cnv(doc.page().canvas());
+      cnv.text_font(g_font(10));
+      for(size_t i=0; i<texts.size(); ++i)
+          cnv.text(20, 20, texts[i].c_str());
+      doc.page_end();
+      doc.finalize();
+
+      for(size_t i=0; i<texts.size(); ++i)
+          BOOST_TEST(stream.str().find(literal_string(texts[i]) + " Tj") != std::string::npos);
+  }
+
+
 //
 //
 //
   void test_main(int argc, char** argv)
   {
+      long_strings();
+
       register_command_line(argc, argv);
       pdf::Profile cfg = pdf::create_profile();
       cfg.set("doc.compressed", "0");
@@ -0,0 +1,52 @@
+#!/usr/bin/env python
+#
+# Copyright (c) 2005-2009 Jaroslav Gresula
+#
+# Distributed under the MIT license (See accompanying file
+# LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+#
+
+import jagpdf
+import jag.testlib as testlib
+import os
+import sys
+
+def image_path(name):
+    return os.path.expandvars('${JAG_TEST_RESOURCES_DIR}/images/') + name
+
+def create_doc(argv, name, dedup):
+    cfg = testlib.test_config()
+    cfg.set('doc.compressed', '0')
+    cfg.set('doc.dedup_streams', dedup)
+    doc = testlib.create_test_doc(argv, name, cfg)
+    for i in range(3):
+        # the same image and pattern loaded again for each page
+        img = doc.image_load_file(image_path('logo.png'))
+        tile = doc.canvas_create()
+        tile.color_space('f', jagpdf.CS_DEVICE_RGB)
+        tile.color('f', 1.0, 0.0, 0.0)
+        tile.rectangle(0, 0, 5, 5)
+        tile.path_paint('f')
+        pattern = doc.tiling_pattern_load('step=10, 10', tile)
+        doc.page_start(200, 200)
+        canvas = doc.page().canvas()
+        canvas.image(img, 10, 10)
+        canvas.color_space_pattern('f')
+        canvas.pattern('f', pattern)
+        canvas.rectangle(100, 100, 50, 50)
+        canvas.path_paint('f')
+        doc.page_end()
+    doc.finalize()
+    return open(os.path.join((argv or sys.argv)[1], name), 'rb').read()
+
+def test_main(argv=None):
+    dup = create_doc(argv, 'dedupstreams-0.pdf', '0')
+    dedup = create_doc(argv, 'dedupstreams-1.pdf', '1')
+    assert dedup.count('/Subtype/Image') > 0
+    assert dup.count('/Subtype/Image') == 3 * dedup.count('/Subtype/Image')
+    assert dup.count('/PatternType 1') == 3
+    assert dedup.count('/PatternType 1') == 1
+    assert len(dedup) < len(dup)
+
+if __name__ == "__main__":
+    test_main()
@@ -0,0 +1,58 @@
+#!/usr/bin/env python
+#
+# Copyright (c) 2005-2009 Jaroslav Gresula
+#
+# Distributed under the MIT license (See accompanying file
+# LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+#
+
+import jagpdf
+import jag.testlib as testlib
+import os
+import re
+import sys
+
+def image_path(name):
+    return os.path.expandvars('${JAG_TEST_RESOURCES_DIR}/images/') + name
+
+def create_doc(argv, name, dedup, compressed, images):
+    cfg = testlib.test_config()
+    cfg.set('doc.compressed', compressed)
+    cfg.set('doc.dedup_streams', dedup)
+    doc = testlib.create_test_doc(argv, name, cfg)
+    imgs = [doc.image_load_file(image_path(img)) for img in images]
+    doc.page_start(400, 400)
+    for img in imgs:
+        doc.page().canvas().image(img, 10, 10)
+    doc.page_end()
+    doc.finalize()
+    return open(os.path.join((argv or sys.argv)[1], name), 'rb').read()
+
+def check_lengths(data):
+    # each indirect length matches the stream data
+    for m in re.finditer(r'/Length (\d+) 0 R.*?stream\n', data, re.S):
+        obj = re.search(r'\b%s 0 obj\s*(\d+)\s*endobj' % m.group(1), data)
+        length = int(obj.group(1))
+        assert data[m.end() + length:].startswith('\nendstream')
+
+def test_main(argv=None):
+    for compressed in ['0', '1']:
+        # large images are written directly to the file
+        direct = create_doc(argv, 'directstreams-%s.pdf' % compressed,
+                            '0', compressed, ['lena_alpha.png'])
+        assert re.search(r'/Length \d+ 0 R[^>]*/Subtype/Image', direct)
+        check_lengths(direct)
+        # small ones are not worth the indirect length
+        small = create_doc(argv, 'directstreams-small-%s.pdf' % compressed,
+                           '0', compressed, ['logo.png'])
+        assert not re.search(r'/Length \d+ 0 R', small)
+        # a stream with the dictionary of a directly written one is buffered
+        # and found equal to it
+        dedup = create_doc(argv, 'directstreams-dedup-%s.pdf' % compressed,
+                           '1', compressed, ['lena_alpha.png', 'lena_alpha.png'])
+        assert re.search(r'/Length \d+ 0 R[^>]*/Subtype/Image', dedup)
+        check_lengths(dedup)
+        assert dedup.count('/Subtype/Image') == direct.count('/Subtype/Image')
+
+if __name__ == "__main__":
+    test_main()
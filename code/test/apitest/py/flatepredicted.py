@@ -0,0 +1,90 @@
+#!/usr/bin/env python
+#
+# Copyright (c) 2005-2009 Jaroslav Gresula
+#
+# Distributed under the MIT license (See accompanying file
+# LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+#
+
+import jagpdf
+import jag.testlib as testlib
+import os
+import re
+import sys
+import zlib
+
+# PNG images whose IDAT data are copied to the document as they are
+g_images = ['BASN2C08.png', # rgb
+            'BASN2C16.png', # rgb, 16 bits
+            'BASN0G08.png', # gray
+            'BASN0G16.png', # gray, 16 bits
+            'BASN0G04.png', # gray, 4 bits
+            'BASN3P08.png', # palette
+            'BASN3P02.png'] # palette, 2 bits
+
+def image_path(name):
+    return os.path.expandvars('${JAG_TEST_RESOURCES_DIR}/images/png_test_suite/') + name
+
+def create_doc(argv, name, img_name, compressed, image_level=None):
+    cfg = testlib.test_config()
+    cfg.set('doc.compressed', compressed)
+    cfg.set('doc.version', '5')
+    if image_level is not None:
+        cfg.set('compression.image_level', image_level)
+    doc = testlib.create_test_doc(argv, name, cfg)
+    img = doc.image_load_file(image_path(img_name))
+    doc.page_start(400, 400)
+    doc.page().canvas().image(img, 10, 10)
+    doc.page_end()
+    doc.finalize()
+    return open(os.path.join((argv or sys.argv)[1], name), 'rb').read()
+
+def image_stream(data):
+    """returns dictionary and data of the image stream"""
+    m = re.search(r'<</Length (\d+)([^\n]*/Subtype/Image[^\n]*)>>stream\n', data)
+    assert m
+    return m.group(2), data[m.end():m.end() + int(m.group(1))]
+
+def paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    if pb <= pc:
+        return b
+    return c
+
+def unpredict(data, colors, bpc, columns):
+    """reverts PNG predictors of the rows"""
+    bpp = max(1, colors * bpc / 8)
+    rowbytes = (columns * colors * bpc + 7) / 8
+    prev = [0] * rowbytes
+    result = []
+    for start in range(0, len(data), rowbytes + 1):
+        kind = ord(data[start])
+        row = [ord(c) for c in data[start + 1:start + 1 + rowbytes]]
+        for i in range(rowbytes):
+            a = i >= bpp and row[i - bpp] or 0
+            c = i >= bpp and prev[i - bpp] or 0
+            b = prev[i]
+            row[i] = (row[i] + [0, a, b, (a + b) / 2, paeth(a, b, c)][kind]) & 0xff
+        result.extend(row)
+        prev = row
+    return ''.join([chr(c) for c in result])
+
+def test_main(argv=None):
+    for img in g_images:
+        # decoded samples, also with compression level 0 of images
+        decoded = image_stream(create_doc(argv, 'flatepredicted-u-' + img + '.pdf', img, '0'))
+        level0 = image_stream(create_doc(argv, 'flatepredicted-0-' + img + '.pdf', img, '1', '0'))
+        assert decoded == level0
+        # predicted data decompress to the same samples
+        pdict, pdata = image_stream(create_doc(argv, 'flatepredicted-' + img + '.pdf', img, '1'))
+        assert '/Filter/FlateDecode' in pdict
+        m = re.search(r'/Predictor 15/Colors (\d+)/BitsPerComponent (\d+)/Columns (\d+)', pdict)
+        assert m
+        colors, bpc, columns = [int(v) for v in m.groups()]
+        assert unpredict(zlib.decompress(pdata), colors, bpc, columns) == decoded[1]
+
+if __name__ == "__main__":
+    test_main()
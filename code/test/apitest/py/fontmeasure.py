@@ -0,0 +1,55 @@
+#!/usr/bin/env python
+#
+# Copyright (c) 2005-2009 Jaroslav Gresula
+#
+# Distributed under the MIT license (See accompanying file
+# LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+#
+
+import jagpdf
+import jag.testlib as testlib
+import array
+
+def check_font(font, txt):
+    # widths of words
+    ranges, start = [], 0
+    for word in txt.split(' '):
+        ranges += [start, start + len(word)]
+        start += len(word) + 1
+    widths = array.array('d', [0.0] * (len(ranges) / 2))
+    font.advances(txt, ranges, widths)
+    for i in range(0, len(ranges), 2):
+        expected = font.advance(txt[ranges[i]:ranges[i+1]])
+        assert abs(widths[i/2] - expected) < 1e-9
+
+    # positions of characters
+    positions = array.array('d', [0.0] * len(txt))
+    assert len(txt) == font.char_positions(txt, positions)
+    for i in range(len(txt)):
+        assert abs(positions[i] - font.advance(txt[:i+1])) < 1e-9
+    # too short output array
+    assert len(txt) == font.char_positions(txt, array.array('d', [0.0] * 3))
+
+    # invalid ranges
+    testlib.must_throw(font.advances, txt, [0], widths)
+    testlib.must_throw(font.advances, txt, [2, 1], widths)
+    testlib.must_throw(font.advances, txt, [0, len(txt)+1], widths)
+    testlib.must_throw(font.advances, txt, [0, 1, 1, 2], array.array('d', [0.0]))
+
+
+def test_main(argv=None):
+    txt = "AYAYAYA To Wa YAYAYAYAY AVAVAV fi"
+    for kerning in [0, 1]:
+        profile = testlib.test_config()
+        profile.set('text.kerning', str(kerning))
+        doc = testlib.create_test_doc(argv, 'fontmeasure%d.pdf' % kerning, profile)
+        check_font(doc.font_load('standard;name=Helvetica;size=12'), txt)
+        check_font(doc.font_load('standard;enc=iso-8859-2;name=Times-Roman;size=10'), txt)
+        check_font(doc.font_load('standard;enc=utf-8;name=Helvetica;size=12'), txt)
+        check_font(testlib.EasyFontTTF(doc, 'utf-8')(10), txt)
+        doc.page_start(72, 72)
+        doc.page_end()
+        doc.finalize()
+
+if __name__ == "__main__":
+    test_main()
@@ -0,0 +1,49 @@
+#!/usr/bin/env python
+#
+# Copyright (c) 2005-2009 Jaroslav Gresula
+#
+# Distributed under the MIT license (See accompanying file
+# LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+#
+
+import jagpdf
+import jag.testlib as testlib
+import os
+import sys
+
+# images tagged as sRGB and color spaces with the same profile share a single
+# ICCBased object
+
+def res_path(name):
+    return os.path.expandvars('${JAG_TEST_RESOURCES_DIR}/') + name
+
+def create_doc(argv, name, nimages, compressed):
+    cfg = testlib.test_config()
+    cfg.set('doc.compressed', compressed)
+    doc = testlib.create_test_doc(argv, name, cfg)
+    doc.page_start(5.9*72, 3.5*72)
+    canvas = doc.page().canvas()
+    for i in range(nimages):
+        canvas.image(doc.image_load_file(res_path('images/cc3399-srgb.png')), 10 + 20*i, 10)
+        canvas.image(doc.image_load_file(res_path('images/lena_srgb.jpg')), 10 + 20*i, 50)
+    srgb = doc.color_space_load('srgb')
+    profile = res_path('icc/sRGB Color Space Profile.icm')
+    assert srgb == doc.color_space_load('icc; components=3; profile=' + profile)
+    canvas.color_space('f', srgb)
+    canvas.color('f', 0.25, 0.5, 0.75)
+    canvas.rectangle(10, 100, 10, 10)
+    canvas.path_paint('f')
+    doc.page_end()
+    doc.finalize()
+    return open(os.path.join((argv or sys.argv)[1], name), 'rb').read()
+
+def test_main(argv=None):
+    for compressed in ['0', '1']:
+        one = create_doc(argv, 'iccshared-1-%s.pdf' % compressed, 1, compressed)
+        many = create_doc(argv, 'iccshared-5-%s.pdf' % compressed, 5, compressed)
+        assert one.count('/ICCBased') == 1
+        assert many.count('/ICCBased') == 1
+        assert many.count('/Subtype/Image') == 5 * one.count('/Subtype/Image')
+
+if __name__ == "__main__":
+    test_main()
@@ -0,0 +1,41 @@
+#!/usr/bin/env python
+#
+# Copyright (c) 2005-2009 Jaroslav Gresula
+#
+# Distributed under the MIT license (See accompanying file
+# LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+#
+
+import jagpdf
+import jag.testlib as testlib
+import os
+import sys
+
+def create_doc(argv, name, object_streams, version='5'):
+    cfg = testlib.test_config()
+    cfg.set('doc.version', version)
+    cfg.set('doc.object_streams', object_streams)
+    doc = testlib.create_test_doc(argv, name, cfg)
+    for i in range(150):
+        doc.page_start(72, 72)
+        doc.page().canvas().text(10, 30, 'page %d' % i)
+        doc.page().annotation_uri(10, 10, 20, 20, 'http://jagpdf.org')
+        doc.outline().item('page %d' % i)
+        doc.page_end()
+    doc.finalize()
+    return open(os.path.join((argv or sys.argv)[1], name), 'rb').read()
+
+def test_main(argv=None):
+    classic = create_doc(argv, 'objectstreams-0.pdf', '0')
+    assert '/ObjStm' not in classic
+    assert '\nxref\n' in classic
+    compact = create_doc(argv, 'objectstreams-1.pdf', '1')
+    assert '/Type/ObjStm' in compact
+    assert '/Type/XRef' in compact
+    assert '\nxref\n' not in compact
+    assert len(compact) < len(classic)
+    # object streams are available since PDF 1.5
+    testlib.must_throw(create_doc, argv, 'objectstreams-2.pdf', '1', '4')
+
+if __name__ == "__main__":
+    test_main()
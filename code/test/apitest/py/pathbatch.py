@@ -0,0 +1,41 @@
+#!/usr/bin/env python
+#
+# Copyright (c) 2005-2009 Jaroslav Gresula
+#
+# Distributed under the MIT license (See accompanying file
+# LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+#
+
+import jagpdf
+import jag.testlib as testlib
+import array
+
+def test_main(argv=None):
+    doc = testlib.create_test_doc(argv, "pathbatch.pdf")
+    doc.page_start(5.9*72, 3.5*72)
+    canvas = doc.page().canvas()
+    # polyline from a sequence
+    canvas.polyline([36, 36, 72, 108, 108, 36, 144, 108])
+    canvas.path_paint('s')
+    # polygon from a buffer
+    canvas.color('f', 0.8, 0.2, 0.2)
+    canvas.polygon(array.array('d', [180, 36, 252, 36, 216, 108]))
+    canvas.path_paint('fs')
+    # beziers continue the current path
+    canvas.move_to(288, 36)
+    canvas.beziers([288, 108, 360, 108, 360, 36,
+                    360, 0, 396, 0, 396, 36])
+    canvas.path_paint('s')
+    # rectangles
+    canvas.rectangles([36, 144, 36, 36, 90, 144, 36, 36, 144, 144, 36, 36])
+    canvas.path_paint('s')
+    # wrong array lengths
+    testlib.must_throw(canvas.polyline, [])
+    testlib.must_throw(canvas.polygon, [1, 2, 3])
+    testlib.must_throw(canvas.beziers, [1, 2, 3, 4])
+    testlib.must_throw(canvas.rectangles, [1, 2, 3])
+    doc.page_end()
+    doc.finalize()
+
+if __name__ == "__main__":
+    test_main()
@@ -0,0 +1,52 @@
+#!/usr/bin/env python
+#
+# Copyright (c) 2005-2009 Jaroslav Gresula
+#
+# Distributed under the MIT license (See accompanying file
+# LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+#
+
+import jagpdf
+import jag.testlib as testlib
+import os
+import sys
+
+g_images = ['logo.png', 'lena_alpha.png', 'lena.jpg',
+            'png_test_suite/BASN2C16.png', # 16 bits
+            'png_test_suite/BASI6A16.png', # interlaced, alpha
+            'png_test_suite/BASN4A08.png']
+
+def image_path(name):
+    return os.path.expandvars('${JAG_TEST_RESOURCES_DIR}/images/') + name
+
+def create_doc(argv, name, threads, version, compressed, image_level=None):
+    cfg = testlib.test_config()
+    cfg.set('doc.compressed', compressed)
+    if image_level is not None:
+        cfg.set('compression.image_level', image_level)
+    cfg.set('doc.version', version)
+    cfg.set('doc.static_file_id', '1')
+    cfg.set('info.creation_date', '0')
+    cfg.set('images.prepare_threads', threads)
+    doc = testlib.create_test_doc(argv, name, cfg)
+    imgs = [doc.image_load_file(image_path(img)) for img in g_images]
+    doc.page_start(400, 400)
+    for i, img in enumerate(imgs):
+        doc.page().canvas().image(img, 10 + 60 * i, 10)
+    doc.page_end()
+    doc.finalize()
+    return open(os.path.join((argv or sys.argv)[1], name), 'rb').read()
+
+def test_main(argv=None):
+    # the images prepared on worker threads are the same
+    # level 0 of the image class writes the images uncompressed
+    for version in ['4', '5']:
+        for compressed, level in [('0', None), ('1', None), ('1', '0')]:
+            suffix = '%s-%s-%s.pdf' % (version, compressed, level or 'd')
+            serial = create_doc(argv, 'prepareimages-0-' + suffix, '0', version, compressed, level)
+            parallel = create_doc(argv, 'prepareimages-3-' + suffix, '3', version, compressed, level)
+            assert serial == parallel
+    testlib.must_throw(create_doc, argv, 'prepareimages-err.pdf', '-1', '5', '1')
+
+if __name__ == "__main__":
+    test_main()
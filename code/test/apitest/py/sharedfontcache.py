@@ -0,0 +1,51 @@
+#!/usr/bin/env python
+#
+# Copyright (c) 2005-2009 Jaroslav Gresula
+#
+# Distributed under the MIT license (See accompanying file
+# LICENSE.txt or copy at http://jagpdf.org/LICENSE.txt)
+#
+
+import jagpdf
+import jag.testlib as testlib
+import os
+import shutil
+import tempfile
+
+fonts_dir = os.path.expandvars('${JAG_TEST_RESOURCES_DIR}/fonts/')
+
+def create_doc(argv, name, font_file, shared):
+    cfg = testlib.test_config()
+    cfg.set('fonts.shared_cache', shared and '1' or '0')
+    doc = testlib.create_test_doc(argv, name, cfg)
+    doc.page_start(3*72, 72)
+    font = doc.font_load('enc=utf-8;size=12;file=' + font_file)
+    canvas = doc.page().canvas()
+    canvas.text_font(font)
+    canvas.text(10, 30, 'shared typeface cache')
+    result = font.family_name(), font.advance('shared typeface cache')
+    doc.page_end()
+    doc.finalize()
+    return result
+
+def test_main(argv=None):
+    dejavu = fonts_dir + 'DejaVuSans.ttf'
+    # the cache gives the same results as a private typeface
+    expected = create_doc(argv, 'sharedfontcache-0.pdf', dejavu, False)
+    assert expected == create_doc(argv, 'sharedfontcache-1.pdf', dejavu, True)
+    assert expected == create_doc(argv, 'sharedfontcache-2.pdf', dejavu, True)
+    # a modified file is loaded again
+    tmpdir = tempfile.mkdtemp()
+    try:
+        font_file = os.path.join(tmpdir, 'font.ttf')
+        shutil.copy(dejavu, font_file)
+        assert expected == create_doc(argv, 'sharedfontcache-3.pdf', font_file, True)
+        shutil.copy(fonts_dir + 'DejaVuSansMono.ttf', font_file)
+        family, width = create_doc(argv, 'sharedfontcache-4.pdf', font_file, True)
+        assert family == 'DejaVu Sans Mono'
+        assert width != expected[1]
+    finally:
+        shutil.rmtree(tmpdir)
+
+if __name__ == "__main__":
+    test_main()
@@ -360,7 +360,7 @@ def qualified_name( gcc ):
 ###########################################################################
 # metainfo generation - dictionary with the following keys
 # - type     - pygccxml type
-# - category - one of [const_pointer,void,enum,other,interface]
+# - category - one of [const_pointer,pointer,void,enum,other,interface]
 # - base     - base type - for a smartpointer it is its value_type
 #              otherwise has the same value as type keyword
 # - typemap  - number of the following arguments that are bound to this one
@@ -393,9 +393,13 @@ def type_metainfo( type_, opts, doxyindex, result, allow_raw_cls=False ):
             raise RuntimeError( "%s: no references allowed" % type_ )
         # pointers  (string, arrays)
         if dec_traits.is_pointer( type_ ):
-            assert dec_traits.is_const( type_.base )    # pointer must be const
-            result['category'] = 'const_pointer'
-            result['base'] = type_.base.base
+            if dec_traits.is_const( type_.base ):
+                result['category'] = 'const_pointer'
+                result['base'] = type_.base.base
+            else:
+                # output arrays
+                result['category'] = 'pointer'
+                result['base'] = type_.base
         else:
             assert not dec_traits.is_const( type_ )     # other types cannot be const
             if dec_traits.is_void( type_ ):
@@ -483,6 +487,8 @@ def create_args_metainfo( callable_, opts, doxyindex ):
         mi = type_metainfo( arg.type, opts, doxyindex, d, True )
         if mi['category'] == 'const_pointer' and mi['base_name'] not in allowed_pointers:
             raise RuntimeError( "%s: disallowed pointer type: %s" % (m.name, mi['base_name']) )
+        if mi['category'] == 'pointer' and mi['base_name'] not in opts['allowed_out_pointers']:
+            raise RuntimeError( "%s: disallowed output pointer type: %s" % (m.name, mi['base_name']) )
         result.append( mi )
     #find typemaps, adds 'typemap' key to each minfo
     #  number of following arguments forming a typemap (0 if no typemap is detected)
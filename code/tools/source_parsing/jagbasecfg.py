@@ -41,6 +41,8 @@ class TypeMap:
         map_ = """
         #- passthrough
         jag_streamout; StreamOut;  jag_streamout; StreamOut
+        jag_datarelease; DataRelease;  jag_datarelease; DataRelease
+        jag_streamin; StreamIn;  jag_streamin; StreamIn
 
         #- fundamental
         void;          void;     void;        ????
@@ -209,7 +211,7 @@ namespace pdf {
                                  'jag::IImageDef' : 40,
                                  'jag::IDocument' : 1000000 },
                  additional_enums=['::jag::ColorSpaceType'],
-                 passthrough_types=['::jag_streamout_tag'],
+                 passthrough_types=['::jag_streamout_tag', '::jag_datarelease_tag', '::jag_streamin_tag'],
                  ref_counted=['jag::IProfile',
                               'jag::IDocument',
                               'jag::IImageMask'])
@@ -237,17 +239,22 @@ def cfg( testenv=False):
                        ]
     ns = 'jag::'
     remove_from_links = [ns]
-    allowed_pointers=[ ns+p for p in ['Char', 'Double', 'UInt', 'Byte', 'Int', 'Function', 'UInt16'] ] + ['jag_streamout']
+    allowed_pointers=[ ns+p for p in ['Char', 'Double', 'UInt', 'Byte', 'Int', 'Function', 'UInt16'] ] + ['jag_streamout', 'jag_datarelease', 'jag_streamin']
     def get_typemap( p, pname ):
         return ( dict(base_name=p, category='const_pointer', argname=pname ),\
                  dict(base_name='UInt', category='other', argname='length' ) )
     typemaps = [ get_typemap(p,p=='Char' and 'text' or 'array_in') for p in allowed_pointers ]
+    allowed_out_pointers=[ ns+p for p in ['Double'] ]
+    typemaps += [ ( dict(base_name=p, category='pointer', argname='array_out' ),\
+                    dict(base_name='UInt', category='other', argname='out_length' ) )
+                  for p in allowed_out_pointers ]
     smartptr_traits = smartptr.intrusive_ptr_traits
 
     result_d.update(dict( entryp = entry_points,
                           remove_from_links=remove_from_links,
                           doc_cls_name = _doc_cls_name,
                           allowed_pointers = allowed_pointers,
+                          allowed_out_pointers = allowed_out_pointers,
                           typemaps = typemaps,
                           cls_namespace=ns,
                           smartptr_traits=smartptr_traits,
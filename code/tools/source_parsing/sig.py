@@ -59,6 +59,9 @@ class type_visitor:
     def on_const_pointer( self, mi ):
         return self._map_type(mi) + ' const*'
 
+    def on_pointer( self, mi ):
+        return self._map_type(mi) + '*'
+
     def on_default_type( self, mi ):
         return self._map_type(mi)
 
@@ -78,6 +81,9 @@ class java_type_visitor:
         else:
             return self._map_type(mi) + "``\[\]``"
 
+    def on_pointer( self, mi ):
+        return self._map_type(mi) + "``\[\]``"
+
     def on_default_type( self, mi ):
         return self._map_type(mi)
 